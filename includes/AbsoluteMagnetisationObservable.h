@@ -8,17 +8,22 @@
 #ifndef ABSOLUTEMAGNETISATIONOBSERVABLE_H_
 #define ABSOLUTEMAGNETISATIONOBSERVABLE_H_
 
+#include <memory>
+
 #include "typedefs.h"
 #include "Observable.h"
+#include "RunningStatistics.h"
 
 class SpinOrientation;
+class ObservableEngine;
 
 /// Absolute magnetization information: average(|Si|)
 
 class AbsoluteMagnetisationObservable : public Observable
 {
 public:
-	AbsoluteMagnetisationObservable(int numberMeasurements, SpinOrientation* spinOrientation);
+	AbsoluteMagnetisationObservable(int numberMeasurements, SpinOrientation* spinOrientation,
+		std::shared_ptr<ObservableEngine> engine);
 	virtual ~AbsoluteMagnetisationObservable();
 	virtual std::string get_steps_header(void) const;
 	virtual std::string get_mean_header(void) const;
@@ -29,7 +34,8 @@ public:
 
 private:
 	SpinOrientation* _spinOrientation;
-	Threedim* _absoluteMagnetisation;
+	std::shared_ptr<ObservableEngine> _engine; ///< evaluates the sums of |Si|
+	RunningStatistics _statistics[3]; ///< statistics of sum of |Si| for components x, y, z
 	int _numberAtoms;
 };
 
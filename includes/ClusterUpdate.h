@@ -0,0 +1,85 @@
+/*
+* ClusterUpdate.h
+*
+*
+*
+*      Wolff cluster algorithm for the exchange interaction of Ising and Heisenberg spins. Heisenberg spins are
+*      embedded as Ising variables along a random direction (reflection about the plane perpendicular to it).
+*      Clusters grow over the bonds of all ExchangeInteraction energies. All other energies and the bonds to
+*      inactive sites are taken into account by a Metropolis acceptance of the cluster flip. Each simulation
+*      step consists of Metropolis sweeps and as many cluster updates as needed on average to cover all active
+*      sites.
+*/
+
+#ifndef CLUSTERUPDATE_H_
+#define CLUSTERUPDATE_H_
+
+#include "SimulationMethod.h"
+
+// standard includes
+#include <memory>
+#include <vector>
+
+// Qt includes
+#include <QSharedPointer>
+
+// own
+#include "typedefs.h"
+class SpinOrientation;
+class Hamiltonian;
+class RanGen;
+class Energy;
+class ExchangeInteraction;
+class Metropolis;
+
+/// Wolff cluster updates mixed with Metropolis sweeps
+
+class ClusterUpdate : public SimulationMethod
+{
+public:
+	ClusterUpdate(SpinOrientation* spinOrientation, int simulationSteps, double temperature,
+		QSharedPointer<Hamiltonian> hamilton, std::shared_ptr<RanGen> ranGen, int metropolisSweeps,
+		SimulationProgram* simulationProgram);
+	virtual ~ClusterUpdate();
+	/// Metropolis sweeps and one sweep of cluster updates; returns fraction of active spins flipped in clusters
+	virtual double simulation_step(void);
+
+	virtual void set_temperature(double temperature);
+	/// bond probabilities and cluster acceptance assume a uniform temperature; not used by spin_seebeck
+	virtual void set_temperature_gradient(double temperatureMin, double temperatureMax, Threedim direction,
+		Lattice* lattice);
+
+	double get_mean_cluster_size(void) const; ///< mean number of spins per cluster since last temperature change
+	double get_cluster_acceptance(void) const; ///< fraction of accepted cluster flips
+	int get_number_clusters(void) const; ///< number of clusters since last temperature change
+
+protected:
+	/// build cluster from seed site and flip it; returns number of spins in cluster
+	int cluster_update(int seed);
+	/// reset cluster statistics
+	void reset_statistics(void);
+
+	/// bonds of one ExchangeInteraction energy
+	struct ExchangeBonds
+	{
+		int* neighborArray; ///< _nbors neighbors per lattice site; -1 for empty entry
+		int nbors;
+		std::shared_ptr<ExchangeInteraction> exchange; ///< energy parameter positive for ferromagnetic coupling
+	};
+	std::vector<ExchangeBonds> _exchangeBonds;
+	std::vector<std::shared_ptr<Energy>> _otherEnergies; ///< energies included by Metropolis acceptance
+
+	std::shared_ptr<Metropolis> _metropolis; ///< single spin updates
+	int _metropolisSweeps; ///< Metropolis sweeps per simulation step
+	int _boolIsing; ///< TRUE for Ising spins along x; reflection axis is fixed
+
+	std::vector<char> _activityList; ///< 1 for active sites
+	std::vector<char> _inCluster; ///< 1 for sites of current cluster
+	std::vector<int> _cluster; ///< sites of current cluster in order of addition
+
+	double _clusterSizeSum; ///< sum of cluster sizes
+	int _numberClusters; ///< number of clusters
+	int _numberAcceptedClusters; ///< number of accepted cluster flips
+};
+
+#endif /* CLUSTERUPDATE_H_ */
@@ -26,8 +26,11 @@ public:
 	std::string all_parameters(void) const; ///< make a single string from all parameter values
 	void show_parameters(void); ///< show parameters on console
 	void determine_outputfolder_needed(void); ///< determine whether output folder is needed
+	int read_configuration_file(std::string fname); ///< read parameters from text configuration file
 	void copy_configuration_file(std::string fname); ///< copy configuration file
 
+	std::string _configurationFname; ///< configuration file parameters were read from; empty if set up by GUI
+
 	// Simulation parameters
 	SimulationType _simulationType; ///< e.g. Metropolis, Landau-Lifshtiz-Gilbert (LLG) ...
 	ProgramType _programType; ///< purpose of simulation program e.g. temperature and magnetic field loop
@@ -49,6 +52,9 @@ public:
 	Threedim _initialSpiralek;
 	double _initialSpiralLambda;
 	double _gaussianSpinSamplingSigma; ///< sigma for random spin change restricted to cone
+	double _adaptiveConeAcceptance; ///< target acceptance for adaptation of sigma; 0 for fixed sigma
+	int _adaptiveConeSteps; ///< equilibration steps with adaptation of sigma after each temperature change
+	int _adaptiveConePerClass; ///< TRUE: sigma adapted separately for classes of non-interacting sites
 
 	// energy parameters
 	std::vector<ExchangeEnergyStruct> _exchangeEnergies; 
@@ -61,6 +67,8 @@ public:
 	std::vector<UniaxialAnisotropyStruct> _uniaxialAnisotropyEnergies;
 	std::vector<double> _hexagonalAnisotropyEnergies;
 	int _dipolEnergy; ///< 0 for no dipol-dipol energy; 1 for dipol-dipol energy
+	DipolarMethod _dipolarMethod; ///< evaluation method of dipol-dipol energy
+	double _dipolarOpeningAngle; ///< accuracy of dipolarTree method; 0 exact, default 0.3
 	std::vector<ModulatedExchangeEnergyStruct> _modulatedExchangeEnergies;
 	std::vector<ModulatedAnisotropyEnergyStruct> _modulatedAnisotropyEnergies;
 	MagneticFieldStruct _magneticField;
@@ -72,15 +80,37 @@ public:
 	// parameters for Landau-Lifshitz-Gilbert simulation
 	double _LLG_dampingParameter; ///< Gilbert damping parameter. 1 for fastest relaxation. common value 0.1
 	double _LLG_timeWidth; ///< time width for one solving step of LLG differential equation [ps]
+	int _fusedPairField; ///< TRUE: effective field of pair interactions with fused kernel (see PairInteractionField)
+
+	// parameters for energy minimization
+	int _minimizerMemory; ///< number of previous steps used by L-BFGS (see EnergyMinimizer)
+
+	// parameters for cluster updates
+	int _clusterMetropolisSweeps; ///< Metropolis sweeps per simulation step (see ClusterUpdate)
 
 	// LLG, Monte Carlo mutual parameters 
 	int _seed; ///< seed to initialize pseudo random number generator
+	RandomGeneratorType _randomGenerator; ///< kind of pseudo random number generator
 	double _temperatureStart; ///< start temperature for temperature loop
 	double _temperatureEnd; ///< end temperature for temperature loop
 	int _temperatureSteps; ///< steps for temperature loop
 	Threedim _temperatureGradientDirection; ///< direction of temperature gradient
 	int _outputWidth; ///< every _outputWidth simulation steps energy or magnetization etc. values are taken
 	int _simulationSteps; ///< number of simulation steps for each set of temperature and magnetic field
+	int _parallelSweepThreads; ///< threads for parallel Metropolis sweep; 0 for serial sweep
+	double _heatBathFraction; ///< Metropolis: fraction of heat-bath instead of Metropolis trial steps
+	int _overRelaxationSweeps; ///< Metropolis: over-relaxation sweeps per simulation step
+	int _sweepThreads; ///< threads for independent points of temperature and magnetic field loop; 0 for loop
+	int _replicaExchangeWidth; ///< parallel tempering: simulation steps between replica exchanges
+
+	// parameters for geodesic nudged elastic band (GNEB)
+	std::string _gnebInitialFname; ///< spin configuration at beginning of path
+	std::string _gnebFinalFname; ///< spin configuration at end of path
+	int _gnebImages; ///< number of images including initial and final configuration
+	int _gnebThreads; ///< threads evaluating images in parallel
+	double _gnebSpringConstant; ///< spring constant between neighboring images [meV]
+	double _gnebTimeStep; ///< time step of velocity projection optimization
+	int _gnebClimbingImage; ///< TRUE: refine image of highest energy to saddle point
 
 	// Excitation Solver parameters
 	int _numEigenStates;
@@ -88,6 +118,8 @@ public:
 	// parameters for output configuration
 	bool _doOutput = false; ///< 1 if output into folder wanted, 0 if not output into folder wanted
 	bool _doSpinConfigOutput = false; ///< spin configuration output at end of each temperature and magnetic field step
+	SpinFileFormat _spinFileFormat; ///< file format of spin configuration output
+	int _outputBuffers; ///< pending output files written by writer thread; 0 for output in simulation thread
 	int _movieStart; ///< simulation step to begin spin configuration output
 	int _movieEnd; ///< simulation step to stop spin configuration output
 	int _movieWidth;///< every _movieWidth steps between (_movieStart, _movieEnd) output of spin configuration 
@@ -98,6 +130,13 @@ public:
 	bool _doNCMROutput = false;
 	bool _doSpinResolvedOutput = false; ///< save information for each spin
 	bool _doWindingNumberOutput = false; ///< save skyrmion number
+	int _accumulateObservables; ///< observables accumulate mean values instead of storing all measurements
+	int _errorAnalysis; ///< output of errors and autocorrelation times along with mean values
+	double _targetRelativeError; ///< end run when relative error of mean values is reached; 0 for fixed length
+	double _convergenceTorque; ///< end run when convergence criterion is below this tolerance; 0 to disable
+	double _convergenceEnergy; ///< end run when energy change per site is below this tolerance [meV]; 0 to disable
+	int _convergenceChecks; ///< number of consecutive checks below tolerance to end run
+	int _convergenceWidth; ///< simulation steps between convergence checks
 	std::string _storageFname; ///< a file name that can be used for data output
 
 	// parameters UI output
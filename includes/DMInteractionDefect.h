@@ -24,6 +24,10 @@ public:
 
 	virtual double single_energy(const int &position) const;
 	virtual Threedim effective_field(const int &position) const;
+	virtual double delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const;
+	virtual int linear_in_spin(void) const;
+	virtual int pair_couplings(const int &position, std::vector<int> &partners, 
+		std::vector<ThreedimMatrix> &couplings) const;
 
 protected:
 	void set_DM_vectors(const std::unordered_map<int, double> &defects, Lattice* lattice); ///< setup DM vectors
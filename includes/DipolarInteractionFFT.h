@@ -0,0 +1,66 @@
+/*
+* DipolarInteractionFFT.h
+*
+*
+*
+*      Dipolar interaction for lattices whose sites lie on a regular grid (Bravais lattice, possibly with
+*      holes). The interaction tensor is stored once per grid displacement and the fields of all sites are
+*      evaluated as a convolution with fast Fourier transforms.
+*/
+
+#ifndef DIPOLARINTERACTIONFFT_H_
+#define DIPOLARINTERACTIONFFT_H_
+
+// standard includes
+#include <complex>
+#include <vector>
+
+// own
+#include "Energy.h"
+#include "typedefs.h"
+class Lattice;
+
+/// Dipolar interaction between spins evaluated by fast Fourier transform
+
+class DipolarInteractionFFT : public Energy
+{
+public:
+	DipolarInteractionFFT(Threedim* spinArray, double magneticMoment, double latticeConstant, Lattice* lattice);
+	virtual ~DipolarInteractionFFT();
+
+	virtual double single_energy(const int &position) const;
+	virtual Threedim effective_field(const int &position) const;
+	virtual double delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const;
+	virtual int linear_in_spin(void) const;
+	virtual void add_effective_fields(const int* sites, const int &numberSites, Threedim* fields) const;
+	virtual double total_energy(const int &numberAtoms) const;
+	virtual int site_additive(void) const;
+
+	/// TRUE if all lattice sites are integer combinations of three grid vectors
+	static int lattice_on_grid(Lattice* lattice);
+
+protected:
+	static int find_grid(Lattice* lattice, int* gridCoordinates, Threedim* gridVectors);
+	void setup_grid(Lattice* lattice); ///< grid coordinates of lattice sites and grid size
+	void setup_tensor(void); ///< interaction tensor for all grid displacements and its Fourier transform
+	void fft_3d(std::complex<double>* grid, const int &direction) const;
+	void convolution(void) const; ///< fields at all grid points from current spin configuration
+
+	int _numberAtoms; ///< number lattice sites
+	double _prefactor; ///< interaction prefactor
+	Threedim _gridVectors[3]; ///< grid vectors in units of lattice constant
+	int* _gridCoordinates; ///< integer grid coordinates of lattice sites; size 3*_numberAtoms
+	int* _gridIndex; ///< index of lattice sites on padded grid
+	int _extent[3]; ///< number of grid points occupied by lattice in each direction
+	int _paddedSize[3]; ///< padded grid size in each direction (power of two, >= 2*extent-1)
+	int _gridSize; ///< total number of grid points of padded grid
+
+	/// interaction tensor for each grid displacement; components xx, xy, xz, yy, yz, zz
+	std::vector<double> _tensor[6];
+	/// Fourier transform of _tensor
+	std::vector<std::complex<double>> _tensorFFT[6];
+	/// work space for spin components/fields on padded grid
+	mutable std::vector<std::complex<double>> _grid[3];
+};
+
+#endif /* DIPOLARINTERACTIONFFT_H_ */
@@ -0,0 +1,69 @@
+/*
+* DipolarInteractionTree.h
+*
+*
+*
+*      Dipolar interaction for arbitrary lattice site positions. Far away groups of spins are combined to
+*      a single dipole at their center within an octree (Barnes-Hut), including the first order correction
+*      due to the spatial distribution of the spins.
+*/
+
+#ifndef DIPOLARINTERACTIONTREE_H_
+#define DIPOLARINTERACTIONTREE_H_
+
+// standard includes
+#include <vector>
+
+// own
+#include "Energy.h"
+#include "typedefs.h"
+class Lattice;
+
+/// Node of octree used by DipolarInteractionTree
+struct DipolarTreeNode
+{
+	Threedim center; ///< mean position of lattice sites within node
+	double radius = 0; ///< largest distance of a lattice site within node to center
+	int begin = 0; ///< lattice sites within node are _sites[begin] ... _sites[end-1]
+	int end = 0;
+	int parent = -1; ///< -1 for root node
+	std::vector<int> children; ///< empty for leaf nodes
+	Threedim moment; ///< sum of spins within node
+	ThreedimMatrix moment2; ///< sum of spin * (position - center)^T within node
+};
+
+/// Dipolar interaction between spins evaluated with Barnes-Hut octree
+
+class DipolarInteractionTree : public Energy
+{
+public:
+	DipolarInteractionTree(Threedim* spinArray, double magneticMoment, double latticeConstant, Lattice* lattice,
+		double openingAngle, int leafSize = 8);
+	virtual ~DipolarInteractionTree();
+
+	virtual double single_energy(const int &position) const;
+	virtual Threedim effective_field(const int &position) const;
+	virtual double delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const;
+	virtual int linear_in_spin(void) const;
+	virtual double total_energy(const int &numberAtoms) const;
+	virtual int site_additive(void) const;
+
+	virtual void update_spin(const int &position, const Threedim &oldSpin, const Threedim &newSpin);
+	virtual void update_spin_configuration(void);
+
+protected:
+	void build_tree(int node, int depth); ///< recursive subdivision of node
+	Threedim dipolar_field(const Threedim &distanceVector, const Threedim &moment) const;
+	Threedim node_field(const Threedim &distanceVector, const DipolarTreeNode &node) const;
+
+	int _numberAtoms; ///< number lattice sites
+	double _prefactor; ///< interaction prefactor
+	double _openingAngle; ///< node is not opened if radius < openingAngle * distance; 0 for direct summation
+	int _leafSize; ///< maximum number of lattice sites within leaf node
+	Threedim* _latticeCoordArray; ///< lattice coordinates
+	std::vector<int> _sites; ///< lattice site indexes ordered such that every node holds a contiguous range
+	std::vector<int> _leafOfSite; ///< leaf node of each lattice site
+	std::vector<DipolarTreeNode> _nodes; ///< octree; parents are stored before children
+};
+
+#endif /* DIPOLARINTERACTIONTREE_H_ */
@@ -12,6 +12,7 @@
 
 // standard includes
 #include <string>
+#include <vector>
 
 // own
 #include "typedefs.h"
@@ -29,6 +30,48 @@ public:
 
 	/// effective field acting on a spin
 	virtual Threedim effective_field(const int &position) const = 0;
+
+	/// energy change for a reorientation of a single spin from oldSpin to newSpin
+	/** Default implementation evaluates single_energy twice. Energies linear in the spin at position use 
+	the effective field instead. */
+	virtual double delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const;
+
+	/// TRUE if the energy is linear in the spin at each single lattice site
+	/** Then delta_energy = -(newSpin - oldSpin) * effective_field(position) which allows heat-bath and 
+	over-relaxation updates. Default implementation returns FALSE. */
+	virtual int linear_in_spin(void) const;
+
+	/// add effective fields of a list of lattice sites to fields
+	/** Default implementation calls effective_field for each site. */
+	virtual void add_effective_fields(const int* sites, const int &numberSites, Threedim* fields) const;
+
+	/// total energy of the system for this energy term
+	/** Default implementation sums single_energy over all sites and multiplies by _factor. */
+	virtual double total_energy(const int &numberAtoms) const;
+	/// TRUE if total_energy is the sum of single_energy over all sites times _factor
+	/** single_energy must be cheap and may be called for different sites in parallel. Then the energy is 
+	evaluated in the same pass over the lattice as the other observables (see ObservableEngine). Default 
+	implementation returns TRUE. */
+	virtual int site_additive(void) const;
+
+	/// notification that the spin at position was changed from oldSpin to newSpin
+	/** Energies with cached information about the spin configuration update it here. Default: nothing. */
+	virtual void update_spin(const int &position, const Threedim &oldSpin, const Threedim &newSpin);
+	/// notification that the spin configuration was changed arbitrarily or replaced
+	virtual void update_spin_configuration(void);
+
+	/// coupling tensors of a pair interaction bilinear in the spins
+	/** effective_field(position) = sum_k couplings[k] * S(partners[k]). Default implementation returns FALSE,
+	i.e. the energy is not a bilinear pair interaction. */
+	virtual int pair_couplings(const int &position, std::vector<int> &partners, 
+		std::vector<ThreedimMatrix> &couplings) const;
+
+	/// second derivatives of the total energy with respect to the spin at position (spin wave expansion)
+	/** Adds d2E/dS_i dS_i to onSite and appends d2E/dS_i dS_k for the interaction partners k. Together with 
+	effective_field() these determine the spin wave matrix (see ExcitationModeSolver). Default implementation 
+	uses pair_couplings() and returns FALSE for all other energies, i.e. no second derivatives available. */
+	virtual int hessian_blocks(const int &position, ThreedimMatrix &onSite, std::vector<int> &partners,
+		std::vector<ThreedimMatrix> &blocks) const;
 	
 	/// return member _factor
 	double get_factor(void) const;
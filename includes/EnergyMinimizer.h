@@ -0,0 +1,66 @@
+/*
+* EnergyMinimizer.h
+*
+*
+*
+*      Minimization of the total energy on the product of unit spheres of all active spins. The gradient is the
+*      effective field projected onto the tangent planes of the spins. A step rotates each spin along the great
+*      circle given by its component of the search direction. The search direction is determined by the
+*      limited memory BFGS method (L-BFGS) from the last memorySize steps. Vectors of previous steps are
+*      transported to the current tangent planes by projection. The step length is found by backtracking on
+*      the total energy (Armijo condition).
+*/
+
+#ifndef ENERGYMINIMIZER_H_
+#define ENERGYMINIMIZER_H_
+
+#include "SimulationMethod.h"
+
+#include <QSharedPointer>
+
+#include "typedefs.h"
+
+class SpinOrientation;
+class Hamiltonian;
+class RanGen;
+
+/// Zero temperature energy minimization by L-BFGS on the unit spheres
+
+class EnergyMinimizer : public SimulationMethod
+{
+public:
+	EnergyMinimizer(SpinOrientation* spinOrientation, int simulationSteps, double temperature,
+		QSharedPointer<Hamiltonian> hamilton, std::shared_ptr<RanGen> ranGen, int memorySize,
+		SimulationProgram* simulationProgram);
+	virtual ~EnergyMinimizer();
+	/// one iteration: gradient, search direction and line search
+	virtual double simulation_step(void);
+
+protected:
+	void reset_memory(void); ///< discard previous steps; next direction is steepest descent
+	void update_memory(void); ///< store last step and gradient change transported to current tangent planes
+	void lbfgs_direction(void); ///< _direction from two-loop recursion; steepest descent without stored steps
+	void rotate_spins(double stepLength); ///< spins rotated from _initialSpins by stepLength * _direction
+	double dot(const Threedim* a, const Threedim* b) const; ///< sum of dot products over active sites
+	void project(Threedim* a) const; ///< projection onto tangent planes of current spins
+
+	int _memorySize; ///< maximum number of stored steps
+	int _numberPairs; ///< number of stored steps
+	int _newestPair; ///< index of last stored step in ring buffer
+
+	Threedim* _gradient; ///< gradient of energy at active sites (negative projected effective field)
+	Threedim* _previousGradient; ///< gradient at beginning of last step
+	Threedim* _direction; ///< search direction (rotation vector of each spin per unit step length)
+	Threedim* _initialSpins; ///< spins at active sites at beginning of step
+	Threedim* _s; ///< _memorySize steps (_numberActiveSites each)
+	Threedim* _y; ///< _memorySize gradient changes (_numberActiveSites each)
+	double* _rho; ///< 1 / (s.y) of stored pairs
+	double* _alpha; ///< work space of two-loop recursion
+
+	double _energy; ///< total energy at end of last step
+	double _stepLength; ///< accepted step length of last step
+	int _boolPrevious; ///< TRUE if last step was successful and memory can be updated
+	double _maxField; ///< maximum effective field at active sites in current step
+};
+
+#endif /* ENERGYMINIMIZER_H_ */
@@ -8,11 +8,16 @@
 #ifndef ENERGYOBSERVABLE_H_
 #define ENERGYOBSERVABLE_H_
 
+#include <memory>
+#include <vector>
+
 #include <QSharedPointer>
 
 #include "Observable.h"
+#include "RunningStatistics.h"
 
 class Hamiltonian;
+class ObservableEngine;
 
 /// Energy & heat capacity
 
@@ -20,7 +25,7 @@ class EnergyObservable : public Observable
 {
 public:
 	EnergyObservable(int numberMeasurements, QSharedPointer<Hamiltonian> hamilton,	int numberAtoms,
-		             bool eachSpin);
+		             bool eachSpin, std::shared_ptr<ObservableEngine> engine);
 	virtual ~EnergyObservable();
 	virtual std::string get_steps_header(void) const;
 	virtual std::string get_mean_header(void) const;
@@ -28,15 +33,27 @@ public:
 	virtual std::string get_step_value(const int &index) const;
 	virtual std::string get_mean_value(const double &temperature) const;
 	virtual void clear_storage();
+	virtual double get_relative_error(void) const;
 
 protected:
+	void allocate_storage(void);
+	void free_storage(void);
+
 	QSharedPointer<Hamiltonian> _hamilton; ///< Hamiltonian for energy calculation
+	std::shared_ptr<ObservableEngine> _engine; ///< evaluates the energies of the Hamiltonian
 	int _numberEnergies; ///< number of energy objects in Hamiltonian
 	int _numberAtoms; ///< number of lattice sites
 	bool _eachSpin;
 
 	double** _singleEnergies; ///< storage room for measurement values resolved to energy objects
-	double*** _singleEnergiesperspin; ///< storage room for measurement values resolved to energy objects and spins
+	/// storage room for measurement values resolved to energy objects and spins (only if _eachSpin)
+	/** value of energy i (i = _numberEnergies: total) at spin j is at [(index * (_numberEnergies + 1) + i) 
+	* * _numberAtoms + j] */
+	double* _singleEnergiesperspin;
+
+	std::vector<RunningStatistics> _energyStatistics; ///< statistics of each energy object
+	RunningStatistics _totalEnergyStatistics; ///< statistics of total energy
+	std::vector<double> _spinEnergySums; ///< sum of energies resolved to spins over all measurements
 };
 
 #endif /* ENERGYOBSERVABLE_H_ */
@@ -19,29 +19,40 @@ public:
 	ExcitationModeSolver(SpinOrientation* spinOrientation, QSharedPointer<Hamiltonian> hamilton);
 	virtual ~ExcitationModeSolver(void);
 	void setup_matrix(void);
+	/// benchmark and comparison of setup_matrix with the reference implementation setup_matrix_direct
+	int compare_matrix_assembly(void);
+	/// eigenmodes closest to zero; factorization and eigenvectors are reused by the next call
 	void diagonalize(int numberEigenstates);
 
 	void save_sparse_matrix(std::string fname);
 	void save_eigenmodes(std::string fname);
 
 private:
-	void find_energy_indexes(void);
-
-	void add_sparse_matrix_element(int i, int j, double value);
+	/// energies of the Hamiltonian that provide second derivatives
+	std::vector<std::shared_ptr<Energy>> find_energies(void) const;
+	/// append elements of 2x2 block of lattice sites i and k
+	void add_block(std::vector<Eigen::Triplet<double>> &triplets, int i, int k, const Eigen::Matrix2d &block) const;
+	static Eigen::Matrix3d to_matrix(const ThreedimMatrix &matrix);
+	/// reference implementation of setup_matrix with gsl matrices (nearest neighbor energies only)
+	void setup_matrix_direct(void);
+	/// sparse matrix from _tripletList and its LU factorization; returns TRUE on success
+	int factorize(void);
 
 	std::vector<Eigen::Triplet<double>> _tripletList; ///< elements of sparse matrix
+	std::vector<Eigen::Matrix3d> _rotationMatrices; ///< rotation into frame of spin for each lattice site
+
+	Eigen::SparseMatrix<double> _matrix; ///< sparse matrix of last factorization
+	/// LU factorization of _matrix; the symbolic analysis (column ordering) is kept as long as the pattern is
+	Eigen::SparseLU<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>> _solver;
+	int _boolPatternAnalyzed; ///< TRUE if _solver holds the symbolic analysis of the pattern of _matrix
 
-	Eigen::MatrixXcd _evectors;
+	Eigen::MatrixXcd _evectors; ///< eigenvectors of last diagonalization; start of the next one
 	Eigen::VectorXcd _evalues;
 
 	Threedim* _spinArray;
 	int _numberAtoms;
 	QSharedPointer<Hamiltonian> _hamilton;
 	std::vector<std::shared_ptr<Energy>> _energies; ///< energy objects	
-	int _fnExEnergyIndex; ///< index identifying first neighbor exchange energy object in _energies
-	int _fnDMEnergyIndex; ///< index identifying first neighbor DM energy object in _energies
-	int _AnisotropyIndex; ///< index identifying anisotropy energy object in _energies
-	int _ZeemanEnergyIndex; ///< index identifying Zeeman energy object in _energies
 };
 
 #endif // EXCITATIONMODESOLVER
@@ -0,0 +1,72 @@
+/*
+* GeodesicNudgedElasticBand.h
+*
+*
+*
+*      Minimum energy path between two spin configurations by the geodesic nudged elastic band method
+*      (GNEB). A chain of images (spin configurations) connects the fixed initial and final configuration.
+*      Each image is moved by the component of the effective field perpendicular to the path and by spring
+*      forces along the path that keep the geodesic distances between neighboring images equal. With the
+*      climbing image the image of highest energy moves uphill along the path without spring forces and
+*      converges to the saddle point. The chain is relaxed by velocity projection optimization. The energies
+*      and effective fields of the images are evaluated in parallel threads with one Hamiltonian per thread.
+*/
+
+#ifndef GEODESICNUDGEDELASTICBAND_H_
+#define GEODESICNUDGEDELASTICBAND_H_
+
+// standard includes
+#include <vector>
+
+// Qt includes
+#include <QSharedPointer>
+
+// own
+#include "typedefs.h"
+class Hamiltonian;
+
+/// Chain of spin configurations relaxed to the minimum energy path (GNEB)
+
+class GeodesicNudgedElasticBand
+{
+public:
+	GeodesicNudgedElasticBand(std::vector<QSharedPointer<Hamiltonian>> hamiltonians, int numberAtoms,
+		const int* activeSites, int numberActiveSites, const Threedim* initialSpins, const Threedim* finalSpins,
+		int numberImages, double springConstant, double timeStep);
+	virtual ~GeodesicNudgedElasticBand();
+
+	/// one step of velocity projection optimization; returns maximum force on a spin
+	double iterate(int boolClimbingImage);
+
+	int get_number_images(void) const;
+	const Threedim* get_image(int image) const; ///< spin configuration of image (all lattice sites)
+	double get_energy(int image) const; ///< total energy of image [meV]
+	double get_reaction_coordinate(int image) const; ///< geodesic path length from initial configuration
+	int get_saddle_image(void) const; ///< interior image of highest energy
+	double get_barrier(void) const; ///< energy of saddle image relative to initial configuration [meV]
+
+	/// geodesic distance between two spin configurations at the active sites
+	double geodesic_distance(const Threedim* spins1, const Threedim* spins2) const;
+
+protected:
+	void evaluate_images(void); ///< energies and effective fields of interior images in parallel
+	void forces(int boolClimbingImage); ///< GNEB forces from effective fields, tangents and springs
+	void update_distances(void); ///< geodesic distances between neighboring images
+
+	std::vector<QSharedPointer<Hamiltonian>> _hamiltonians; ///< one Hamiltonian per thread
+	int _numberAtoms; ///< number of lattice sites
+	std::vector<int> _activeSites; ///< sites that are moved
+	int _numberActiveSites;
+	int _numberImages; ///< including initial and final configuration
+	double _springConstant; ///< spring constant [meV]
+	double _timeStep; ///< time step of velocity projection optimization
+
+	std::vector<Threedim> _images; ///< _numberAtoms spins per image
+	std::vector<Threedim> _fields; ///< effective fields at active sites of each image
+	std::vector<Threedim> _forces; ///< GNEB forces at active sites of each image
+	std::vector<Threedim> _velocities; ///< velocities at active sites of each image
+	std::vector<double> _energies; ///< total energy of each image
+	std::vector<double> _distances; ///< geodesic distance between image k and k+1
+};
+
+#endif /* GEODESICNUDGEDELASTICBAND_H_ */
@@ -14,6 +14,7 @@
 #include "typedefs.h"
 
 #include "Energy.h"
+class PairInteractionField;
 
 /// Hamiltonian for energy calculations
 
@@ -23,6 +24,7 @@ public:
 	virtual ~Hamiltonian();
 
 	double single_energy(const int &position) const;
+	double delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const;
 	double total_energy() const;
 	double total_energy(const int &position) const;
 	double part_energy(std::shared_ptr<Energy> &energy)  const;
@@ -30,15 +32,33 @@ public:
 	double single_part_energy(const int &index,const int &position) const;
 
 	Threedim effectiveField(const int &position) const;
+	void effective_fields(const int* sites, const int &numberSites, Threedim* fields) const;
+	/// effective field of the energies linear in the spin at position
+	Threedim linear_effective_field(const int &position) const;
+	/// energy change of the energies not linear in the spin at position
+	double nonlinear_delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const;
 
 	void set_spin_array(Threedim* spinArray);
+	void update_spin(const int &position, const Threedim &oldSpin, const Threedim &newSpin);
+	void update_spin_configuration(void);
+	void setup_pair_interaction_field(Threedim* spinArray);
 	
 	std::vector<std::shared_ptr<Energy>> get_energies(void) const;
 	int get_number_energies(void) const;
+	int get_number_nonlinear_energies(void) const;
 
 protected:
 	std::vector<std::shared_ptr<Energy>> _energies; ///< energy objects
 	int _numberAtoms; ///< equal to number of lattice sites
+
+	/// fused field kernel of bilinear pair interactions; NULL if not set up
+	std::shared_ptr<PairInteractionField> _pairInteractionField;
+	/// energies not covered by _pairInteractionField
+	std::vector<std::shared_ptr<Energy>> _fieldEnergies;
+	/// energies of _fieldEnergies linear in the spin at each site
+	std::vector<std::shared_ptr<Energy>> _linearFieldEnergies;
+	/// energies not linear in the spin at each site
+	std::vector<std::shared_ptr<Energy>> _nonlinearEnergies;
 };
 
 #endif /* HAMILTONIAN_H_ */
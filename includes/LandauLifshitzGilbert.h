@@ -13,6 +13,7 @@
 #include <QSharedPointer>
 
 #include "typedefs.h"
+#include "Philox.h"
 
 class SpinOrientation;
 class Hamiltonian;
@@ -42,9 +43,16 @@ protected:
 
 	double _reducedGyromagneticRatio;
 	double* _thermalFieldVariance; ///< Factor for thermal field; individual for each spin due to temperature
+	int _boolThermalField; ///< FALSE if thermal field vanishes at all sites (zero temperature)
+	Threedim* _effectiveFields; ///< effective fields at active sites; _effectiveFields[i] for _activeSites[i]
+	Threedim* _randomFields; ///< thermal fields at active sites during current step
+	Threedim* _initialSpins; ///< spins at active sites at beginning of current step
+
+	Philox _philox; ///< counter-based generator for thermal fields; key drawn from _ranGen
+	uint64_t _stepCounter; ///< number of performed steps; counter of _philox together with lattice site
 
 private:
-	void standard_normal_variables(Threedim &vec1, Threedim &vec2);
+	void thermal_fields(void);
 	void set_thermal_field_variance(void);
 	void set_reduced_gyromagnetic_ratio(void);
 };
@@ -35,8 +35,13 @@ public:
 
 	void find_center_site(void);
 	void neighbor_distances(void);
-	void assign_neighbors(void);
+	void assign_neighbors(void); ///< cell list search in O(N)
+	void neighbor_distances_direct(void);
+	void assign_neighbors_direct(void); ///< reference search in O(N**2)
+	int compare_neighbor_search(void); ///< benchmark and bitwise comparison of both searches
 	int is_neighbor(const int &pos1, const int &pos2) const;
+	std::vector<std::vector<int>> create_color_classes(const std::vector<int> &orders, int boolFourSpin,
+		int boolThreeSite) const;
 
 	void show_lattice_coordinates(void) const;
 	void show_neighbor_distances(void) const;
@@ -10,19 +10,23 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <sstream> 
 
 #include "typedefs.h"
 #include "Observable.h"
+#include "RunningStatistics.h"
 
 class SpinOrientation;
+class ObservableEngine;
 
 /// Magnetization & susceptibility
 
 class MagnetisationObservable : public Observable
 {
 public:
-	MagnetisationObservable(int numberMeasurements, SpinOrientation* spinOrientation, int boolEachSpin);
+	MagnetisationObservable(int numberMeasurements, SpinOrientation* spinOrientation, int boolEachSpin,
+		std::shared_ptr<ObservableEngine> engine);
 	virtual ~MagnetisationObservable();
 	virtual std::string get_steps_header(void) const;
 	virtual std::string get_mean_header(void) const;
@@ -33,10 +37,14 @@ public:
 
 protected:
 	SpinOrientation* _spinOrientation;
+	std::shared_ptr<ObservableEngine> _engine; ///< evaluates the magnetization
 	Threedim* _values;
-	Threedim* _valuesSpinResolved;
+	Threedim* _valuesSpinResolved; ///< only if _boolEachSpin
 	int _numberAtoms;
 	int _boolEachSpin;
+
+	RunningStatistics _statistics[3]; ///< statistics of magnetization components x, y, z
+	std::vector<Threedim> _spinSums; ///< sum of spins over all measurements (only if _boolEachSpin)
 };
 
 #endif /* MAGNETISATIONOBSERVABLE_H_ */
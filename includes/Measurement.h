@@ -15,12 +15,15 @@
 #include <fstream>
 
 #include "Observable.h"
+#include "typedefs.h"
+class ObservableEngine;
 
 /// Coordinate measurements on system
 
 class Measurement {
 public:
-	Measurement(std::vector<std::shared_ptr<Observable>> observables);
+	Measurement(std::vector<std::shared_ptr<Observable>> observables,
+		std::shared_ptr<ObservableEngine> engine = std::shared_ptr<ObservableEngine>());
 	virtual ~Measurement();
 	
 	/// make room for measurement data in observables
@@ -31,16 +34,43 @@ public:
 	void take_mean_values(std::string variable, double temperature);
 	/// reset observables' measurement indexes to 0
 	void reset_observables_measurement_index(void);
+	/// observables keep only the last measurement and accumulate mean values (memory independent of run length)
+	void set_accumulate(int boolAccumulate);
+	int get_accumulate(void) const;
+
+	/// mean values are followed by error bars and autocorrelation times
+	void set_error_analysis(int boolErrorAnalysis);
+	/// TRUE if relative errors of all observables are below targetRelativeError
+	int target_error_reached(double targetRelativeError) const;
+	/// end run before all measurements are taken; mean values are evaluated from measurements so far
+	void stop_early(void);
+
+	/// in accumulator mode: write values of each measurement to file during the run
+	void open_step_output(std::string fname, std::string stepHeader, double simStepWidth);
+	/// close file opened with open_step_output
+	void close_step_output(void);
 
 	/// save measurement values accquired thorugh measure()
 	template <typename T>
 	void save_step_values(std::string fname, std::string stepName, T simStepWidth);
+	/// content of file written by save_step_values
+	template <typename T>
+	std::string step_values_text(std::string stepName, T simStepWidth);
+	/// append mean values to mean values of other measurement object and clear them here
+	void transfer_mean_values(Measurement &measurement);
 	/// save mean measurement values
 	void save_mean_steps(std::string fname, std::string variableName);
+	/// content of file written by save_mean_steps
+	std::string mean_steps_text(std::string variableName);
 
 protected:
 	std::string _meanBody; ///< for storage of mean measurement data of one simulation run
 	std::vector<std::shared_ptr<Observable>> _observables; ///< observables for measurements on spin system
+	std::shared_ptr<ObservableEngine> _engine; ///< evaluates the quantities of all observables in one pass
+
+	int _boolAccumulate; ///< TRUE if observables do not store all measurements of a run
+	std::ofstream _stepStream; ///< step values written during the run in accumulator mode
+	double _stepWidth; ///< simulation step width between two measurements written to _stepStream
 };
 
 
@@ -57,14 +87,30 @@ template <typename T> void Measurement::save_step_values(std::string fname, std:
 	* @param[in] simStepWidth The step width between two successive measurements
 	*/
 
-	int numObservables = _observables.size();
-	if (numObservables > 0)
+	if (_observables.size() > 0 && _boolAccumulate == FALSE)
 	{
 		// only store something if there are any observables
-		// file stream for storage
 		std::fstream filestr;
 		filestr.open(fname, std::fstream::out);
+		filestr << step_values_text(stepHeader, simStepWidth);
+		filestr.close();
+	}
+}
+
+template <typename T> std::string Measurement::step_values_text(std::string stepHeader, T simStepWidth)
+{
+	/**
+	* @param[in] stepHeader The name of the steps. e.g. MCStep or LLGStep
+	* @param[in] simStepWidth The step width between two successive measurements
+	*
+	* @return Measurement data as a function of the simulation step as stored by save_step_values. Empty in
+	*         accumulator mode since step values are written during the run (see open_step_output).
+	*/
 
+	std::stringstream filestr;
+	int numObservables = _observables.size();
+	if (numObservables > 0 && _boolAccumulate == FALSE)
+	{
 		// provide the name of the variable(s)
 		filestr << stepHeader << " ";
 		// provide the names of the observables
@@ -89,8 +135,8 @@ template <typename T> void Measurement::save_step_values(std::string fname, std:
 		{
 			filestr << _observables[j]->get_step_value(numMeasurements - 1);
 		}
-		filestr.close();
 	}
+	return filestr.str();
 }
 
 #endif /* MEASUREMENT_H_ */
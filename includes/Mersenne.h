@@ -20,9 +20,17 @@ public:
 	virtual int IRandom(int min, int max);
 	virtual double Random(void);
 	virtual void Shuffle(std::vector<int> &vector);
+	virtual void set_stream(int seed, int stream);
+	virtual std::shared_ptr<RanGen> split(void);
+
+	/// restart sequence of pseudo random numbers with new seed
+	void set_seed(int seed);
+	/// seed for independent stream number stream derived from seed
+	static int stream_seed(int seed, int stream);
 
 private:
 	std::mt19937 _mt;
+	std::uniform_real_distribution<double> _uniform; ///< [0,1)
 };
 
 
@@ -14,10 +14,11 @@
 #include "typedefs.h"
 
 class SpinOrientation;
+class SpinOrientationHeisenbergRestrictedCone;
 class RanGen;
 class Hamiltonian;
 
-/// Metropolis algorithm
+/// Metropolis algorithm with optional heat-bath and over-relaxation updates
 
 class Metropolis : public SimulationMethod
 {
@@ -28,8 +29,53 @@ public:
 	virtual ~Metropolis();
 	virtual double simulation_step(void);
 
+	/// update classes of non-interacting sites in parallel instead of serial sweep
+	void set_parallel_sweep(const std::vector<std::vector<int>> &colorClasses, int numberThreads);
+
+	/// heat-bath instead of Metropolis trial steps for a fraction of the sites and over-relaxation sweeps
+	void set_kernels(double heatBathFraction, int overRelaxationSweeps);
+
+	/// adapt width of restricted cone to target acceptance during equilibration after each temperature change
+	void set_adaptive_cone(double targetAcceptance, int equilibrationSteps,
+		const std::vector<std::vector<int>> &siteGroups);
+	virtual void set_temperature(double temperature);
+	virtual void set_temperature_gradient(double temperatureMin, double temperatureMax, Threedim direction,
+		Lattice* lattice);
+	virtual int equilibrating(void) const;
+
 private:
+	double parallel_simulation_step(void);
+
+	/// Metropolis or heat-bath trial step at position; returns TRUE if newSpin is accepted
+	int trial_step(int position, RanGen &ranGen, Threedim &newSpin, int &boolMetropolis);
+	/// reflection of spin at position about its effective field; returns TRUE if newSpin is accepted
+	int over_relaxation(int position, RanGen &ranGen, Threedim &newSpin);
+	/// spin drawn from Boltzmann distribution in field
+	Threedim heat_bath_spin(const Threedim &field, double temperature, RanGen &ranGen) const;
+	/// Metropolis acceptance of the energy change of the energies not linear in the spin
+	int accept_nonlinear(int position, const Threedim &oldSpin, const Threedim &newSpin, RanGen &ranGen) const;
+	/// new cone widths from acceptance of Metropolis trial steps of last step
+	void adapt_cone(void);
+
 	std::vector<int> _randomizedSiteList;
+
+	std::vector<std::vector<int>> _colorClasses; ///< active sites without mutual interaction; empty for serial sweep
+	std::vector<int> _randomizedColorList; ///< order in which classes are updated
+	std::vector<std::shared_ptr<RanGen>> _threadRanGens; ///< one pseudo random number generator per thread
+	int _numberThreads; ///< number of threads for parallel sweep
+
+	double _heatBathFraction; ///< probability of heat-bath instead of Metropolis trial step
+	int _overRelaxationSweeps; ///< over-relaxation sweeps after each sweep of trial steps
+
+	SpinOrientationHeisenbergRestrictedCone* _cone; ///< NULL if cone width is not adapted
+	double _targetAcceptance; ///< target acceptance of Metropolis trial steps
+	int _equilibrationSteps; ///< steps with adaptation after each temperature change
+	int _equilibrationStepsLeft; ///< remaining steps with adaptation
+	std::vector<std::vector<int>> _coneGroups; ///< active sites with common cone width
+	std::vector<int> _coneGroupOfSite; ///< index of cone group of each lattice site; -1 for inactive sites
+	std::vector<double> _coneSigma; ///< cone width of each group
+	std::vector<int> _coneAttempts; ///< Metropolis trial steps of each group in current step
+	std::vector<int> _coneAccepted; ///< accepted Metropolis trial steps of each group in current step
 };
 
 #endif /* METROPOLIS_H_ */
@@ -22,6 +22,8 @@ public:
 	virtual ~ModulatedExchangeInteraction();
 	double single_energy(const int &position) const;
 	virtual Threedim effective_field(const int &position) const;
+	virtual int hessian_blocks(const int &position, ThreedimMatrix &onSite, std::vector<int> &partners,
+		std::vector<ThreedimMatrix> &blocks) const;
 
 protected:
 	void setup_modulation_array(int modulationNumber);
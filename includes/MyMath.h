@@ -9,6 +9,7 @@
 #define MYMATH_H_
 
 #include <cmath>
+#include <complex>
 #include <vector>
 #include <math.h>
 
@@ -34,6 +35,11 @@ public:
 	static double cosine_vectors(const Threedim &vec1, const Threedim &vec2);
 
 	static Threedim matrix_vector_product(gsl_matrix* matrix, const Threedim &vec);
+	static Threedim matrix_vector_product(const ThreedimMatrix &matrix, const Threedim &vec);
+	static ThreedimMatrix add(const ThreedimMatrix &matrix1, const ThreedimMatrix &matrix2);
+	static ThreedimMatrix outer_product(const Threedim &vec1, const Threedim &vec2, const double &mult);
+	static ThreedimMatrix cross_product_matrix(const Threedim &vec, const double &mult);
+	static ThreedimMatrix rotation_matrix(const Threedim &vec);
 	static gsl_matrix* get_rotation_matrix(Threedim* array1, const int &index);
 
 	static Twodim two_point_equation(const double &x1, const double &y1, const double &x2, const double &y2);		
@@ -54,6 +60,8 @@ public:
 	static void add_value(int* &array, int &size, const int &value);
 
 	static double topological_charge(const Threedim &x1, const Threedim &x2, const Threedim &x3);
+
+	static void fft(std::complex<double>* data, const int &n, const int &direction);
 };
 
 #endif /* MYMATH_H_ */
@@ -1,9 +1,13 @@
 #ifndef NCMRCONTRASTOBSERVABLE_H
 #define NCMRCONTRASTOBSERVABLE_H
 
+#include <memory>
+#include <vector>
+
 #include "typedefs.h"
 
 #include "Observable.h"
+class ObservableEngine;
 
 /// Non collinear magneto resistance contrast
 /** NCMR contrast as observed by tip of scanning tunneling microscope
@@ -11,8 +15,8 @@
 class NCMRContrastObservable: public Observable
 {
 public:
-	NCMRContrastObservable(int numberMeasurements, Threedim* spinArray, int numberAtoms, int* neighborArray, 
-		int nbors);
+	NCMRContrastObservable(int numberMeasurements, int numberAtoms, int* neighborArray, int nbors,
+		std::shared_ptr<ObservableEngine> engine);
 	~NCMRContrastObservable();
 	virtual std::string get_steps_header(void) const;
 	virtual std::string get_mean_header(void) const;
@@ -22,14 +26,11 @@ public:
 	virtual void clear_storage();
 
 private:
-	double ncmr_contrast_value(int position);
-
-	Threedim* _spinArray;
+	std::shared_ptr<ObservableEngine> _engine; ///< evaluates the contrast of all sites
 	int _numberAtoms;
-	int* _neighborArray;
-	int _nbors;
 
-	double** _ncmrValues;
+	double* _ncmrValues; ///< value at site i of measurement index is at [index * _numberAtoms + i]
+	std::vector<double> _ncmrSums; ///< sum of values of each site over all measurements
 };
 
 #endif //NCMRCONTRASTOBSERVABLE_H
\ No newline at end of file
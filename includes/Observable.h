@@ -37,13 +37,31 @@ public:
 
 	void set_measurement_index(const int &measurementIndex);
 	void set_number_measurements(const int &numberMeasurements);
+	/// TRUE: only the last measurement is stored, mean values are accumulated during the run
+	void set_accumulate(const int &boolAccumulate);
+	/// TRUE: mean values are followed by error bars and autocorrelation times
+	void set_error_analysis(const int &boolErrorAnalysis);
+	/// TRUE: run was stopped before _numberMeasurements measurements were taken
+	void set_stopped_early(const int &boolStoppedEarly);
+	/// relative error of the main quantity of the observable; 0 if the observable does not define one
+	virtual double get_relative_error(void) const;
 	
 	int get_measurement_index(void) const;
 	int get_num_measurements(void) const;
 
 protected:
+	/// position of measurement index in storage for step values
+	int storage_index(const int &index) const;
+	/// number of step values that are stored: 1 in accumulator mode, _numberMeasurements otherwise
+	int get_storage_size(void) const;
+	/// TRUE if all measurements of the run are taken and mean values can be evaluated
+	int measurements_complete(void) const;
+
 	int _measurementIndex; ///< current measurement index
 	int _numberMeasurements; ///< number of measurement values before memory is full
+	int _boolAccumulate; ///< TRUE if step values are not stored for the whole run
+	int _boolErrorAnalysis; ///< TRUE if error bars are part of the mean values
+	int _boolStoppedEarly; ///< TRUE if the run ended before _numberMeasurements measurements
 };
 
 #endif /* OBSERVABLE_H_ */
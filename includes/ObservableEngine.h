@@ -0,0 +1,79 @@
+/*
+* ObservableEngine.h
+*
+*
+*
+*      Evaluation of the quantities of all observables of a measurement in one pass over the lattice. The
+*      observables request the quantities they need at construction and read the results after evaluate().
+*      Magnetization, absolute magnetization, NCMR contrast, energies of site additive energy objects (see
+*      Energy::site_additive) and the topological charge of the cells are accumulated in the same parallel
+*      loop. Lattice site n and cell n are processed in the same iteration since the cells consist of
+*      neighboring sites.
+*/
+
+#ifndef OBSERVABLEENGINE_H_
+#define OBSERVABLEENGINE_H_
+
+// standard includes
+#include <memory>
+#include <vector>
+
+// Qt includes
+#include <QSharedPointer>
+
+// own
+#include "typedefs.h"
+class Hamiltonian;
+class Energy;
+
+/// Single pass evaluation of the quantities of all observables
+
+class ObservableEngine
+{
+public:
+	ObservableEngine(Threedim* spinArray, int numberAtoms);
+	virtual ~ObservableEngine();
+
+	/// energy of each energy object of hamilton; boolEachSpin: also resolved to lattice sites
+	void request_energies(QSharedPointer<Hamiltonian> hamilton, int boolEachSpin);
+	/// NCMR contrast of each lattice site with respect to the given neighbors
+	void request_ncmr_contrast(const int* neighborArray, int nbors);
+	/// topological charge of the cells (3 lattice sites each)
+	void request_winding_number(const TopologicalChargeCell* cells, int cellNum);
+
+	/// evaluate all requested quantities for the current spin configuration
+	void evaluate(void);
+
+	Threedim get_magnetisation(void) const; ///< sum of spins
+	Threedim get_absolute_magnetisation(void) const; ///< sum of absolute values of spin components
+	double get_part_energy(int index) const; ///< total energy of energy object index [meV]
+	/// energy of energy object i at lattice site j is at [i * _numberAtoms + j] [meV]
+	const double* get_site_energies(void) const;
+	const double* get_ncmr_contrast(void) const; ///< NCMR contrast of each lattice site
+	double get_winding_number(void) const; ///< skyrmion number
+
+protected:
+	Threedim* _spinArray; ///< spin configuration
+	int _numberAtoms; ///< number of lattice sites
+
+	std::vector<std::shared_ptr<Energy>> _energies; ///< energy objects of requested Hamiltonian
+	std::vector<int> _siteAdditive; ///< indexes of energies evaluated in the pass over the lattice
+	std::vector<int> _otherEnergies; ///< indexes of energies evaluated by their total_energy
+	int _boolSiteEnergies; ///< TRUE if energies resolved to lattice sites are requested
+
+	const int* _neighborArray; ///< _nbors neighbors per lattice site for NCMR contrast; NULL if not requested
+	int _nbors;
+
+	const TopologicalChargeCell* _cells; ///< cells for skyrmion number; NULL if not requested
+	int _cellNum;
+
+	Threedim _magnetisation;
+	Threedim _absoluteMagnetisation;
+	std::vector<double> _partEnergies; ///< total energy of each energy object
+	std::vector<double> _siteEnergies; ///< energies resolved to lattice sites (only if _boolSiteEnergies)
+	std::vector<double> _threadEnergies; ///< partial sums of site additive energies of each thread
+	std::vector<double> _ncmrContrast; ///< NCMR contrast of each lattice site
+	double _windingNumber;
+};
+
+#endif /* OBSERVABLEENGINE_H_ */
@@ -0,0 +1,86 @@
+/*
+* OutputWriter.h
+*
+*
+*
+*      Writes output files in a separate thread. The simulation thread copies the data to be written (spin
+*      configurations, text) into one of a fixed number of buffers and continues with the simulation while
+*      the writer thread serializes and writes the buffer. If all buffers are in use, the simulation thread
+*      waits until a buffer is free again, which bounds the memory used by pending output.
+*/
+
+#ifndef OUTPUTWRITER_H_
+#define OUTPUTWRITER_H_
+
+// standard includes
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// own
+#include "typedefs.h"
+class SpinConfigurationFile;
+
+/// Type of output job of OutputWriter
+enum OutputJobType { outputText, outputSpinText, outputSpinBinary, outputSpinFrame };
+
+/// Pooled buffer of OutputWriter holding one output job
+struct OutputBuffer
+{
+	OutputJobType type = outputText;
+	std::string fname;
+	std::string text; ///< content of text file
+	std::vector<int> activityList; ///< activity of lattice sites
+	std::vector<Threedim> spins; ///< spin configuration
+	int64_t label = 0; ///< label of frame in binary file
+	uint64_t latticeHash = 0; ///< lattice hash of binary file
+	int precision = 8; ///< bytes per spin component of binary file
+	std::shared_ptr<SpinConfigurationFile> file; ///< open binary file to which frame is appended
+};
+
+/// Output of files in a separate writer thread with bounded number of pending jobs
+
+class OutputWriter
+{
+public:
+	OutputWriter(int numberBuffers);
+	virtual ~OutputWriter();
+
+	/// text file with given content
+	void save_text(std::string fname, std::string text);
+	/// spin configuration as text file as written by Functions::save
+	void save_spin_configuration(std::string fname, const int* activityList, const Threedim* spinArray,
+		int numberAtoms);
+	/// spin configuration as binary file (see SpinConfigurationFile::save)
+	void save_spin_configuration(std::string fname, const int* activityList, const Threedim* spinArray,
+		int numberAtoms, uint64_t latticeHash, int precision);
+	/// append frame to binary file opened by caller
+	void append_frame(std::shared_ptr<SpinConfigurationFile> file, const Threedim* spinArray, int numberAtoms,
+		int64_t label);
+
+	/// wait until all pending jobs are written
+	void flush(void);
+
+protected:
+	std::unique_ptr<OutputBuffer> acquire_buffer(void); ///< free buffer; waits if all buffers are in use
+	void submit(std::unique_ptr<OutputBuffer> buffer); ///< write buffer in writer thread
+	void write(OutputBuffer &buffer); ///< serialize and write buffer
+	void run(void); ///< loop of writer thread
+
+	int _numberBuffers; ///< 0: files are written in calling thread
+	std::vector<std::unique_ptr<OutputBuffer>> _freeBuffers; ///< buffers available for new jobs
+	std::deque<std::unique_ptr<OutputBuffer>> _queue; ///< jobs waiting for writer thread
+	int _numberWriting; ///< number of jobs currently written (0 or 1)
+	int _boolStop; ///< TRUE if writer thread shall terminate
+	std::mutex _mutex;
+	std::condition_variable _jobAvailable; ///< signaled by submit() and destructor
+	std::condition_variable _bufferAvailable; ///< signaled by writer thread after each job
+	std::thread _thread;
+};
+
+#endif /* OUTPUTWRITER_H_ */
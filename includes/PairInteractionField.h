@@ -0,0 +1,62 @@
+/*
+* PairInteractionField.h
+*
+*
+*
+*      Fused evaluation of the effective field of all bilinear pair interactions (exchange, DM,
+*      pseudo-dipolar and their defect variants) with a compressed neighbor list.
+*/
+
+#ifndef PAIRINTERACTIONFIELD_H_
+#define PAIRINTERACTIONFIELD_H_
+
+// standard includes
+#include <memory>
+#include <vector>
+
+// Eigen
+#include <Eigen/Core>
+
+// own
+#include "typedefs.h"
+class Energy;
+
+/// Fused effective field of all bilinear pair interactions
+
+class PairInteractionField
+{
+public:
+	PairInteractionField(const std::vector<std::shared_ptr<Energy>> &energies, int numberAtoms,
+		Threedim* spinArray);
+	virtual ~PairInteractionField();
+
+	/// effective field of all pair interactions acting on spin at position
+	Threedim effective_field(const int &position) const;
+	/// effective fields for a list of lattice sites. fields[i] belongs to sites[i]
+	void effective_fields(const int* sites, const int &numberSites, Threedim* fields);
+
+	/// set member _spinArray
+	void set_spin_array(Threedim* spinArray);
+	/// return number of stored bonds
+	int get_number_bonds(void) const;
+
+protected:
+	typedef std::vector<double, Eigen::aligned_allocator<double>> AlignedVector;
+
+	void setup_bonds(const std::vector<std::shared_ptr<Energy>> &energies); ///< setup compressed neighbor list
+	void copy_spins(void); ///< copy spin configuration to _spinX, _spinY, _spinZ
+
+	int _numberAtoms; ///< number of lattice sites
+	int _paddedNumberAtoms; ///< size of spin component arrays (multiple of simd width)
+	Threedim* _spinArray; ///< spin configuration
+
+	std::vector<int> _rowStart; ///< bonds of site i are _rowStart[i] ... _rowStart[i+1]-1
+	std::vector<int> _partners; ///< interaction partner of each bond
+	AlignedVector _couplings[9]; ///< coupling tensor components xx,xy,xz,yx,...,zz of each bond [meV]
+
+	AlignedVector _spinX; ///< x components of spin configuration
+	AlignedVector _spinY; ///< y components of spin configuration
+	AlignedVector _spinZ; ///< z components of spin configuration
+};
+
+#endif /* PAIRINTERACTIONFIELD_H_ */
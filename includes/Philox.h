@@ -0,0 +1,38 @@
+/*
+* Philox.h
+*
+*
+*
+*      Counter-based pseudo random number generator Philox4x32-10 (Salmon et al., "Parallel random numbers:
+*      as easy as 1, 2, 3", SC11). Random numbers are a function of key and counter only, so independent
+*      streams for threads or lattice sites need no state.
+*/
+
+#ifndef PHILOX_H_
+#define PHILOX_H_
+
+// standard includes
+#include <cstdint>
+
+/// Counter-based pseudo random number generator Philox4x32-10
+
+class Philox
+{
+public:
+	Philox(uint64_t key);
+	virtual ~Philox();
+
+	/// four 32 bit random numbers for 128 bit counter (counterHigh, counterLow)
+	void generate(uint64_t counterHigh, uint64_t counterLow, uint32_t* result) const;
+	/// four pseudo random numbers uniformly distributed in (0,1)
+	void uniform(uint64_t counterHigh, uint64_t counterLow, double* result) const;
+	/// four pseudo random numbers according to standard normal distribution (Box-Muller)
+	void gaussian(uint64_t counterHigh, uint64_t counterLow, double* result) const;
+
+	uint64_t get_key(void) const;
+
+protected:
+	uint32_t _key[2]; ///< key of generator
+};
+
+#endif /* PHILOX_H_ */
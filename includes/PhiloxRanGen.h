@@ -0,0 +1,57 @@
+/*
+* PhiloxRanGen.h
+*
+*
+*
+*      Pseudo random number generator based on the counter-based generator Philox4x32-10. The numbers of a
+*      stream are the outputs of Philox for the counters 0, 1, 2, ... with the stream index as upper half of the
+*      128 bit counter and the seed as key. Any number is thus determined by (seed, stream, position) alone.
+*      Streams are independent without any state to be advanced, so threads and replicas obtain their own
+*      stream. Blocks of numbers are generated directly from consecutive counters.
+*/
+
+#ifndef PHILOXRANGEN_H_
+#define PHILOXRANGEN_H_
+
+#include "RanGen.h"
+
+// standard includes
+#include <cstdint>
+
+// own
+#include "Philox.h"
+
+/// Counter-based pseudo random number generator with independent streams
+
+class PhiloxRanGen : public RanGen
+{
+public:
+	PhiloxRanGen(int seed, uint64_t stream = 0);
+	virtual ~PhiloxRanGen();
+	virtual int IRandom(int min, int max);
+	virtual double Random(void);
+	virtual void Shuffle(std::vector<int> &vector);
+	virtual void polar(double &x1, double &x2);
+	virtual void uniform_block(double* result, int n);
+	virtual void gaussian_block(double* result, int n);
+	virtual void set_stream(int seed, int stream);
+	virtual std::shared_ptr<RanGen> split(void);
+
+	/// number of pseudo random numbers drawn from stream
+	uint64_t get_position(void) const;
+	/// continue stream at given position
+	void set_position(uint64_t position);
+
+private:
+	uint32_t next(void); ///< next 32 bit random number of stream
+	static uint64_t mix(uint64_t z); ///< bijective hash of 64 bit number
+
+	Philox _philox; ///< key is the seed
+	uint64_t _stream; ///< upper 64 bits of counter
+	uint64_t _counter; ///< lower 64 bits of counter for next block of four numbers
+	uint32_t _buffer[4]; ///< numbers of counter _counter - 1
+	int _bufferIndex; ///< next unused number of _buffer; 4 if empty
+	uint64_t _numberSplits; ///< generators created by split()
+};
+
+#endif /* PHILOXRANGEN_H_ */
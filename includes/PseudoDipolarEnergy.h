@@ -17,6 +17,10 @@ public:
 	virtual ~PseudoDipolarEnergy();
 	double single_energy(const int &position) const;
 	virtual Threedim effective_field(const int &position) const;
+	virtual double delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const;
+	virtual int linear_in_spin(void) const;
+	virtual int pair_couplings(const int &position, std::vector<int> &partners, 
+		std::vector<ThreedimMatrix> &couplings) const;
 
 	int get_nbors(void) const;
 	int* get_neighbor_array(void) const;
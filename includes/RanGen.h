@@ -15,6 +15,7 @@
 #include <stdlib.h>
 #include <math.h> 
 #include <vector>
+#include <memory>
 
 /// Basis class for pseudo random number generators
 
@@ -29,7 +30,16 @@ public:
 	/// random permutation
 	virtual void Shuffle(std::vector<int> &vector) = 0;
 	/// two  pseudo random numbers according to standard normal distribution (mu = 0 and sigma = 1)
-	void polar(double &x1, double &x2);
+	virtual void polar(double &x1, double &x2);
+	/// n pseudo random numbers in [0,1]
+	virtual void uniform_block(double* result, int n);
+	/// n pseudo random numbers according to standard normal distribution
+	virtual void gaussian_block(double* result, int n);
+
+	/// restart with independent stream number stream derived from seed
+	virtual void set_stream(int seed, int stream) = 0;
+	/// new generator of the same kind independent of this one (e.g. for threads or replicas)
+	virtual std::shared_ptr<RanGen> split(void) = 0;
 
 };
 
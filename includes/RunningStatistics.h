@@ -0,0 +1,80 @@
+/*
+* RunningStatistics.h
+*
+*
+*
+*      Mean and variance of a sequence of measurement values without storing the values (Welford's
+*      algorithm). In addition, successive values are combined pairwise into blocks of 2, 4, 8, ... values
+*      and mean and variance of the block means are kept for each block size (binning / blocking analysis
+*      of correlated data). Memory is O(log(number of values)).
+*
+*      The standard error of the mean is estimated from the block size at which the variance of the block
+*      means levels off, which also yields the integrated autocorrelation time. For quantities derived from the
+*      variance (heat capacity, susceptibility) the values are additionally summed up in a fixed number of
+*      contiguous bins for jackknife error estimates.
+*/
+
+#ifndef RUNNINGSTATISTICS_H_
+#define RUNNINGSTATISTICS_H_
+
+// standard includes
+#include <cstdint>
+#include <vector>
+
+/// Statistics of block means for one block size 2**level
+struct BlockLevel
+{
+	int64_t count = 0; ///< number of complete blocks
+	double mean = 0; ///< mean of block means
+	double m2 = 0; ///< sum of squared deviations of block means from mean
+	double pending = 0; ///< mean of incomplete block (one half of next block)
+	int boolPending = 0; ///< TRUE if pending holds a value
+};
+
+/// Sums of values and squared values of one jackknife bin
+struct JackknifeBin
+{
+	int64_t count = 0;
+	double sum = 0; ///< sum of (value - shift)
+	double sumSquares = 0; ///< sum of (value - shift)**2
+};
+
+/// Streaming mean, variance and blocking statistics of a sequence of values
+
+class RunningStatistics
+{
+public:
+	RunningStatistics();
+	virtual ~RunningStatistics();
+
+	void add(const double &value); ///< add next measurement value
+	void clear(void); ///< remove all values
+
+	int64_t get_count(void) const;
+	double get_mean(void) const;
+	double get_variance(void) const; ///< sample variance (division by count - 1)
+	double get_population_variance(void) const; ///< division by count
+
+	int get_number_levels(void) const; ///< number of block sizes with at least one complete block
+	int64_t get_level_count(const int &level) const; ///< number of blocks of size 2**level
+	double get_level_variance(const int &level) const; ///< sample variance of means of blocks of size 2**level
+
+	/// standard error of the mean for correlated values (blocking analysis)
+	double get_error(void) const;
+	/// integrated autocorrelation time in units of values; 0.5 for uncorrelated values
+	double get_autocorrelation_time(void) const;
+	/// variance with one bin left out, for each complete jackknife bin
+	void jackknife_variances(std::vector<double> &variances, const int &boolSample) const;
+	/// error of a quantity from its estimates with one bin left out
+	static double jackknife_error(const std::vector<double> &estimates);
+
+protected:
+	std::vector<BlockLevel> _levels; ///< level 0: single values
+
+	double _shift; ///< first value; subtracted in jackknife bins to avoid cancellation
+	int64_t _binSize; ///< number of values per jackknife bin
+	std::vector<JackknifeBin> _bins; ///< complete jackknife bins
+	JackknifeBin _currentBin; ///< incomplete jackknife bin
+};
+
+#endif /* RUNNINGSTATISTICS_H_ */
@@ -46,6 +46,7 @@ public:
 	void setup_measurement(void);
 	void setup_hamiltonian(void);
 	void setup_energies(void);
+	std::vector<std::vector<int>> create_color_classes(void) const;
 	
 	// manipulation of external magnetic field
 	void set_magnetic_field(double H);
@@ -8,6 +8,7 @@
 #ifndef SIMULATIONMETHOD_H_
 #define SIMULATIONMETHOD_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -22,6 +23,7 @@ class RanGen;
 class Measurement;
 class SimulationProgram;
 class Lattice;
+class OutputWriter;
 
 /// Basis class for simulation methods as Metropolis algorithm or Landau-Lifshitz-Gilbert (LLG) equation
 
@@ -40,14 +42,33 @@ public:
 	virtual void set_temperature_gradient(double temperatureMin, double temperatureMax, Threedim direction,
 		Lattice* lattice);
 
+	/// file format for spin configurations between movieStart and movieEnd
+	void set_spin_file_format(SpinFileFormat spinFileFormat, uint64_t latticeHash);
+	/// spin configurations between movieStart and movieEnd are written by output writer thread
+	void set_output_writer(OutputWriter* outputWriter);
+	/// stop run once the mean values of the measurement reach the relative error; 0 for fixed run length
+	void set_target_relative_error(double targetRelativeError);
+	/// stop run once the convergence criterion or the energy change stays below a tolerance
+	void set_convergence_stop(double torqueTolerance, double energyTolerance, int consecutiveChecks,
+		int checkWidth);
+	/// number of simulation steps performed by the last run
+	int get_steps_performed(void) const;
+	/// TRUE while the method adapts its parameters; run_simulation performs these steps before the measured ones
+	virtual int equilibrating(void) const;
+
 	/// Perform _simulationSteps numbers of simulation steps at constant energy parameters 
 	void run_simulation(int uiUpdateWidth, std::shared_ptr<Measurement> measurement, int outputWidth, 
 		int movieStart, int movieEnd, 
 		int movieWidth, std::string fname);
+	/// Perform _simulationSteps numbers of simulation steps without synchronization with GUI thread
+	void run_simulation(std::shared_ptr<Measurement> measurement, int outputWidth);
 	/// Perform simulationSteps numbers of simulation steps at constant energy parameters 
 	void relaxate(int simulationSteps);
 
 protected:
+	/// evaluates convergence stop at a check step; TRUE if the run shall end
+	int converged(double convergenceCriterion);
+
 	SpinOrientation* _spinOrientation; ///< spin configuration
 	int _simulationSteps; ///< number of simulation steps
 	double* _temperature; ///< temperature at each spin
@@ -62,6 +83,20 @@ protected:
 	int* _inactiveSites; ///< number of inactive sites
 
 	int _boolConvergenceCriterion;
+
+	SpinFileFormat _spinFileFormat; ///< file format of spin configurations during run_simulation
+	uint64_t _latticeHash; ///< stored in binary spin configuration files
+	OutputWriter* _outputWriter; ///< NULL: spin configurations are written in simulation thread
+	double _targetRelativeError; ///< run ends when relative error of measurement is reached; 0 to disable
+
+	double _torqueTolerance; ///< tolerance of convergence criterion (maximum torque); 0 to disable
+	double _energyTolerance; ///< tolerance of energy change per active site between checks [meV]; 0 to disable
+	int _convergenceChecks; ///< number of consecutive checks below tolerance to end run
+	int _convergenceWidth; ///< check convergence every _convergenceWidth simulation steps; 0 to disable
+	int _numberConverged; ///< number of consecutive checks below tolerance so far
+	int _boolLastEnergy; ///< TRUE if _lastEnergy holds the energy of the previous check
+	double _lastEnergy; ///< total energy at previous check
+	int _stepsPerformed; ///< simulation steps of last run
 };
 
 #endif /* SIMULATIONMETHOD_H_ */
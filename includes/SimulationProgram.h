@@ -31,6 +31,10 @@ class Hamiltonian;
 class SpinOrientation;
 class Setup;
 class RanGen;
+class OutputWriter;
+class Measurement;
+class ExcitationModeSolver;
+class SimulationMethod;
 
 /// Main class of simulation software.
 /**
@@ -88,10 +92,20 @@ protected:
 	void temperature_magnetic_field_loop(const std::shared_ptr<Setup> &setup, std::shared_ptr<RanGen> ranGen, 
 		int boolFolderOutput);
 	
+	/// Program type 3 with independent points of the temperature and magnetic field loop in parallel
+	void independent_sweep(const std::shared_ptr<Setup> &setup, int boolFolderOutput);
+
 	/// Program type 4: Monte Carlo or Spin Dynamics simulation with a temperature gradient over lattice
 	void spin_seebeck(const std::shared_ptr<Setup> &setup, std::shared_ptr<RanGen> ranGen, 
 		int boolFolderOutput);
 	
+	/// Program type 6: Metropolis simulation with one replica per temperature and replica exchange
+	void parallel_tempering(const std::shared_ptr<Setup> &setup, std::shared_ptr<RanGen> ranGen,
+		int boolFolderOutput);
+
+	/// Program type 7: minimum energy path between two spin configurations (geodesic nudged elastic band)
+	void geodesic_nudged_elastic_band(const std::shared_ptr<Setup> &setup, std::shared_ptr<RanGen> ranGen);
+
 	/// Program type 5: Monte Carlo or Spin Dynamics simulation with a magnetic tip
 	void tip_movement(const std::shared_ptr<Setup> &setup, std::shared_ptr<RanGen> ranGen);
 
@@ -99,9 +113,26 @@ protected:
 	void experiment01(const std::shared_ptr<Setup> &setup, std::shared_ptr<RanGen> ranGen, 
 		int boolFolderOutput);
 
-	/// Eigen frequency calculation.
-	void eigen_frequency(const std::shared_ptr<Setup> &setup, std::string fname);
+	/// Eigen frequency calculation; the solver keeps its factorization and eigenvectors for the next call
+	void eigen_frequency(const std::shared_ptr<Setup> &setup,
+		const std::shared_ptr<ExcitationModeSolver> &excitationModeSolver, std::string fname);
 	
+	/// Metropolis only: parallel sweep, heat-bath and over-relaxation updates and adaptive cone as in _config
+	void configure_metropolis(const std::shared_ptr<Setup> &setup,
+		const std::shared_ptr<SimulationMethod> &simulation);
+
+	/// in accumulator mode: stream measurement values of each step to file during the run
+	void open_step_output(const std::shared_ptr<Measurement> &measurement, std::string fname);
+
+	/// pseudo random number generator of kind specified in _config
+	std::shared_ptr<RanGen> create_random_generator(int seed) const;
+
+	/// number of lattice sites of a text or binary spin configuration file
+	int spin_file_number_atoms(std::string fname, Lattice* lattice);
+
+	/// save spin configuration in file format specified in _config
+	void save_spin_configuration(SpinOrientation* spinOrientation, Lattice* lattice, std::string fname);
+
 	/// create a unique simulation folder 
 	QDir create_unique_simulation_folder(std::string &simID, int boolFolderOutput = 1);
 	/// save lattice information to simulation folder
@@ -118,6 +149,8 @@ protected:
 	QSharedPointer<Lattice> _lattice;
 	/// spin orientation from cache of last simulation
 	QSharedPointer<SpinOrientation> _spinOrientation;
+	/// writes output files in separate thread
+	std::shared_ptr<OutputWriter> _outputWriter;
 };
 
 #endif /* SIMULATIONPROGRAM_H_ */
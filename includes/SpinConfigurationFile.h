@@ -0,0 +1,91 @@
+/*
+* SpinConfigurationFile.h
+*
+*
+*
+*      Binary container for spin configurations. The file starts with a header (SpinFileHeader) followed by
+*      the activity of each lattice site (one byte per site) and an arbitrary number of frames. Each frame
+*      holds a label (e.g. the simulation step) and the packed spin components x,y,z of all sites as float32
+*      or float64 values. All frames have the same size, so frame k is found without an index table and
+*      frames can be appended to an existing file. Files are read via memory mapping without copying.
+*      Values are stored in the byte order of the machine (little endian on all supported platforms).
+*/
+
+#ifndef SPINCONFIGURATIONFILE_H_
+#define SPINCONFIGURATIONFILE_H_
+
+// standard includes
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// own
+#include "typedefs.h"
+class QFile;
+
+/// Header of binary spin configuration file; 64 bytes
+struct SpinFileHeader
+{
+	char magic[8]; ///< "MCSPIN" followed by two zero bytes
+	uint32_t version; ///< format version
+	uint32_t precision; ///< bytes per spin component: 4 (float32) or 8 (float64)
+	int64_t numberAtoms; ///< number of lattice sites
+	uint64_t latticeHash; ///< hash of lattice coordinates (see SpinConfigurationFile::lattice_hash); 0 if unknown
+	uint64_t dataOffset; ///< position of first frame in file [bytes]
+	uint64_t frameSize; ///< size of one frame including label [bytes]
+	char reserved[16];
+};
+
+/// Binary spin configuration file with many frames, memory mapped read access
+
+class SpinConfigurationFile
+{
+public:
+	SpinConfigurationFile();
+	virtual ~SpinConfigurationFile();
+
+	// writing
+	int create(std::string fname, int numberAtoms, const int* activityList, uint64_t latticeHash, int precision);
+	int append(std::string fname);
+	int append_frame(const Threedim* spinArray, int64_t label);
+	void close(void);
+
+	// reading
+	int open(std::string fname);
+	int get_number_atoms(void) const;
+	int get_number_frames(void) const;
+	int get_precision(void) const;
+	uint64_t get_lattice_hash(void) const;
+	int64_t get_frame_label(int frame) const;
+	/// pointer to spin components of frame within mapped file (float or double according to precision)
+	const void* get_frame_data(int frame) const;
+	void read_frame(int frame, Threedim* spinArray) const;
+	void read_activity_list(int* activityList) const;
+
+	/// single spin configuration as binary file
+	static int save(std::string fname, const int* activityList, const Threedim* spinArray, int numberAtoms,
+		uint64_t latticeHash, int precision);
+	/// TRUE if file is a binary spin configuration file
+	static int is_spin_configuration_file(std::string fname);
+	/// hash of lattice coordinates rounded to 1e-6 lattice constants
+	static uint64_t lattice_hash(const Threedim* latticeCoordArray, int numberAtoms);
+	/// convert text file as written by Functions::save into binary file
+	static int text_to_binary(std::string textFname, std::string binaryFname, int precision);
+	/// convert frame of binary file into text file as written by Functions::save; -1 for last frame
+	static int binary_to_text(std::string binaryFname, std::string textFname, int frame = -1);
+
+protected:
+	static int read_header(std::istream &stream, SpinFileHeader &header);
+
+	SpinFileHeader _header; ///< header of current file
+	std::ofstream _output; ///< output stream for appending frames
+	std::vector<char> _frameBuffer; ///< frame in file layout before writing
+
+	std::unique_ptr<QFile> _mappedFile; ///< file opened for reading
+	const unsigned char* _map; ///< memory mapped content of file
+	int64_t _mapSize; ///< size of mapped content [bytes]
+};
+
+#endif /* SPINCONFIGURATIONFILE_H_ */
@@ -45,6 +45,10 @@ public:
 	virtual void single_orientation(int position) = 0;
 	/// restore latest random reorientation
 	virtual void restore_single_orientation(void) = 0;
+	/// random trial direction for spin drawn with ranGen; spin configuration is not changed
+	virtual Threedim trial_spin(int position, RanGen &ranGen) = 0;
+	/// random trial direction for spin; spin configuration is not changed
+	Threedim trial_spin(int position);
 	
 	/// read spin configuraiton from file
 	void read_spin_configuration(std::string fname);
@@ -29,10 +29,11 @@ public:
 
 	virtual void single_orientation(int position);
 	virtual void restore_single_orientation();
+	virtual Threedim trial_spin(int position, RanGen &ranGen);
 
 
 protected:
-	Threedim generate_random_spin(void);
+	Threedim generate_random_spin(RanGen &ranGen);
 };
 
 #endif /* SPINORIENTATIONHEISENBERG_H_ */
@@ -10,10 +10,12 @@
 
 #include "SpinOrientationHeisenberg.h"
 
+#include <vector>
+
 /// Heisenberg spins with restricted update freedom
 /**
 * Spins can move freely on surface of unit sphere but their direction change during Metropolis Monte Carlo is
-* restricted to a cone
+* restricted to a cone. The width of the cone can differ between lattice sites.
 */
 class SpinOrientationHeisenbergRestrictedCone : public SpinOrientationHeisenberg
 {
@@ -22,11 +24,17 @@ public:
 	virtual ~SpinOrientationHeisenbergRestrictedCone();
 
 	virtual void single_orientation(int position);	
+	virtual Threedim trial_spin(int position, RanGen &ranGen);
+
+	/// set width of cone at all lattice sites
+	void set_sigma(double sigma);
+	/// set width of cone at given lattice sites
+	void set_sigma(double sigma, const std::vector<int> &sites);
+	/// width of cone at lattice site
+	double get_sigma(int position) const;
 
 private:
-	void make_random_change_within_cone(int position);
-	
-	double _sigma;
+	std::vector<double> _sigma; ///< standard deviation of Gaussian spin change at each lattice site
 
 };
 
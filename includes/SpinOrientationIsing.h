@@ -29,6 +29,7 @@ public:
 
 	virtual void single_orientation(int position);
 	virtual void restore_single_orientation(void);;
+	virtual Threedim trial_spin(int position, RanGen &ranGen);
 
 private:
 	int generate_random_spin(void);
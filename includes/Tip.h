@@ -24,6 +24,10 @@ public:
 	virtual ~Tip();
 	virtual double single_energy(const int &position) const;
 	virtual Threedim effective_field(const int &position) const;
+	virtual double delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const;
+	virtual int linear_in_spin(void) const;
+	virtual int hessian_blocks(const int &position, ThreedimMatrix &onSite, std::vector<int> &partners,
+		std::vector<ThreedimMatrix> &blocks) const;
 
 	void set_position(Threedim position); ///< set tip position
 	void set_direction(Threedim tipDirection); ///< set magnetization direction
@@ -24,6 +24,9 @@ public:
 	virtual double single_energy(const int &position) const;
 	
 	virtual Threedim effective_field(const int &position) const;
+	virtual double delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const;
+	virtual int hessian_blocks(const int &position, ThreedimMatrix &onSite, std::vector<int> &partners,
+		std::vector<ThreedimMatrix> &blocks) const;
 
 protected:
 	Threedim _direction; ///< spatial orientation of anisotropy axis
@@ -9,18 +9,22 @@
 #define WINDINGNUMBER_H_
 
 #include <iostream>
+#include <memory>
 #include <sstream> 
 
 #include "typedefs.h"
 
 #include "Observable.h"
+#include "RunningStatistics.h"
+class ObservableEngine;
 
 /// Winding/skyrmion number 
 
 class WindingNumber : public Observable
 {
 public:
-	WindingNumber(int numberMeasurements, Threedim* spinArray, TopologicalChargeCell* cells, int cellNum);
+	WindingNumber(int numberMeasurements, Threedim* spinArray, TopologicalChargeCell* cells, int cellNum,
+		std::shared_ptr<ObservableEngine> engine);
 	virtual ~WindingNumber();
 	virtual std::string get_steps_header(void) const;
 	virtual std::string get_mean_header(void) const;
@@ -35,9 +39,11 @@ public:
 
 protected:
 	Threedim const * const _spinArray; ///< spin configuration
+	std::shared_ptr<ObservableEngine> _engine; ///< evaluates the skyrmion number for take_value
 	TopologicalChargeCell const * const _cells; ///< skyrmion cells (consisting of 3 sites each)
 	int const _cellNum; ///< number of skyrmion cells
 	double* _windingNumber; ///< storage for skyrmion number
+	RunningStatistics _statistics; ///< statistics of skyrmion number
 	double* _localWindingNumber; ///< storage for lattice resolved winding number
 	double _areaUnitSphere; 
 };
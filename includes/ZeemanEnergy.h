@@ -21,6 +21,10 @@ public:
 	virtual ~ZeemanEnergy();
 	virtual double single_energy(const int &position) const;
 	virtual Threedim effective_field(const int &position) const;
+	virtual double delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const;
+	virtual int linear_in_spin(void) const;
+	virtual int hessian_blocks(const int &position, ThreedimMatrix &onSite, std::vector<int> &partners,
+		std::vector<ThreedimMatrix> &blocks) const;
 
 	void set_direction(Threedim direction); ///< set direction of magnetic field
 	Threedim get_direction(void) const;
@@ -32,7 +32,7 @@
 /// Simulation method - Monte Carlo or spin dynamics
 enum SimulationType
 {
-	metropolis, landauLifshitzGilbert, converger1
+	metropolis, landauLifshitzGilbert, converger1, energyMinimizer, clusterUpdate
 };
 
 /// Select an "experiment". Here, one could also specify new purposes of the program.
@@ -40,7 +40,8 @@ enum ProgramType
 {
 	temperatureMagneticFieldLoop, spinSeebeck, tipMovement, latticeSiteEnergies,
 	latticeSiteWindingNumber, Experiment01, EigenFrequency, readLatticeConfiguration, readSpinConfiguration,
-	saveLatticeConfiguration, saveSpinConfiguration, latticeMaskRead
+	saveLatticeConfiguration, saveSpinConfiguration, latticeMaskRead, parallelTempering,
+	geodesicNudgedElasticBand
 };
 
 /// Specification of lattice type.
@@ -56,6 +57,24 @@ enum BoundaryConditions
 	openBound, helical, periodic, periodicX, periodicY
 };
 
+/// File format for output of spin configurations. Binary formats see SpinConfigurationFile
+enum SpinFileFormat
+{
+	spinFileText, spinFileFloat32, spinFileFloat64
+};
+
+/// Evaluation of the dipolar interaction. Auto: FFT if lattice sites lie on a regular grid, direct otherwise
+enum DipolarMethod
+{
+	dipolarAuto, dipolarDirect, dipolarFFT, dipolarTree
+};
+
+/// Pseudo random number generator. Philox is counter-based with independent streams (see PhiloxRanGen)
+enum RandomGeneratorType
+{
+	mersenneTwister, philoxGenerator
+};
+
 /// Spin model
 enum SpinType
 {
@@ -77,6 +96,14 @@ struct Threedim
 	double z = 0.0;
 };
 
+/// Helper struct with 3x3 double values; rows stored as Threedim
+struct ThreedimMatrix
+{
+	Threedim x;
+	Threedim y;
+	Threedim z;
+};
+
 /// Helper struct to store information about a cell for the calculation of local topological charge
 struct TopologicalChargeCell
 {
@@ -24,28 +24,29 @@
 
 //forward includes
 #include "SpinOrientation.h"
+#include "ObservableEngine.h"
 
 #include <sstream> 
 #include <iostream>
 #include "MyMath.h"
 
 AbsoluteMagnetisationObservable::AbsoluteMagnetisationObservable(int numberMeasurements, 
-								 SpinOrientation* spinOrientation):
+								 SpinOrientation* spinOrientation, std::shared_ptr<ObservableEngine> engine):
 	Observable(numberMeasurements)
 {
 	/**
 	* @param[in] numberMeasurements Number of measurement values that can be stored
 	* @param[in] spinOrientation Information about spin  system	
+	* @param[in] engine Evaluates the sums of |Si| before take_value is called
 	*/
 
 	_spinOrientation = spinOrientation;
-	_absoluteMagnetisation = new Threedim[numberMeasurements]; // for storage of measurement values
+	_engine = engine;
 	_numberAtoms = spinOrientation->get_number_atoms();
 }
 
 AbsoluteMagnetisationObservable::~AbsoluteMagnetisationObservable()
 {
-	delete[] _absoluteMagnetisation;
 }
 
 std::string AbsoluteMagnetisationObservable::get_steps_header(void) const
@@ -56,20 +57,19 @@ std::string AbsoluteMagnetisationObservable::get_steps_header(void) const
 std::string AbsoluteMagnetisationObservable::get_mean_header(void) const
 {
 	std::string header = "<|SiX|> <|SiY|> <|SiZ|> ";
+	if (_boolErrorAnalysis == TRUE)
+	{
+		header.append("d<|SiX|> d<|SiY|> d<|SiZ|> ");
+	}
 	return header;
 }
 
 void AbsoluteMagnetisationObservable::take_value(void)
 {
-	Threedim* spinArray = _spinOrientation->get_spin_array();
-	Threedim tmpValues = { 0,0,0 };
-	for (int i = 0; i < _numberAtoms; ++i) // average measurement values
-	{
-		tmpValues.x += fabs(spinArray[i].x);
-		tmpValues.y += fabs(spinArray[i].y);
-		tmpValues.z += fabs(spinArray[i].z);
-	}
-	_absoluteMagnetisation[_measurementIndex] = tmpValues;
+	Threedim tmpValues = _engine->get_absolute_magnetisation();
+	_statistics[0].add(tmpValues.x);
+	_statistics[1].add(tmpValues.y);
+	_statistics[2].add(tmpValues.z);
 	++_measurementIndex;
 }
 
@@ -84,17 +84,19 @@ std::string AbsoluteMagnetisationObservable::get_step_value(const int &index) co
 std::string AbsoluteMagnetisationObservable::get_mean_value(const double &temperature) const
 {
 	std::stringstream stream;
-	if (_measurementIndex == _numberMeasurements)
+	if (measurements_complete() == TRUE)
 	{
 
-		Threedim meanValues = {0,0,0};
-		for (int i = 0; i < _numberMeasurements; ++i) // average measurement values
-		{
-			meanValues = MyMath::add(meanValues,_absoluteMagnetisation[i]);
-		}
-		meanValues = MyMath::mult(meanValues, 1 / (double)_numberMeasurements);
+		Threedim meanValues = { _statistics[0].get_mean(), _statistics[1].get_mean(), _statistics[2].get_mean() };
 		meanValues = MyMath::mult(meanValues, 1/(double)_numberAtoms);
 		stream << meanValues.x << " " << meanValues.y << " " << meanValues.z << " ";
+		if (_boolErrorAnalysis == TRUE)
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				stream << _statistics[i].get_error() / _numberAtoms << " ";
+			}
+		}
 	}
 	else
 	{
@@ -105,6 +107,9 @@ std::string AbsoluteMagnetisationObservable::get_mean_value(const double &temper
 
 void AbsoluteMagnetisationObservable::clear_storage()
 {
-	delete[] _absoluteMagnetisation;
-	_absoluteMagnetisation = new Threedim[_numberMeasurements];
+	// no step values are stored
+	for (int i = 0; i < 3; ++i)
+	{
+		_statistics[i].clear();
+	}
 }
@@ -0,0 +1,279 @@
+/*
+* ClusterUpdate.cpp
+*
+* Copyright 2017 Julian Hagemeister
+*
+* This file is part of MonteCrystal.
+*
+* MonteCrystal is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* MonteCrystal is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with MonteCrystal.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include "ClusterUpdate.h"
+
+// forward and further includes
+#include "SpinOrientation.h"
+#include "SpinOrientationIsing.h"
+#include "Hamiltonian.h"
+#include "Energy.h"
+#include "ExchangeInteraction.h"
+#include "Metropolis.h"
+#include "RanGen.h"
+#include "MyMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+ClusterUpdate::ClusterUpdate(SpinOrientation* spinOrientation, int simulationSteps, double temperature,
+	QSharedPointer<Hamiltonian> hamilton, std::shared_ptr<RanGen> ranGen, int metropolisSweeps,
+	SimulationProgram* simulationProgram) :
+	SimulationMethod(spinOrientation, simulationSteps, temperature, hamilton, ranGen, simulationProgram)
+{
+	/**
+	* @param[in] spinOrientation Spin information (Ising or Heisenberg spins)
+	* @param[in] simulationSteps Number of simulation steps
+	* @param[in] temperature Initial temperature [K]
+	* @param[in] hamilton To calculate energies. Clusters are built over its ExchangeInteraction energies.
+	* @param[in] ranGen Pseudo random number generator
+	* @param[in] metropolisSweeps Metropolis sweeps per simulation step. At least one if the Hamiltonian
+	*            contains no exchange interaction.
+	* @param[in] simulationProgram Needed to trigger updates in graphical user interface
+	*/
+
+	std::vector<std::shared_ptr<Energy>> energies = hamilton->get_energies();
+	for (int i = 0; i < energies.size(); ++i)
+	{
+		auto exchange = std::dynamic_pointer_cast<ExchangeInteraction>(energies[i]);
+		if (exchange)
+		{
+			ExchangeBonds bonds;
+			bonds.neighborArray = exchange->get_neighbor_array();
+			bonds.nbors = exchange->get_nbors();
+			bonds.exchange = exchange;
+			_exchangeBonds.push_back(bonds);
+		}
+		else
+		{
+			_otherEnergies.push_back(energies[i]);
+		}
+	}
+
+	_metropolisSweeps = std::max(metropolisSweeps, 0);
+	if (_exchangeBonds.empty())
+	{
+		std::cout << "No exchange interaction for cluster updates. Only Metropolis sweeps are performed."
+			<< std::endl;
+		_metropolisSweeps = std::max(_metropolisSweeps, 1);
+	}
+	_metropolis = std::make_shared<Metropolis>(spinOrientation, simulationSteps, temperature, hamilton, ranGen,
+		simulationProgram);
+
+	_boolIsing = (dynamic_cast<SpinOrientationIsing*>(spinOrientation) != NULL) ? TRUE : FALSE;
+
+	int* activityList = spinOrientation->get_activity_list();
+	_activityList.assign(activityList, activityList + spinOrientation->get_number_atoms());
+	delete[] activityList;
+	_inCluster.assign(spinOrientation->get_number_atoms(), 0);
+
+	reset_statistics();
+}
+
+ClusterUpdate::~ClusterUpdate()
+{
+}
+
+double ClusterUpdate::simulation_step(void)
+{
+	/**
+	* Metropolis sweeps followed by cluster updates from random seed sites. The number of clusters is chosen
+	* such that the mean cluster size since the last temperature change times the number of clusters equals
+	* the number of active sites. It must not depend on the sizes of the clusters of the current step, which
+	* would bias the measurements.
+	*/
+
+	for (int i = 0; i < _metropolisSweeps; ++i)
+	{
+		_metropolis->simulation_step();
+	}
+
+	if (_exchangeBonds.empty() || _numberActiveSites == 0)
+	{
+		return 0;
+	}
+
+	int numberClusters = 1;
+	if (_numberClusters > 0)
+	{
+		numberClusters = std::max(1, (int)ceil(_numberActiveSites / get_mean_cluster_size()));
+	}
+	int numberFlipped = 0;
+	for (int i = 0; i < numberClusters; ++i)
+	{
+		int seed = _activeSites[_ranGen->IRandom(0, _numberActiveSites - 1)];
+		int boolAccepted = cluster_update(seed);
+		if (boolAccepted == TRUE)
+		{
+			numberFlipped += _cluster.size();
+		}
+	}
+	return (double)numberFlipped / _numberActiveSites;
+}
+
+int ClusterUpdate::cluster_update(int seed)
+{
+	/**
+	* Spins are projected onto a random axis (the x axis for Ising spins). A bond between a spin i of the
+	* cluster and an active neighbor j joins j to the cluster with probability
+	* 1 - exp(-2 J (S_i*r)(S_j*r) / (kB T)) if the exponent is negative. All spins of the cluster are then
+	* reflected, S -> S - 2 (S*r) r. The flip is accepted by the Metropolis criterion for the energy change of
+	* all other energies and of the exchange bonds to inactive sites; without these it is always accepted.
+	* The members _cluster and _numberClusters etc. are updated.
+	*
+	* @param[in] seed Active lattice site to start cluster from
+	*
+	* @return TRUE if the cluster was flipped
+	*/
+
+	Threedim* spinArray = _spinOrientation->get_spin_array();
+
+	// reflection axis
+	Threedim axis = { 1, 0, 0 };
+	if (_boolIsing == FALSE)
+	{
+		double value1 = 0;
+		double value2 = 0;
+		_ranGen->polar(value1, value2);
+		axis.x = value1;
+		axis.y = value2;
+		_ranGen->polar(value1, value2);
+		axis.z = value1;
+		axis = MyMath::normalize(axis);
+	}
+
+	// grow cluster
+	_cluster.clear();
+	_cluster.push_back(seed);
+	_inCluster[seed] = 1;
+	double deltaEnergy = 0; // energy change of bonds to inactive sites
+	for (int k = 0; k < _cluster.size(); ++k)
+	{
+		int position = _cluster[k];
+		Threedim spin = spinArray[position];
+		double projection = MyMath::dot_product(spin, axis);
+		Threedim change = MyMath::mult(axis, -2 * projection);
+		double beta = (_temperature[position] > 0) ? 1. / (kB * _temperature[position]) : HUGE_VAL;
+
+		for (int b = 0; b < _exchangeBonds.size(); ++b)
+		{
+			const ExchangeBonds &bonds = _exchangeBonds[b];
+			double energyParameter = bonds.exchange->get_energy_parameter();
+			const int* neighbors = bonds.neighborArray + bonds.nbors * position;
+			for (int n = 0; n < bonds.nbors; ++n)
+			{
+				int neighbor = neighbors[n];
+				if (neighbor == -1 || _inCluster[neighbor] == 1)
+				{
+					continue;
+				}
+				if (_activityList[neighbor] == 0)
+				{
+					deltaEnergy -= energyParameter * MyMath::dot_product(change, spinArray[neighbor]);
+					continue;
+				}
+				double coupling = energyParameter * projection
+					* MyMath::dot_product(spinArray[neighbor], axis);
+				if (coupling > 0 && _ranGen->Random() < -expm1(-2 * beta * coupling))
+				{
+					_inCluster[neighbor] = 1;
+					_cluster.push_back(neighbor);
+				}
+			}
+		}
+	}
+
+	// flip cluster; energy change of other energies evaluated spin by spin
+	for (int k = 0; k < _cluster.size(); ++k)
+	{
+		int position = _cluster[k];
+		Threedim oldSpin = spinArray[position];
+		Threedim newSpin = MyMath::normalize(MyMath::add(oldSpin,
+			MyMath::mult(axis, -2 * MyMath::dot_product(oldSpin, axis))));
+		for (int e = 0; e < _otherEnergies.size(); ++e)
+		{
+			deltaEnergy += _otherEnergies[e]->delta_energy(position, oldSpin, newSpin);
+		}
+		spinArray[position] = newSpin;
+		_hamilton->update_spin(position, oldSpin, newSpin);
+		_inCluster[position] = 0;
+	}
+
+	int boolAccepted = TRUE;
+	if (deltaEnergy > 0 && _ranGen->Random() > exp(-deltaEnergy / (_temperature[seed] * kB)))
+	{
+		// restore spins in reverse order
+		boolAccepted = FALSE;
+		for (int k = _cluster.size() - 1; k >= 0; --k)
+		{
+			int position = _cluster[k];
+			Threedim newSpin = spinArray[position];
+			Threedim oldSpin = MyMath::normalize(MyMath::add(newSpin,
+				MyMath::mult(axis, -2 * MyMath::dot_product(newSpin, axis))));
+			spinArray[position] = oldSpin;
+			_hamilton->update_spin(position, newSpin, oldSpin);
+		}
+	}
+
+	_clusterSizeSum += _cluster.size();
+	_numberClusters += 1;
+	_numberAcceptedClusters += boolAccepted;
+	return boolAccepted;
+}
+
+void ClusterUpdate::set_temperature(double temperature)
+{
+	SimulationMethod::set_temperature(temperature);
+	_metropolis->set_temperature(temperature);
+	reset_statistics();
+}
+
+void ClusterUpdate::set_temperature_gradient(double temperatureMin, double temperatureMax, Threedim direction,
+	Lattice* lattice)
+{
+	SimulationMethod::set_temperature_gradient(temperatureMin, temperatureMax, direction, lattice);
+	_metropolis->set_temperature_gradient(temperatureMin, temperatureMax, direction, lattice);
+	reset_statistics();
+}
+
+void ClusterUpdate::reset_statistics(void)
+{
+	_clusterSizeSum = 0;
+	_numberClusters = 0;
+	_numberAcceptedClusters = 0;
+}
+
+double ClusterUpdate::get_mean_cluster_size(void) const
+{
+	return (_numberClusters > 0) ? _clusterSizeSum / _numberClusters : 0;
+}
+
+double ClusterUpdate::get_cluster_acceptance(void) const
+{
+	return (_numberClusters > 0) ? (double)_numberAcceptedClusters / _numberClusters : 0;
+}
+
+int ClusterUpdate::get_number_clusters(void) const
+{
+	return _numberClusters;
+}
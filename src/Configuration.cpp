@@ -44,6 +44,9 @@ Configuration::Configuration()
 	_magneticMoment = 1;
 	_latticeConstant = 1; // lattice constant of respective material in Angstrom
 	_gaussianSpinSamplingSigma = 0;
+	_adaptiveConeAcceptance = 0;
+	_adaptiveConeSteps = 100;
+	_adaptiveConePerClass = FALSE;
 	
 	// spin parameters
 	_spinSystem = Heisenberg;
@@ -60,7 +63,10 @@ Configuration::Configuration()
 	_pseudoDipolarEnergy = 0;
 	_biQuadraticEnergy = 0;
 	_fourSpinEnergy = 0;
+	_threeSiteEnergy = 0;
 	_dipolEnergy = FALSE;
+	_dipolarMethod = dipolarAuto;
+	_dipolarOpeningAngle = 0.3;
 	_magneticField = { 0, 0, 1, { 0,0,1 } };
 	_magneticTip = { { 0,0,0 }, { 0,0,0 }, { 0,0,0 }, 0, 0, 0,};
 
@@ -68,18 +74,43 @@ Configuration::Configuration()
 	_LLG_dampingParameter = 0.1;
 	_LLG_timeWidth = 0.05; // [ps]
 
+	// parameters for energy minimization
+	_minimizerMemory = 5;
+	_clusterMetropolisSweeps = 1;
+
 	// LLG, Monte Carlo mutual parameters 
 	_seed = 10;
+	_randomGenerator = mersenneTwister;
 	_temperatureStart = 1;
 	_temperatureEnd = 1;
 	_temperatureSteps = 1;
 	_temperatureGradientDirection = { 0,0,0 };
 	_outputWidth = 1000;
 	_simulationSteps = 100000;
+	_parallelSweepThreads = 0;
+	_heatBathFraction = 0;
+	_overRelaxationSweeps = 0;
+	_sweepThreads = 0;
+	_replicaExchangeWidth = 10;
+	_gnebImages = 10;
+	_gnebThreads = 1;
+	_gnebSpringConstant = 1;
+	_gnebTimeStep = 0.1;
+	_gnebClimbingImage = TRUE;
+	_fusedPairField = FALSE;
 
 	_numEigenStates = 0;
 	
 	// parameters for output configuration
+	_spinFileFormat = spinFileText;
+	_outputBuffers = 4;
+	_accumulateObservables = FALSE;
+	_errorAnalysis = FALSE;
+	_targetRelativeError = 0;
+	_convergenceTorque = 0;
+	_convergenceEnergy = 0;
+	_convergenceChecks = 3;
+	_convergenceWidth = 10;
 	_movieStart = -1;
 	_movieEnd = -1;
 	_movieWidth = 0;
@@ -103,6 +134,12 @@ std::string Configuration::all_parameters(void) const
 	case landauLifshitzGilbert:
 		_allParameters.append(" Simulation type: Landau-Lifshitz-Gilbert");
 		break;
+	case energyMinimizer:
+		_allParameters.append(" Simulation type: L-BFGS energy minimization");
+		break;
+	case clusterUpdate:
+		_allParameters.append(" Simulation type: Wolff cluster updates");
+		break;
 	}
 
 	switch (_programType)
@@ -122,6 +159,12 @@ std::string Configuration::all_parameters(void) const
 	case latticeSiteWindingNumber:
 		_allParameters.append(" Program type: lattice site winding number");
 		break;
+	case parallelTempering:
+		_allParameters.append(" Program type: parallel tempering");
+		break;
+	case geodesicNudgedElasticBand:
+		_allParameters.append(" Program type: geodesic nudged elastic band");
+		break;
 	}
 
 	_allParameters.append("   Lattice type:");
@@ -210,6 +253,11 @@ std::string Configuration::all_parameters(void) const
 	else
 	{
 		_allParameters.append("enabled, sigma: " + std::to_string(_gaussianSpinSamplingSigma));
+		if (_adaptiveConeAcceptance > 0)
+		{
+			_allParameters.append(" adapted to acceptance " + std::to_string(_adaptiveConeAcceptance) 
+				+ " in " + std::to_string(_adaptiveConeSteps) + " steps");
+		}
 	}
 	_allParameters.append("\n");
 
@@ -277,6 +325,18 @@ std::string Configuration::all_parameters(void) const
 	if (_dipolEnergy == TRUE)
 	{
 		_allParameters.append("   Dipol energy");
+		if (_dipolarMethod == dipolarDirect)
+		{
+			_allParameters.append(" (direct summation)");
+		}
+		else if (_dipolarMethod == dipolarFFT)
+		{
+			_allParameters.append(" (FFT)");
+		}
+		else if (_dipolarMethod == dipolarTree)
+		{
+			_allParameters.append(" (octree, opening angle " + std::to_string(_dipolarOpeningAngle) + ")");
+		}
 	}
 
 	for (int i = 0; i < _modulatedExchangeEnergies.size(); ++i)
@@ -381,15 +441,57 @@ std::string Configuration::all_parameters(void) const
 	{
 		_allParameters.append("damping parameter: " + std::to_string(_LLG_dampingParameter));
 		_allParameters.append("time step width: " + std::to_string(_LLG_timeWidth));
+		if (_fusedPairField == TRUE)
+		{
+			_allParameters.append("   fused pair interaction field");
+		}
+	}
+
+	if (_simulationType == energyMinimizer)
+	{
+		_allParameters.append("L-BFGS memory: " + std::to_string(_minimizerMemory));
+	}
+	if (_simulationType == clusterUpdate)
+	{
+		_allParameters.append("Metropolis sweeps per step: " + std::to_string(_clusterMetropolisSweeps));
 	}
 
 	_allParameters.append("seed: " + std::to_string(_seed));
+	if (_randomGenerator == philoxGenerator)
+	{
+		_allParameters.append("   random numbers: Philox4x32-10");
+	}
 	_allParameters.append("   Simulation steps: " + std::to_string(_simulationSteps));
 	_allParameters.append(" Output width: " + std::to_string(_outputWidth));
+	if (_simulationType == metropolis && _parallelSweepThreads > 0)
+	{
+		_allParameters.append("   Parallel sweep threads: " + std::to_string(_parallelSweepThreads));
+	}
+	if (_simulationType == metropolis && _spinSystem == Heisenberg
+		&& (_heatBathFraction > 0 || _overRelaxationSweeps > 0))
+	{
+		_allParameters.append("   Heat-bath fraction: " + std::to_string(_heatBathFraction));
+		_allParameters.append(" Over-relaxation sweeps: " + std::to_string(_overRelaxationSweeps));
+	}
 
 	_allParameters.append("   temperature start: " + std::to_string(_temperatureStart));
 	_allParameters.append(" temperature end: " + std::to_string(_temperatureEnd));
 	_allParameters.append(" temperature steps: " + std::to_string(_temperatureSteps));
+	if (_programType == temperatureMagneticFieldLoop && _sweepThreads > 0)
+	{
+		_allParameters.append("   Independent points with threads: " + std::to_string(_sweepThreads));
+	}
+	if (_programType == parallelTempering)
+	{
+		_allParameters.append("   Replica exchange width: " + std::to_string(_replicaExchangeWidth));
+	}
+	if (_programType == geodesicNudgedElasticBand)
+	{
+		_allParameters.append("   GNEB from " + _gnebInitialFname + " to " + _gnebFinalFname + " images: "
+			+ std::to_string(_gnebImages) + " threads: " + std::to_string(_gnebThreads) + " spring constant: "
+			+ std::to_string(_gnebSpringConstant) + " time step: " + std::to_string(_gnebTimeStep)
+			+ ((_gnebClimbingImage == TRUE) ? " climbing image" : ""));
+	}
 
 	if (_programType == spinSeebeck)
 	{
@@ -408,6 +510,20 @@ std::string Configuration::all_parameters(void) const
 
 	_allParameters.append("   Movie: start " + std::to_string(_movieStart) + " end " + std::to_string(_movieEnd)
 		+ " width " + std::to_string(_movieWidth));
+
+	switch (_spinFileFormat)
+	{
+	case spinFileFloat32:
+		_allParameters.append("   spin files: binary float32");
+		break;
+	case spinFileFloat64:
+		_allParameters.append("   spin files: binary float64");
+		break;
+	}
+	if (_outputBuffers > 0)
+	{
+		_allParameters.append("   writer thread buffers " + std::to_string(_outputBuffers));
+	}
 	
 	if (_doSimulationStepsOutput)
 	{
@@ -439,6 +555,28 @@ std::string Configuration::all_parameters(void) const
 		_allParameters.append("   winding_number ");
 	}
 
+	if (_accumulateObservables == TRUE)
+	{
+		_allParameters.append("   accumulated observables ");
+	}
+
+	if (_errorAnalysis == TRUE)
+	{
+		_allParameters.append("   error analysis ");
+	}
+
+	if (_targetRelativeError > 0)
+	{
+		_allParameters.append("\n   Stop at relative error " + std::to_string(_targetRelativeError));
+	}
+
+	if (_convergenceTorque > 0 || _convergenceEnergy > 0)
+	{
+		_allParameters.append("\n   Stop at convergence " + std::to_string(_convergenceTorque) + " "
+			+ std::to_string(_convergenceEnergy) + " meV (" + std::to_string(_convergenceChecks) + " checks every "
+			+ std::to_string(_convergenceWidth) + " steps)");
+	}
+
 	return _allParameters;
 }
 
@@ -464,3 +602,514 @@ void Configuration::determine_outputfolder_needed(void)
 		_doOutput = true;
 	}
 }
+
+int Configuration::read_configuration_file(std::string fname)
+{
+	/**
+	* Read simulation parameters from a text file. Each line holds a keyword followed by its values separated
+	* by white space. Text following a '#' is ignored. Parameters that are not specified keep their default
+	* values. Keywords that may occur multiple times (e.g. "exchange") append a further energy term.
+	* Magnetic fields are specified in [T] and converted with the magnetic moment as done by the GUI.
+	*
+	* Example:
+	*   simulation_type metropolis
+	*   program_type temperature_magnetic_field_loop
+	*   lattice_type triangular_hexagonal
+	*   lattice_dimensions 30
+	*   exchange 1 1.0        # order energyParameter[meV]
+	*   dm 1 0.3              # order energyParameter[meV]
+	*   uniaxial_anisotropy 0.1 0 0 1
+	*   dipolar 1 auto        # method auto, direct, fft or tree [opening angle]
+	*   magnetic_field 2 2 1 0 0 1   # start[T] end[T] steps direction
+	*   temperature 10 1 10   # start end steps [K]
+	*   parallel_sweep 8      # threads for parallel Metropolis sweep
+	*   adaptive_cone 0.5 200 1      # gaussian_sigma > 0: target acceptance, equilibration steps [per class];
+	*                                #   equilibration steps precede the measured simulation_steps
+	*   heat_bath 1           # fraction of heat-bath instead of Metropolis trial steps (Heisenberg spins)
+	*   over_relaxation 2     # over-relaxation sweeps per Metropolis step (Heisenberg spins)
+	*   sweep_threads 8       # temperature and magnetic field points independently in parallel threads
+	*   replica_exchange_width 10   # program_type parallel_tempering: steps between replica exchanges
+	*   gneb initial.dat final.dat 10 4   # program_type gneb: end points [images] [threads]
+	*                                     #   stops early only with convergence_stop torque > 0
+	*   gneb_spring 1         # spring constant between images [meV]
+	*   gneb_time_step 0.1    # time step of velocity projection optimization
+	*   gneb_climbing_image 1 # refine image of highest energy to saddle point
+	*   fused_pair_field 1    # fused pair interaction field kernel (LLG, Converger1, minimizer)
+	*   minimizer_memory 5    # simulation_type minimizer: previous steps used by L-BFGS
+	*   cluster_metropolis_sweeps 1  # simulation_type cluster: Metropolis sweeps per step
+	*   random_generator philox      # mersenne or philox (counter-based, see PhiloxRanGen)
+	*   output energy magnetization
+	*   spin_file_format float32     # text, float32 or float64 (binary, see SpinConfigurationFile)
+	*   output_buffers 4      # pending output files of writer thread; 0 writes in simulation thread
+	*   accumulate_observables 1     # running mean values instead of storing all measurements of a run
+	*   error_analysis 1      # errors and autocorrelation times of mean values
+	*   target_relative_error 1e-4   # end run at this relative error of the mean energy
+	*   convergence_stop 1e-6 0 3 10   # torque [energy change per site, meV] [consecutive checks] [width]
+	*                                  #   simulation_type llg, converger1 and minimizer only
+	*
+	* @param[in] fname Name of configuration file.
+	*
+	* @return TRUE if file was read successfully, FALSE otherwise.
+	*/
+
+	std::ifstream filestr(fname);
+	if (!filestr.is_open())
+	{
+		std::cout << "Configuration file " << fname << " could not be opened." << std::endl;
+		return FALSE;
+	}
+
+	// magnetic field in [T]; converted after magnetic moment is known
+	MagneticFieldStruct magneticFieldTesla = _magneticField;
+	magneticFieldTesla.start /= _magneticMoment*muBohr;
+	magneticFieldTesla.end /= _magneticMoment*muBohr;
+
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(filestr, line))
+	{
+		++lineNumber;
+		line = line.substr(0, line.find('#'));
+
+		std::istringstream lineStream(line);
+		std::string key;
+		if (!(lineStream >> key))
+		{
+			// empty line or comment
+			continue;
+		}
+
+		std::string value;
+		if (key.compare("simulation_type") == 0)
+		{
+			lineStream >> value;
+			if (value.compare("metropolis") == 0) _simulationType = metropolis;
+			else if (value.compare("llg") == 0) _simulationType = landauLifshitzGilbert;
+			else if (value.compare("converger1") == 0) _simulationType = converger1;
+			else if (value.compare("minimizer") == 0) _simulationType = energyMinimizer;
+			else if (value.compare("cluster") == 0) _simulationType = clusterUpdate;
+			else value.clear();
+		}
+		else if (key.compare("program_type") == 0)
+		{
+			lineStream >> value;
+			if (value.compare("temperature_magnetic_field_loop") == 0) _programType = temperatureMagneticFieldLoop;
+			else if (value.compare("spin_seebeck") == 0) _programType = spinSeebeck;
+			else if (value.compare("tip_movement") == 0) _programType = tipMovement;
+			else if (value.compare("lattice_site_energies") == 0) _programType = latticeSiteEnergies;
+			else if (value.compare("lattice_site_winding_number") == 0) _programType = latticeSiteWindingNumber;
+			else if (value.compare("experiment01") == 0) _programType = Experiment01;
+			else if (value.compare("eigen_frequency") == 0) _programType = EigenFrequency;
+			else if (value.compare("read_lattice_configuration") == 0) _programType = readLatticeConfiguration;
+			else if (value.compare("read_spin_configuration") == 0) _programType = readSpinConfiguration;
+			else if (value.compare("save_lattice_configuration") == 0) _programType = saveLatticeConfiguration;
+			else if (value.compare("save_spin_configuration") == 0) _programType = saveSpinConfiguration;
+			else if (value.compare("lattice_mask_read") == 0) _programType = latticeMaskRead;
+			else if (value.compare("parallel_tempering") == 0) _programType = parallelTempering;
+			else if (value.compare("gneb") == 0) _programType = geodesicNudgedElasticBand;
+			else value.clear();
+		}
+		else if (key.compare("lattice_type") == 0)
+		{
+			lineStream >> value;
+			if (value.compare("simple_cubic") == 0) _latticeType = simpleCubic;
+			else if (value.compare("body_centered_cubic") == 0) _latticeType = bodyCenteredCubic;
+			else if (value.compare("face_centered_cubic") == 0) _latticeType = faceCenteredCubic;
+			else if (value.compare("triangular_hexagonal") == 0) _latticeType = triangularHexagonal;
+			else if (value.compare("triangular_triangular") == 0) _latticeType = triangularTriangular;
+			else if (value.compare("triangular_half_disk") == 0) _latticeType = triangularHalfDisk;
+			else if (value.compare("triangular_disk") == 0) _latticeType = triangularDisk;
+			else if (value.compare("triangular_arrow_head") == 0) _latticeType = triangularArrowHead;
+			else if (value.compare("triangular_stripe") == 0) _latticeType = triangularStripe;
+			else value.clear();
+		}
+		else if (key.compare("lattice_dimensions") == 0)
+		{
+			_latticeDimensions.clear();
+			int dimension = 0;
+			while (lineStream >> dimension)
+			{
+				_latticeDimensions.push_back(dimension);
+			}
+			value = "ok";
+		}
+		else if (key.compare("miller_indexes") == 0)
+		{
+			if (lineStream >> _millerIndexes[0] >> _millerIndexes[1] >> _millerIndexes[2]) value = "ok";
+		}
+		else if (key.compare("boundary_conditions") == 0)
+		{
+			lineStream >> value;
+			if (value.compare("open") == 0) _boundaryConditions = openBound;
+			else if (value.compare("helical") == 0) _boundaryConditions = helical;
+			else if (value.compare("periodic") == 0) _boundaryConditions = periodic;
+			else if (value.compare("periodic_x") == 0) _boundaryConditions = periodicX;
+			else if (value.compare("periodic_y") == 0) _boundaryConditions = periodicY;
+			else value.clear();
+		}
+		else if (key.compare("lattice_constant") == 0)
+		{
+			if (lineStream >> _latticeConstant) value = "ok";
+		}
+		else if (key.compare("magnetic_moment") == 0)
+		{
+			if (lineStream >> _magneticMoment) value = "ok";
+		}
+		else if (key.compare("lattice_mask") == 0)
+		{
+			std::string maskType;
+			if (lineStream >> _latticeMaskParameters.fname >> maskType >> _latticeMaskParameters.width
+				>> _latticeMaskParameters.height)
+			{
+				value = "ok";
+				if (maskType.compare("square") == 0) _latticeMaskParameters.latticeType = squareLattice;
+				else if (maskType.compare("hexagonal") == 0) _latticeMaskParameters.latticeType = hexagonalLattice;
+				else value.clear();
+			}
+		}
+		else if (key.compare("spin_type") == 0)
+		{
+			lineStream >> value;
+			if (value.compare("heisenberg") == 0) _spinSystem = Heisenberg;
+			else if (value.compare("ising") == 0) _spinSystem = Ising;
+			else value.clear();
+		}
+		else if (key.compare("initial_spiral") == 0)
+		{
+			if (lineStream >> _initialSpiralR.x >> _initialSpiralR.y >> _initialSpiralR.z
+				>> _initialSpiralI.x >> _initialSpiralI.y >> _initialSpiralI.z
+				>> _initialSpiralek.x >> _initialSpiralek.y >> _initialSpiralek.z >> _initialSpiralLambda)
+			{
+				value = "ok";
+			}
+		}
+		else if (key.compare("gaussian_sigma") == 0)
+		{
+			if (lineStream >> _gaussianSpinSamplingSigma) value = "ok";
+		}
+		else if (key.compare("exchange") == 0)
+		{
+			ExchangeEnergyStruct exchange;
+			if (lineStream >> exchange.order >> exchange.energyParameter)
+			{
+				_exchangeEnergies.push_back(exchange);
+				value = "ok";
+			}
+		}
+		else if (key.compare("dm") == 0)
+		{
+			ExchangeEnergyStruct dm;
+			if (lineStream >> dm.order >> dm.energyParameter)
+			{
+				_DMEnergies.push_back(dm);
+				value = "ok";
+			}
+		}
+		else if (key.compare("dm_type") == 0)
+		{
+			lineStream >> value;
+			if (value.compare("neel") == 0) _dmType = Neel;
+			else if (value.compare("chiral") == 0) _dmType = Chiral;
+			else value.clear();
+		}
+		else if (key.compare("pseudo_dipolar") == 0)
+		{
+			if (lineStream >> _pseudoDipolarEnergy) value = "ok";
+		}
+		else if (key.compare("biquadratic") == 0)
+		{
+			if (lineStream >> _biQuadraticEnergy) value = "ok";
+		}
+		else if (key.compare("four_spin") == 0)
+		{
+			if (lineStream >> _fourSpinEnergy) value = "ok";
+		}
+		else if (key.compare("three_site") == 0)
+		{
+			if (lineStream >> _threeSiteEnergy) value = "ok";
+		}
+		else if (key.compare("uniaxial_anisotropy") == 0)
+		{
+			UniaxialAnisotropyStruct anisotropy;
+			if (lineStream >> anisotropy.energyParameter >> anisotropy.direction.x >> anisotropy.direction.y
+				>> anisotropy.direction.z)
+			{
+				_uniaxialAnisotropyEnergies.push_back(anisotropy);
+				value = "ok";
+			}
+		}
+		else if (key.compare("hexagonal_anisotropy") == 0)
+		{
+			if (lineStream >> _hexagonalAnisotropyEnergies[0] >> _hexagonalAnisotropyEnergies[1]
+				>> _hexagonalAnisotropyEnergies[2])
+			{
+				value = "ok";
+			}
+		}
+		else if (key.compare("dipolar") == 0)
+		{
+			if (lineStream >> _dipolEnergy)
+			{
+				value = "ok";
+				std::string method;
+				if (lineStream >> method)
+				{
+					if (method.compare("auto") == 0) _dipolarMethod = dipolarAuto;
+					else if (method.compare("direct") == 0) _dipolarMethod = dipolarDirect;
+					else if (method.compare("fft") == 0) _dipolarMethod = dipolarFFT;
+					else if (method.compare("tree") == 0)
+					{
+						_dipolarMethod = dipolarTree;
+						lineStream >> _dipolarOpeningAngle;
+					}
+					else value.clear();
+				}
+			}
+		}
+		else if (key.compare("modulated_exchange") == 0)
+		{
+			ModulatedExchangeEnergyStruct modulated;
+			if (lineStream >> modulated.Jx >> modulated.Jy >> modulated.lambda >> modulated.alpha
+				>> modulated.modulationNumber)
+			{
+				_modulatedExchangeEnergies.push_back(modulated);
+				value = "ok";
+			}
+		}
+		else if (key.compare("modulated_anisotropy") == 0)
+		{
+			ModulatedAnisotropyEnergyStruct modulated;
+			if (lineStream >> modulated.energyParameter >> modulated.lambda >> modulated.width
+				>> modulated.direction.x >> modulated.direction.y >> modulated.direction.z
+				>> modulated.modulationNumber)
+			{
+				_modulatedAnisotropyEnergies.push_back(modulated);
+				value = "ok";
+			}
+		}
+		else if (key.compare("magnetic_field") == 0)
+		{
+			if (lineStream >> magneticFieldTesla.start >> magneticFieldTesla.end >> magneticFieldTesla.steps
+				>> magneticFieldTesla.direction.x >> magneticFieldTesla.direction.y
+				>> magneticFieldTesla.direction.z)
+			{
+				value = "ok";
+			}
+		}
+		else if (key.compare("magnetic_tip") == 0)
+		{
+			if (lineStream >> _magneticTip.energyParameter >> _magneticTip.magnetizationDirection.x
+				>> _magneticTip.magnetizationDirection.y >> _magneticTip.magnetizationDirection.z
+				>> _magneticTip.start.x >> _magneticTip.start.y >> _magneticTip.start.z
+				>> _magneticTip.end.x >> _magneticTip.end.y >> _magneticTip.end.z
+				>> _magneticTip.steps >> _magneticTip.stepWidth)
+			{
+				value = "ok";
+			}
+		}
+		else if (key.compare("llg_damping") == 0)
+		{
+			if (lineStream >> _LLG_dampingParameter) value = "ok";
+		}
+		else if (key.compare("llg_time_width") == 0)
+		{
+			if (lineStream >> _LLG_timeWidth) value = "ok";
+		}
+		else if (key.compare("minimizer_memory") == 0)
+		{
+			if (lineStream >> _minimizerMemory) value = "ok";
+		}
+		else if (key.compare("cluster_metropolis_sweeps") == 0)
+		{
+			if (lineStream >> _clusterMetropolisSweeps) value = "ok";
+		}
+		else if (key.compare("seed") == 0)
+		{
+			if (lineStream >> _seed) value = "ok";
+		}
+		else if (key.compare("random_generator") == 0)
+		{
+			lineStream >> value;
+			if (value.compare("mersenne") == 0) _randomGenerator = mersenneTwister;
+			else if (value.compare("philox") == 0) _randomGenerator = philoxGenerator;
+			else value.clear();
+		}
+		else if (key.compare("temperature") == 0)
+		{
+			if (lineStream >> _temperatureStart >> _temperatureEnd >> _temperatureSteps) value = "ok";
+		}
+		else if (key.compare("temperature_gradient_direction") == 0)
+		{
+			if (lineStream >> _temperatureGradientDirection.x >> _temperatureGradientDirection.y
+				>> _temperatureGradientDirection.z)
+			{
+				value = "ok";
+			}
+		}
+		else if (key.compare("simulation_steps") == 0)
+		{
+			if (lineStream >> _simulationSteps) value = "ok";
+		}
+		else if (key.compare("parallel_sweep") == 0)
+		{
+			if (lineStream >> _parallelSweepThreads) value = "ok";
+		}
+		else if (key.compare("adaptive_cone") == 0)
+		{
+			if (lineStream >> _adaptiveConeAcceptance >> _adaptiveConeSteps)
+			{
+				value = "ok";
+				lineStream >> _adaptiveConePerClass;
+			}
+		}
+		else if (key.compare("heat_bath") == 0)
+		{
+			if (lineStream >> _heatBathFraction) value = "ok";
+		}
+		else if (key.compare("over_relaxation") == 0)
+		{
+			if (lineStream >> _overRelaxationSweeps) value = "ok";
+		}
+		else if (key.compare("sweep_threads") == 0)
+		{
+			if (lineStream >> _sweepThreads) value = "ok";
+		}
+		else if (key.compare("replica_exchange_width") == 0)
+		{
+			if (lineStream >> _replicaExchangeWidth) value = "ok";
+		}
+		else if (key.compare("gneb") == 0)
+		{
+			if (lineStream >> _gnebInitialFname >> _gnebFinalFname)
+			{
+				value = "ok";
+				lineStream >> _gnebImages >> _gnebThreads;
+			}
+		}
+		else if (key.compare("gneb_spring") == 0)
+		{
+			if (lineStream >> _gnebSpringConstant) value = "ok";
+		}
+		else if (key.compare("gneb_time_step") == 0)
+		{
+			if (lineStream >> _gnebTimeStep) value = "ok";
+		}
+		else if (key.compare("gneb_climbing_image") == 0)
+		{
+			if (lineStream >> _gnebClimbingImage) value = "ok";
+		}
+		else if (key.compare("fused_pair_field") == 0)
+		{
+			if (lineStream >> _fusedPairField) value = "ok";
+		}
+		else if (key.compare("output_width") == 0)
+		{
+			if (lineStream >> _outputWidth) value = "ok";
+		}
+		else if (key.compare("eigen_states") == 0)
+		{
+			if (lineStream >> _numEigenStates) value = "ok";
+		}
+		else if (key.compare("experiment01_frequency") == 0)
+		{
+			if (lineStream >> _experiment01.freq) value = "ok";
+		}
+		else if (key.compare("output") == 0)
+		{
+			value = "ok";
+			std::string output;
+			while (lineStream >> output)
+			{
+				if (output.compare("spin_configuration") == 0) _doSpinConfigOutput = true;
+				else if (output.compare("simulation_steps") == 0) _doSimulationStepsOutput = true;
+				else if (output.compare("energy") == 0) _doEnergyOutput = true;
+				else if (output.compare("magnetization") == 0) _doMagnetisationOutput = true;
+				else if (output.compare("absolute_magnetization") == 0) _doAbsoluteMagnetisationOutput = true;
+				else if (output.compare("ncmr") == 0) _doNCMROutput = true;
+				else if (output.compare("each_spin") == 0) _doSpinResolvedOutput = true;
+				else if (output.compare("winding_number") == 0) _doWindingNumberOutput = true;
+				else value.clear();
+			}
+		}
+		else if (key.compare("spin_file_format") == 0)
+		{
+			lineStream >> value;
+			if (value.compare("text") == 0) _spinFileFormat = spinFileText;
+			else if (value.compare("float32") == 0) _spinFileFormat = spinFileFloat32;
+			else if (value.compare("float64") == 0) _spinFileFormat = spinFileFloat64;
+			else value.clear();
+		}
+		else if (key.compare("error_analysis") == 0)
+		{
+			if (lineStream >> _errorAnalysis) value = "ok";
+		}
+		else if (key.compare("target_relative_error") == 0)
+		{
+			if (lineStream >> _targetRelativeError) value = "ok";
+		}
+		else if (key.compare("convergence_stop") == 0)
+		{
+			if (lineStream >> _convergenceTorque)
+			{
+				value = "ok";
+				lineStream >> _convergenceEnergy >> _convergenceChecks >> _convergenceWidth;
+			}
+		}
+		else if (key.compare("accumulate_observables") == 0)
+		{
+			if (lineStream >> _accumulateObservables) value = "ok";
+		}
+		else if (key.compare("output_buffers") == 0)
+		{
+			if (lineStream >> _outputBuffers) value = "ok";
+		}
+		else if (key.compare("movie") == 0)
+		{
+			if (lineStream >> _movieStart >> _movieEnd >> _movieWidth) value = "ok";
+		}
+		else if (key.compare("storage_fname") == 0)
+		{
+			if (lineStream >> _storageFname) value = "ok";
+		}
+		else if (key.compare("ui_update_width") == 0)
+		{
+			if (lineStream >> _uiUpdateWidth) value = "ok";
+		}
+
+		if (value.empty())
+		{
+			std::cout << "Configuration file " << fname << ", line " << lineNumber 
+				<< ": could not interpret \"" << line << "\"" << std::endl;
+			return FALSE;
+		}
+	}
+	filestr.close();
+
+	// convert magnetic field from [T] to [meV]
+	magneticFieldTesla.start *= _magneticMoment*muBohr;
+	magneticFieldTesla.end *= _magneticMoment*muBohr;
+	_magneticField = magneticFieldTesla;
+
+	_configurationFname = fname;
+
+	return TRUE;
+}
+
+void Configuration::copy_configuration_file(std::string fname)
+{
+	/**
+	* Copy the configuration file the parameters were read from. Nothing is done if the simulation was
+	* set up by the GUI.
+	*
+	* @param[in] fname Name of the copy.
+	*/
+
+	if (_configurationFname.empty())
+	{
+		return;
+	}
+
+	std::ifstream source(_configurationFname, std::ios::binary);
+	std::ofstream destination(fname, std::ios::binary);
+	destination << source.rdbuf();
+}
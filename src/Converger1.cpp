@@ -65,14 +65,17 @@ double Converger1::simulation_step(void)
 
 		if (_boolConvergenceCriterion == TRUE)
 		{
-			double norm = MyMath::norm(MyMath::vector_product(spinArray[position], effectiveFieldDir));
-			if (convergenceCriterion < norm)
+			// squared torque; square root is taken once after the loop
+			Threedim torque = MyMath::vector_product(spinArray[position], effectiveFieldDir);
+			double norm2 = MyMath::dot_product(torque, torque);
+			if (convergenceCriterion < norm2)
 			{
-				convergenceCriterion = norm;
+				convergenceCriterion = norm2;
 			}
 		}
+		_hamilton->update_spin(position, spinArray[position], effectiveFieldDir);
 		spinArray[position] = effectiveFieldDir;
 	}
 
-	return convergenceCriterion;
+	return sqrt(convergenceCriterion);
 }
\ No newline at end of file
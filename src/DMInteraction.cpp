@@ -99,6 +99,31 @@ Threedim DMInteraction::effective_field(const int &position) const
 	return MyMath::mult(field,-1*_energyParameter);
 }
 
+double DMInteraction::delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const
+{
+	return -MyMath::dot_product(MyMath::difference(newSpin, oldSpin), effective_field(position));
+}
+
+int DMInteraction::linear_in_spin(void) const
+{
+	return TRUE;
+}
+
+int DMInteraction::pair_couplings(const int &position, std::vector<int> &partners, 
+	std::vector<ThreedimMatrix> &couplings) const
+{
+	int index = _nbors * position;
+	for (int i = 0; i < _nbors; ++i)
+	{
+		if (_neighborArray[index + i] != -1) // -1 refers to empty entry
+		{
+			partners.push_back(_neighborArray[index + i]);
+			couplings.push_back(MyMath::cross_product_matrix(_DMVectors[index + i], -1 * _energyParameter));
+		}
+	}
+	return TRUE;
+}
+
 int DMInteraction::get_nbors(void) const
 {
 	return _nbors;
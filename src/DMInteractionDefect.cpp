@@ -102,6 +102,34 @@ Threedim DMInteractionDefect::effective_field(const int &position) const
 	return MyMath::mult(field, -1);
 }
 
+double DMInteractionDefect::delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const
+{
+	return -MyMath::dot_product(MyMath::difference(newSpin, oldSpin), effective_field(position));
+}
+
+int DMInteractionDefect::linear_in_spin(void) const
+{
+	return TRUE;
+}
+
+int DMInteractionDefect::pair_couplings(const int &position, std::vector<int> &partners, 
+	std::vector<ThreedimMatrix> &couplings) const
+{
+	if (_dmVectors.count(position) != 0)
+	{
+		int index = _nbors * position;
+		for (int i = 0; i < _nbors; ++i)
+		{
+			if (_neighborArray[index + i] != -1) // -1 refers to empty entry
+			{
+				partners.push_back(_neighborArray[index + i]);
+				couplings.push_back(MyMath::cross_product_matrix(_dmVectors.at(position)[i], -1));
+			}
+		}
+	}
+	return TRUE;
+}
+
 void DMInteractionDefect::set_DM_vectors(const std::unordered_map<int, double> &defects, Lattice* lattice)
 {
 	/**
@@ -25,7 +25,6 @@
 // forward and further includes
 #include "Lattice.h"
 #include "MyMath.h"
-#include <omp.h>
 
 DipolarInteraction::DipolarInteraction(Threedim* spinArray, double magneticMoment, double latticeConstant, 
 	Lattice* lattice):
@@ -73,7 +72,6 @@ DipolarInteraction::~DipolarInteraction()
 double DipolarInteraction::single_energy(const int &position) const
 {
 	double energy = 0;
-	omp_set_num_threads(2);
 #pragma omp parallel for reduction(+:energy)
 	for (int i = 0; i < _numberAtoms - 1; ++i)
 	{
@@ -103,6 +101,37 @@ Threedim DipolarInteraction::effective_field(const int &position) const
 	return field;
 }
 
+double DipolarInteraction::delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const
+{
+	return -MyMath::dot_product(MyMath::difference(newSpin, oldSpin), effective_field(position));
+}
+
+int DipolarInteraction::linear_in_spin(void) const
+{
+	return TRUE;
+}
+
+int DipolarInteraction::hessian_blocks(const int &position, ThreedimMatrix &onSite, std::vector<int> &partners,
+	std::vector<ThreedimMatrix> &blocks) const
+{
+	/**
+	* One block for each other spin, prefactor (1 - 3 r r^T) / r^3. The spin wave matrix is therefore dense.
+	*/
+
+	for (int i = 0; i < _numberAtoms - 1; i++)
+	{
+		double factor = _prefactor * _distanceArray[position][i];
+		ThreedimMatrix block = MyMath::outer_product(_distanceVectors[position][i], _distanceVectors[position][i],
+			-3 * factor);
+		block.x.x += factor;
+		block.y.y += factor;
+		block.z.z += factor;
+		partners.push_back(_indexArray[position][i]);
+		blocks.push_back(block);
+	}
+	return TRUE;
+}
+
 void DipolarInteraction::setup_distance_array(Lattice* lattice)
 {
 	_distanceArray = new double*[_numberAtoms];
@@ -0,0 +1,451 @@
+/*
+* DipolarInteractionFFT.cpp
+*
+* Copyright 2017 Julian Hagemeister
+*
+* This file is part of MonteCrystal.
+*
+* MonteCrystal is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* MonteCrystal is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with MonteCrystal.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include "DipolarInteractionFFT.h"
+
+// forward and further includes
+#include "Lattice.h"
+#include "MyMath.h"
+
+#include <algorithm>
+#include <iostream>
+
+DipolarInteractionFFT::DipolarInteractionFFT(Threedim* spinArray, double magneticMoment,
+	double latticeConstant, Lattice* lattice):
+	Energy(0.5, "E_Dipol ", spinArray, 1)
+{
+	/**
+	* The lattice has to fulfill lattice_on_grid(lattice). Otherwise, use DipolarInteraction.
+	*
+	* @param[in] spinArray Pointer to spin configuration.
+	* @param[in] magneticMoment Magnetic moment of single spin as multiples of Bohr magneton
+	* @param[in] latticeConstant Lattice constant of the lattice in [Angstrom]
+	* @param[in] lattice Lattice object containing all information about lattice configuration
+	*/
+
+	_numberAtoms = lattice->get_number_atoms();
+	// same prefactor as in DipolarInteraction
+	_prefactor = 9.27401 * 9.27401 * pow(magneticMoment, 2) / (1000 * 1.602 * pow(latticeConstant, 3));
+	_gridCoordinates = new int[3 * _numberAtoms];
+	_gridIndex = new int[_numberAtoms];
+
+	setup_grid(lattice);
+	setup_tensor();
+}
+
+DipolarInteractionFFT::~DipolarInteractionFFT()
+{
+	delete[] _gridCoordinates;
+	delete[] _gridIndex;
+}
+
+int DipolarInteractionFFT::lattice_on_grid(Lattice* lattice)
+{
+	/**
+	* @param[in] lattice Lattice object
+	*
+	* @return TRUE if the lattice sites lie on a regular grid, FALSE otherwise
+	*/
+
+	Threedim gridVectors[3];
+	int* gridCoordinates = new int[3 * lattice->get_number_atoms()];
+	int onGrid = find_grid(lattice, gridCoordinates, gridVectors);
+	delete[] gridCoordinates;
+	return onGrid;
+}
+
+int DipolarInteractionFFT::find_grid(Lattice* lattice, int* gridCoordinates, Threedim* gridVectors)
+{
+	/**
+	* Grid vectors are chosen as the three shortest linearly independent neighbor vectors. All lattice sites
+	* have to be integer combinations of these vectors relative to the first lattice site. For planar
+	* lattices, the third grid vector is perpendicular to the lattice plane.
+	*
+	* @param[in] lattice Lattice object
+	* @param[out] gridCoordinates Integer coordinates of lattice sites; size 3*number of atoms
+	* @param[out] gridVectors Three grid vectors
+	*
+	* @return TRUE if the lattice sites lie on a regular grid, FALSE otherwise
+	*/
+
+	int numberAtoms = lattice->get_number_atoms();
+	Threedim* latticeCoordArray = lattice->get_lattice_coordinate_array();
+
+	// collect distinct neighbor vectors as candidates for grid vectors
+	std::vector<Threedim> candidates;
+	for (int order = 1; order <= 3; ++order)
+	{
+		int* neighborArray = lattice->get_neighbor_array(order);
+		Threedim* neighborVectorArray = lattice->get_neighbor_vector_array(order);
+		int nbors = lattice->get_number_nth_neighbors(order);
+		if (neighborArray == NULL || neighborVectorArray == NULL)
+		{
+			continue;
+		}
+		for (int i = 0; i < numberAtoms * nbors; ++i)
+		{
+			if (neighborArray[i] != -1 && MyMath::norm(neighborVectorArray[i]) > PRECISION)
+			{
+				int known = FALSE;
+				for (int j = 0; j < candidates.size(); ++j)
+				{
+					if (MyMath::norm(MyMath::difference(candidates[j], neighborVectorArray[i])) < PRECISION)
+					{
+						known = TRUE;
+						break;
+					}
+				}
+				if (known == FALSE)
+				{
+					candidates.push_back(neighborVectorArray[i]);
+				}
+			}
+		}
+	}
+	if (candidates.size() == 0)
+	{
+		return FALSE;
+	}
+	std::stable_sort(candidates.begin(), candidates.end(), [](const Threedim &a, const Threedim &b)
+	{
+		return MyMath::norm(a) < MyMath::norm(b);
+	});
+
+	// shortest linearly independent vectors
+	gridVectors[0] = candidates[0];
+	int numberVectors = 1;
+	for (int j = 1; j < candidates.size() && numberVectors < 3; ++j)
+	{
+		Threedim normal = MyMath::vector_product(gridVectors[0], candidates[j]);
+		if (numberVectors == 1 && MyMath::norm(normal) > PRECISION * MyMath::norm(candidates[j]))
+		{
+			gridVectors[1] = candidates[j];
+			numberVectors = 2;
+		}
+		else if (numberVectors == 2 && fabs(MyMath::dot_product(MyMath::vector_product(gridVectors[0],
+			gridVectors[1]), candidates[j])) > PRECISION * pow(MyMath::norm(candidates[j]), 3))
+		{
+			gridVectors[2] = candidates[j];
+			numberVectors = 3;
+		}
+	}
+	if (numberVectors == 1)
+	{
+		// linear chain; any perpendicular vector
+		Threedim axis = { 1,0,0 };
+		if (fabs(MyMath::cosine_vectors(axis, gridVectors[0])) > 0.5)
+		{
+			axis = { 0,1,0 };
+		}
+		gridVectors[1] = MyMath::mult(MyMath::normalize(MyMath::vector_product(gridVectors[0], axis)),
+			MyMath::norm(gridVectors[0]));
+		numberVectors = 2;
+	}
+	if (numberVectors == 2)
+	{
+		// planar lattice
+		gridVectors[2] = MyMath::mult(MyMath::normalize(MyMath::vector_product(gridVectors[0],
+			gridVectors[1])), MyMath::norm(gridVectors[0]));
+	}
+
+	// integer coordinates by means of reciprocal vectors
+	Threedim reciprocal[3];
+	double volume = MyMath::dot_product(MyMath::vector_product(gridVectors[0], gridVectors[1]), gridVectors[2]);
+	reciprocal[0] = MyMath::mult(MyMath::vector_product(gridVectors[1], gridVectors[2]), 1. / volume);
+	reciprocal[1] = MyMath::mult(MyMath::vector_product(gridVectors[2], gridVectors[0]), 1. / volume);
+	reciprocal[2] = MyMath::mult(MyMath::vector_product(gridVectors[0], gridVectors[1]), 1. / volume);
+	for (int i = 0; i < numberAtoms; ++i)
+	{
+		Threedim diffVector = MyMath::difference(latticeCoordArray[i], latticeCoordArray[0]);
+		for (int k = 0; k < 3; ++k)
+		{
+			double coordinate = MyMath::dot_product(diffVector, reciprocal[k]);
+			gridCoordinates[3 * i + k] = (int)std::lround(coordinate);
+			if (fabs(coordinate - gridCoordinates[3 * i + k]) > 0.001)
+			{
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+void DipolarInteractionFFT::setup_grid(Lattice* lattice)
+{
+	if (find_grid(lattice, _gridCoordinates, _gridVectors) == FALSE)
+	{
+		std::cout << "Error in DipolarInteractionFFT: lattice sites do not lie on a regular grid." << std::endl;
+	}
+
+	for (int k = 0; k < 3; ++k)
+	{
+		int minimum = 0;
+		int maximum = 0;
+		for (int i = 0; i < _numberAtoms; ++i)
+		{
+			minimum = std::min(minimum, _gridCoordinates[3 * i + k]);
+			maximum = std::max(maximum, _gridCoordinates[3 * i + k]);
+		}
+		for (int i = 0; i < _numberAtoms; ++i)
+		{
+			_gridCoordinates[3 * i + k] -= minimum;
+		}
+		_extent[k] = maximum - minimum + 1;
+
+		// zero padding to at least 2*extent-1 avoids periodic images in the convolution
+		_paddedSize[k] = 1;
+		while (_paddedSize[k] < 2 * _extent[k] - 1)
+		{
+			_paddedSize[k] *= 2;
+		}
+	}
+	_gridSize = _paddedSize[0] * _paddedSize[1] * _paddedSize[2];
+
+	for (int i = 0; i < _numberAtoms; ++i)
+	{
+		_gridIndex[i] = (_gridCoordinates[3 * i] * _paddedSize[1] + _gridCoordinates[3 * i + 1])
+			* _paddedSize[2] + _gridCoordinates[3 * i + 2];
+	}
+	for (int c = 0; c < 3; ++c)
+	{
+		_grid[c].assign(_gridSize, 0);
+	}
+
+	std::cout << "Dipolar interaction on grid " << _extent[0] << "x" << _extent[1] << "x" << _extent[2]
+		<< " (padded " << _paddedSize[0] << "x" << _paddedSize[1] << "x" << _paddedSize[2] << ")." << std::endl;
+}
+
+void DipolarInteractionFFT::setup_tensor(void)
+{
+	/**
+	* The effective field at site i is sum_j T(r_i - r_j) S_j with
+	* T(r) = -prefactor * (1 - 3 r r^T / |r|^2) / |r|^3. T is stored for all displacements on the padded grid
+	* with negative displacements wrapped around.
+	*/
+
+	for (int c = 0; c < 6; ++c)
+	{
+		_tensor[c].assign(_gridSize, 0);
+	}
+
+	for (int m0 = -_extent[0] + 1; m0 < _extent[0]; ++m0)
+	{
+		for (int m1 = -_extent[1] + 1; m1 < _extent[1]; ++m1)
+		{
+			for (int m2 = -_extent[2] + 1; m2 < _extent[2]; ++m2)
+			{
+				if (m0 == 0 && m1 == 0 && m2 == 0)
+				{
+					continue;
+				}
+				Threedim distanceVector = MyMath::add(MyMath::add(MyMath::mult(_gridVectors[0], m0),
+					MyMath::mult(_gridVectors[1], m1)), MyMath::mult(_gridVectors[2], m2));
+				double distance = MyMath::norm(distanceVector);
+				Threedim u = MyMath::mult(distanceVector, 1. / distance);
+				double value = -_prefactor / pow(distance, 3);
+
+				int index = (((m0 + _paddedSize[0]) % _paddedSize[0]) * _paddedSize[1]
+					+ (m1 + _paddedSize[1]) % _paddedSize[1]) * _paddedSize[2] + (m2 + _paddedSize[2]) % _paddedSize[2];
+				_tensor[0][index] = value * (1 - 3 * u.x * u.x);
+				_tensor[1][index] = value * (-3 * u.x * u.y);
+				_tensor[2][index] = value * (-3 * u.x * u.z);
+				_tensor[3][index] = value * (1 - 3 * u.y * u.y);
+				_tensor[4][index] = value * (-3 * u.y * u.z);
+				_tensor[5][index] = value * (1 - 3 * u.z * u.z);
+			}
+		}
+	}
+
+	for (int c = 0; c < 6; ++c)
+	{
+		_tensorFFT[c].assign(_tensor[c].begin(), _tensor[c].end());
+		fft_3d(_tensorFFT[c].data(), -1);
+	}
+}
+
+void DipolarInteractionFFT::fft_3d(std::complex<double>* grid, const int &direction) const
+{
+	/**
+	* @param[in,out] grid Values on padded grid
+	* @param[in] direction -1 for forward, +1 for backward transform (not normalized)
+	*/
+
+	int stride = _gridSize;
+	for (int k = 0; k < 3; ++k)
+	{
+		int n = _paddedSize[k];
+		stride /= n;
+		if (n == 1)
+		{
+			continue;
+		}
+		int numberLines = _gridSize / n;
+		#pragma omp parallel
+		{
+			std::vector<std::complex<double>> line(n);
+			#pragma omp for schedule(static)
+			for (int l = 0; l < numberLines; ++l)
+			{
+				int start = (l / stride) * n * stride + l % stride;
+				for (int i = 0; i < n; ++i)
+				{
+					line[i] = grid[start + i * stride];
+				}
+				MyMath::fft(line.data(), n, direction);
+				for (int i = 0; i < n; ++i)
+				{
+					grid[start + i * stride] = line[i];
+				}
+			}
+		}
+	}
+}
+
+void DipolarInteractionFFT::convolution(void) const
+{
+	/**
+	* After the call, _grid[c][_gridIndex[i]] / _gridSize is component c of the effective field at site i.
+	*/
+
+	for (int c = 0; c < 3; ++c)
+	{
+		std::fill(_grid[c].begin(), _grid[c].end(), std::complex<double>(0, 0));
+	}
+	for (int i = 0; i < _numberAtoms; ++i)
+	{
+		_grid[0][_gridIndex[i]] = _spinArray[i].x;
+		_grid[1][_gridIndex[i]] = _spinArray[i].y;
+		_grid[2][_gridIndex[i]] = _spinArray[i].z;
+	}
+	for (int c = 0; c < 3; ++c)
+	{
+		fft_3d(_grid[c].data(), -1);
+	}
+
+	#pragma omp parallel for schedule(static)
+	for (int k = 0; k < _gridSize; ++k)
+	{
+		std::complex<double> sx = _grid[0][k];
+		std::complex<double> sy = _grid[1][k];
+		std::complex<double> sz = _grid[2][k];
+		_grid[0][k] = _tensorFFT[0][k] * sx + _tensorFFT[1][k] * sy + _tensorFFT[2][k] * sz;
+		_grid[1][k] = _tensorFFT[1][k] * sx + _tensorFFT[3][k] * sy + _tensorFFT[4][k] * sz;
+		_grid[2][k] = _tensorFFT[2][k] * sx + _tensorFFT[4][k] * sy + _tensorFFT[5][k] * sz;
+	}
+
+	for (int c = 0; c < 3; ++c)
+	{
+		fft_3d(_grid[c].data(), 1);
+	}
+}
+
+double DipolarInteractionFFT::single_energy(const int &position) const
+{
+	return -MyMath::dot_product(_spinArray[position], effective_field(position));
+}
+
+Threedim DipolarInteractionFFT::effective_field(const int &position) const
+{
+	/**
+	* Direct summation with the stored interaction tensor. O(N) per lattice site.
+	*
+	* @param[in] position Index of lattice site
+	*/
+
+	double fieldX = 0;
+	double fieldY = 0;
+	double fieldZ = 0;
+	const int* coordinates = &_gridCoordinates[3 * position];
+	for (int j = 0; j < _numberAtoms; ++j)
+	{
+		// self interaction vanishes since _tensor is zero for zero displacement
+		int index = ((coordinates[0] - _gridCoordinates[3 * j] + _paddedSize[0]) % _paddedSize[0] * _paddedSize[1]
+			+ (coordinates[1] - _gridCoordinates[3 * j + 1] + _paddedSize[1]) % _paddedSize[1]) * _paddedSize[2]
+			+ (coordinates[2] - _gridCoordinates[3 * j + 2] + _paddedSize[2]) % _paddedSize[2];
+		const Threedim &spin = _spinArray[j];
+		fieldX += _tensor[0][index] * spin.x + _tensor[1][index] * spin.y + _tensor[2][index] * spin.z;
+		fieldY += _tensor[1][index] * spin.x + _tensor[3][index] * spin.y + _tensor[4][index] * spin.z;
+		fieldZ += _tensor[2][index] * spin.x + _tensor[4][index] * spin.y + _tensor[5][index] * spin.z;
+	}
+	return Threedim{ fieldX, fieldY, fieldZ };
+}
+
+double DipolarInteractionFFT::delta_energy(const int &position, const Threedim &oldSpin,
+	const Threedim &newSpin) const
+{
+	return -MyMath::dot_product(MyMath::difference(newSpin, oldSpin), effective_field(position));
+}
+
+int DipolarInteractionFFT::linear_in_spin(void) const
+{
+	return TRUE;
+}
+
+void DipolarInteractionFFT::add_effective_fields(const int* sites, const int &numberSites, Threedim* fields) const
+{
+	/**
+	* Fields of all sites by convolution. O(N log N) for all sites together.
+	*
+	* @param[in] sites Indexes of lattice sites
+	* @param[in] numberSites Number of entries in sites
+	* @param[in,out] fields The effective field at sites[i] is added to fields[i]
+	*/
+
+	convolution();
+	double norm = 1. / _gridSize;
+	for (int i = 0; i < numberSites; ++i)
+	{
+		int index = _gridIndex[sites[i]];
+		fields[i].x += _grid[0][index].real() * norm;
+		fields[i].y += _grid[1][index].real() * norm;
+		fields[i].z += _grid[2][index].real() * norm;
+	}
+}
+
+double DipolarInteractionFFT::total_energy(const int &numberAtoms) const
+{
+	/**
+	* @param[in] numberAtoms Number of lattice sites
+	*
+	* @return The total dipolar energy [meV]
+	*/
+
+	convolution();
+	double norm = 1. / _gridSize;
+	double energy = 0;
+	for (int i = 0; i < numberAtoms; ++i)
+	{
+		int index = _gridIndex[i];
+		energy -= (_spinArray[i].x * _grid[0][index].real() + _spinArray[i].y * _grid[1][index].real()
+			+ _spinArray[i].z * _grid[2][index].real()) * norm;
+	}
+	return energy * _factor;
+}
+
+int DipolarInteractionFFT::site_additive(void) const
+{
+	/**
+	* @return FALSE: single_energy is a direct summation over all sites, total_energy uses the convolution
+	*/
+
+	return FALSE;
+}
@@ -0,0 +1,337 @@
+/*
+* DipolarInteractionTree.cpp
+*
+* Copyright 2017 Julian Hagemeister
+*
+* This file is part of MonteCrystal.
+*
+* MonteCrystal is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* MonteCrystal is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with MonteCrystal.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include "DipolarInteractionTree.h"
+
+// forward and further includes
+#include "Lattice.h"
+#include "MyMath.h"
+
+#include <algorithm>
+#include <iostream>
+
+// maximum depth of octree; limits subdivision of (nearly) coinciding lattice sites
+#define MAX_TREE_DEPTH 32
+
+DipolarInteractionTree::DipolarInteractionTree(Threedim* spinArray, double magneticMoment,
+	double latticeConstant, Lattice* lattice, double openingAngle, int leafSize):
+	Energy(0.5, "E_Dipol ", spinArray, 1)
+{
+	/**
+	* @param[in] spinArray Pointer to spin configuration.
+	* @param[in] magneticMoment Magnetic moment of single spin as multiples of Bohr magneton
+	* @param[in] latticeConstant Lattice constant of the lattice in [Angstrom]
+	* @param[in] lattice Lattice object containing all information about lattice configuration
+	* @param[in] openingAngle Accuracy parameter between 0 (exact) and 1. Typical value 0.3.
+	* @param[in] leafSize Maximum number of lattice sites within a leaf node
+	*/
+
+	_numberAtoms = lattice->get_number_atoms();
+	// same prefactor as in DipolarInteraction
+	_prefactor = 9.27401 * 9.27401 * pow(magneticMoment, 2) / (1000 * 1.602 * pow(latticeConstant, 3));
+	_openingAngle = std::min(std::max(openingAngle, 0.), 1.);
+	_leafSize = std::max(leafSize, 1);
+	_latticeCoordArray = lattice->get_lattice_coordinate_array();
+
+	_sites.resize(_numberAtoms);
+	for (int i = 0; i < _numberAtoms; ++i)
+	{
+		_sites[i] = i;
+	}
+	_leafOfSite.assign(_numberAtoms, 0);
+
+	DipolarTreeNode root;
+	root.begin = 0;
+	root.end = _numberAtoms;
+	_nodes.push_back(root);
+	build_tree(0, 0);
+	update_spin_configuration();
+
+	std::cout << "Dipolar interaction with octree of " << _nodes.size() << " nodes, opening angle "
+		<< _openingAngle << "." << std::endl;
+}
+
+DipolarInteractionTree::~DipolarInteractionTree()
+{
+}
+
+void DipolarInteractionTree::build_tree(int node, int depth)
+{
+	/**
+	* Sets center and radius of node and subdivides it into octants of its bounding box.
+	*
+	* @param[in] node Index of node in _nodes
+	* @param[in] depth Depth of node in tree
+	*/
+
+	int begin = _nodes[node].begin;
+	int end = _nodes[node].end;
+
+	Threedim center = { 0,0,0 };
+	Threedim minimum = _latticeCoordArray[_sites[begin]];
+	Threedim maximum = _latticeCoordArray[_sites[begin]];
+	for (int i = begin; i < end; ++i)
+	{
+		const Threedim &coordinate = _latticeCoordArray[_sites[i]];
+		center = MyMath::add(center, coordinate);
+		minimum = { std::min(minimum.x, coordinate.x), std::min(minimum.y, coordinate.y),
+			std::min(minimum.z, coordinate.z) };
+		maximum = { std::max(maximum.x, coordinate.x), std::max(maximum.y, coordinate.y),
+			std::max(maximum.z, coordinate.z) };
+	}
+	center = MyMath::mult(center, 1. / (end - begin));
+	double radius = 0;
+	for (int i = begin; i < end; ++i)
+	{
+		radius = std::max(radius, MyMath::norm(MyMath::difference(_latticeCoordArray[_sites[i]], center)));
+	}
+	_nodes[node].center = center;
+	_nodes[node].radius = radius;
+
+	if (end - begin <= _leafSize || depth >= MAX_TREE_DEPTH)
+	{
+		for (int i = begin; i < end; ++i)
+		{
+			_leafOfSite[_sites[i]] = node;
+		}
+		return;
+	}
+
+	// sort sites by octant of bounding box
+	Threedim middle = MyMath::mult(MyMath::add(minimum, maximum), 0.5);
+	auto octant = [&](int site)
+	{
+		const Threedim &coordinate = _latticeCoordArray[site];
+		return (coordinate.x > middle.x) + 2 * (coordinate.y > middle.y) + 4 * (coordinate.z > middle.z);
+	};
+	std::stable_sort(_sites.begin() + begin, _sites.begin() + end, [&](int a, int b)
+	{
+		return octant(a) < octant(b);
+	});
+
+	int childBegin = begin;
+	while (childBegin < end)
+	{
+		int childOctant = octant(_sites[childBegin]);
+		int childEnd = childBegin;
+		while (childEnd < end && octant(_sites[childEnd]) == childOctant)
+		{
+			++childEnd;
+		}
+		DipolarTreeNode child;
+		child.begin = childBegin;
+		child.end = childEnd;
+		child.parent = node;
+		_nodes[node].children.push_back(_nodes.size());
+		_nodes.push_back(child);
+		childBegin = childEnd;
+	}
+
+	// copy since _nodes may be reallocated during recursion
+	std::vector<int> children = _nodes[node].children;
+	for (int i = 0; i < children.size(); ++i)
+	{
+		build_tree(children[i], depth + 1);
+	}
+}
+
+void DipolarInteractionTree::update_spin(const int &position, const Threedim &oldSpin, const Threedim &newSpin)
+{
+	/**
+	* Updates the moments of all nodes containing position. O(log N).
+	*
+	* @param[in] position Index of lattice site
+	* @param[in] oldSpin Spin direction before reorientation
+	* @param[in] newSpin Spin direction after reorientation
+	*/
+
+	Threedim difference = MyMath::difference(newSpin, oldSpin);
+	for (int node = _leafOfSite[position]; node != -1; node = _nodes[node].parent)
+	{
+		_nodes[node].moment = MyMath::add(_nodes[node].moment, difference);
+		_nodes[node].moment2 = MyMath::add(_nodes[node].moment2, MyMath::outer_product(difference,
+			MyMath::difference(_latticeCoordArray[position], _nodes[node].center), 1));
+	}
+}
+
+void DipolarInteractionTree::update_spin_configuration(void)
+{
+	/**
+	* Recalculates the moments of all nodes from the spin configuration. O(N).
+	*/
+
+	// children are stored after their parents
+	for (int node = _nodes.size() - 1; node >= 0; --node)
+	{
+		const Threedim &center = _nodes[node].center;
+		Threedim moment = { 0,0,0 };
+		ThreedimMatrix moment2;
+		if (_nodes[node].children.empty())
+		{
+			for (int i = _nodes[node].begin; i < _nodes[node].end; ++i)
+			{
+				moment = MyMath::add(moment, _spinArray[_sites[i]]);
+				moment2 = MyMath::add(moment2, MyMath::outer_product(_spinArray[_sites[i]],
+					MyMath::difference(_latticeCoordArray[_sites[i]], center), 1));
+			}
+		}
+		else
+		{
+			for (int i = 0; i < _nodes[node].children.size(); ++i)
+			{
+				const DipolarTreeNode &child = _nodes[_nodes[node].children[i]];
+				moment = MyMath::add(moment, child.moment);
+				// shift of expansion point from child center to center
+				moment2 = MyMath::add(moment2, MyMath::add(child.moment2, MyMath::outer_product(child.moment,
+					MyMath::difference(child.center, center), 1)));
+			}
+		}
+		_nodes[node].moment = moment;
+		_nodes[node].moment2 = moment2;
+	}
+}
+
+Threedim DipolarInteractionTree::dipolar_field(const Threedim &distanceVector, const Threedim &moment) const
+{
+	/**
+	* @param[in] distanceVector Vector from dipole to lattice site
+	* @param[in] moment Dipole in units of spin
+	*
+	* @return -prefactor * (moment - 3 u (u.moment)) / r**3 with u = distanceVector / r
+	*/
+
+	double distance = MyMath::norm(distanceVector);
+	Threedim u = MyMath::mult(distanceVector, 1. / distance);
+	Threedim field = MyMath::add(moment, MyMath::mult(u, -3 * MyMath::dot_product(u, moment)));
+	return MyMath::mult(field, -_prefactor / pow(distance, 3));
+}
+
+Threedim DipolarInteractionTree::node_field(const Threedim &distanceVector, const DipolarTreeNode &node) const
+{
+	/**
+	* Field of all spins within node expanded to first order in (position - center) of the spins.
+	*
+	* @param[in] distanceVector Vector from node center to lattice site
+	* @param[in] node Octree node
+	*/
+
+	const ThreedimMatrix &q = node.moment2;
+	double distance2 = MyMath::dot_product(distanceVector, distanceVector);
+	Threedim qR = MyMath::matrix_vector_product(q, distanceVector);
+	Threedim qTR = MyMath::add(MyMath::add(MyMath::mult(q.x, distanceVector.x), MyMath::mult(q.y, distanceVector.y)),
+		MyMath::mult(q.z, distanceVector.z));
+	double trace = q.x.x + q.y.y + q.z.z;
+	double rQR = MyMath::dot_product(distanceVector, qR);
+
+	Threedim correction = MyMath::add(MyMath::add(qR, qTR), MyMath::mult(distanceVector, trace));
+	correction = MyMath::add(MyMath::mult(correction, -3), MyMath::mult(distanceVector, 15 * rQR / distance2));
+	correction = MyMath::mult(correction, _prefactor / pow(distance2, 2.5));
+
+	return MyMath::add(dipolar_field(distanceVector, node.moment), correction);
+}
+
+Threedim DipolarInteractionTree::effective_field(const int &position) const
+{
+	/**
+	* Nodes with radius < _openingAngle * distance are approximated by an expansion around their center. Leaf
+	* nodes which are opened are summed up directly.
+	*
+	* @param[in] position Index of lattice site
+	*/
+
+	const Threedim &coordinate = _latticeCoordArray[position];
+	Threedim field = { 0,0,0 };
+
+	int stack[7 * MAX_TREE_DEPTH + 8];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		const DipolarTreeNode &node = _nodes[stack[--stackSize]];
+		Threedim distanceVector = MyMath::difference(coordinate, node.center);
+		if (node.radius < _openingAngle * MyMath::norm(distanceVector))
+		{
+			field = MyMath::add(field, node_field(distanceVector, node));
+		}
+		else if (node.children.empty())
+		{
+			for (int i = node.begin; i < node.end; ++i)
+			{
+				if (_sites[i] != position)
+				{
+					field = MyMath::add(field, dipolar_field(MyMath::difference(coordinate,
+						_latticeCoordArray[_sites[i]]), _spinArray[_sites[i]]));
+				}
+			}
+		}
+		else
+		{
+			for (int i = 0; i < node.children.size(); ++i)
+			{
+				stack[stackSize++] = node.children[i];
+			}
+		}
+	}
+	return field;
+}
+
+double DipolarInteractionTree::single_energy(const int &position) const
+{
+	return -MyMath::dot_product(_spinArray[position], effective_field(position));
+}
+
+double DipolarInteractionTree::delta_energy(const int &position, const Threedim &oldSpin,
+	const Threedim &newSpin) const
+{
+	return -MyMath::dot_product(MyMath::difference(newSpin, oldSpin), effective_field(position));
+}
+
+int DipolarInteractionTree::linear_in_spin(void) const
+{
+	return TRUE;
+}
+
+double DipolarInteractionTree::total_energy(const int &numberAtoms) const
+{
+	/**
+	* @param[in] numberAtoms Number of lattice sites
+	*
+	* @return The total dipolar energy [meV]
+	*/
+
+	double energy = 0;
+	#pragma omp parallel for schedule(dynamic, 64) reduction(+:energy)
+	for (int i = 0; i < numberAtoms; ++i)
+	{
+		energy += single_energy(i);
+	}
+	return energy * _factor;
+}
+
+int DipolarInteractionTree::site_additive(void) const
+{
+	/**
+	* @return FALSE: the tree walks of the sites differ in cost and are balanced in total_energy
+	*/
+
+	return FALSE;
+}
@@ -22,6 +22,9 @@
 
 #include "Energy.h"
 
+// forward and further includes
+#include "MyMath.h"
+
 Energy::Energy(double factor, std::string stringID, Threedim* spinArray, double energyParameter)
 {
 	/**
@@ -42,6 +45,130 @@ Energy::~Energy()
 
 }
 
+double Energy::delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const
+{
+	/**
+	* Energy difference E(newSpin) - E(oldSpin) of all bonds connected to the spin at position. The spin
+	* configuration is unchanged on return.
+	*
+	* @param[in] position Index of lattice site
+	* @param[in] oldSpin Spin direction before reorientation
+	* @param[in] newSpin Spin direction after reorientation
+	*
+	* @return Energy difference [meV]
+	*/
+
+	Threedim currentSpin = _spinArray[position];
+	_spinArray[position] = newSpin;
+	double energy = single_energy(position);
+	_spinArray[position] = oldSpin;
+	energy -= single_energy(position);
+	_spinArray[position] = currentSpin;
+	return energy;
+}
+
+void Energy::add_effective_fields(const int* sites, const int &numberSites, Threedim* fields) const
+{
+	/**
+	* @param[in] sites Indexes of lattice sites
+	* @param[in] numberSites Number of entries in sites
+	* @param[in,out] fields The effective field at sites[i] is added to fields[i]
+	*/
+
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < numberSites; ++i)
+	{
+		fields[i] = MyMath::add(fields[i], effective_field(sites[i]));
+	}
+}
+
+double Energy::total_energy(const int &numberAtoms) const
+{
+	/**
+	* @param[in] numberAtoms Number of lattice sites
+	*
+	* @return The total energy [meV]
+	*/
+
+	double energy = 0;
+	for (int i = 0; i < numberAtoms; ++i)
+	{
+		energy += single_energy(i);
+	}
+	// The multiplication by _factor takes care of double summations.
+	return energy * _factor;
+}
+
+int Energy::site_additive(void) const
+{
+	return TRUE;
+}
+
+void Energy::update_spin(const int &position, const Threedim &oldSpin, const Threedim &newSpin)
+{
+	/**
+	* @param[in] position Index of lattice site
+	* @param[in] oldSpin Spin direction before reorientation
+	* @param[in] newSpin Spin direction after reorientation
+	*/
+}
+
+void Energy::update_spin_configuration(void)
+{
+}
+
+int Energy::linear_in_spin(void) const
+{
+	return FALSE;
+}
+
+int Energy::pair_couplings(const int &position, std::vector<int> &partners, 
+	std::vector<ThreedimMatrix> &couplings) const
+{
+	/**
+	* Energies that are bilinear pair interactions append the indexes of the interaction partners of the spin
+	* at position and the corresponding 3x3 coupling tensors of the effective field.
+	*
+	* @param[in] position Index of lattice site
+	* @param[out] partners Indexes of interaction partners
+	* @param[out] couplings Coupling tensors [meV]
+	*
+	* @return TRUE if the energy is a bilinear pair interaction, FALSE otherwise.
+	*/
+
+	return FALSE;
+}
+
+int Energy::hessian_blocks(const int &position, ThreedimMatrix &onSite, std::vector<int> &partners,
+	std::vector<ThreedimMatrix> &blocks) const
+{
+	/**
+	* Second derivatives of the total energy (including _factor) at the spin of lattice site position. The
+	* energy is regarded as function of the unconstrained spin vectors. For a bilinear pair interaction the
+	* bond blocks are the negative coupling tensors of the effective field.
+	*
+	* @param[in] position Index of lattice site
+	* @param[in,out] onSite d2E/dS_i dS_i is added [meV]
+	* @param[out] partners Indexes of interaction partners are appended
+	* @param[out] blocks d2E/dS_i dS_k of the interaction partners are appended [meV]
+	*
+	* @return TRUE if the energy provides second derivatives, FALSE otherwise.
+	*/
+
+	int first = blocks.size();
+	if (pair_couplings(position, partners, blocks) == FALSE)
+	{
+		return FALSE;
+	}
+	for (int k = first; k < blocks.size(); ++k)
+	{
+		blocks[k].x = MyMath::mult(blocks[k].x, -1);
+		blocks[k].y = MyMath::mult(blocks[k].y, -1);
+		blocks[k].z = MyMath::mult(blocks[k].z, -1);
+	}
+	return TRUE;
+}
+
 double Energy::get_factor(void)  const
 {
 	return _factor;
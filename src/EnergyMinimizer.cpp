@@ -0,0 +1,390 @@
+/*
+* EnergyMinimizer.cpp
+*
+* Copyright 2017 Julian Hagemeister
+*
+* This file is part of MonteCrystal.
+*
+* MonteCrystal is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* MonteCrystal is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with MonteCrystal.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include "EnergyMinimizer.h"
+
+// forward and further includes
+#include "SpinOrientation.h"
+#include "Hamiltonian.h"
+#include "RanGen.h"
+#include "MyMath.h"
+
+#include <algorithm>
+
+#include "SimulationProgram.h"
+
+// maximum rotation angle of a single spin within one step [rad]
+#define MAX_ANGLE 0.5
+// sufficient decrease of energy relative to linear prediction (Armijo condition)
+#define ARMIJO 0.0001
+// maximum number of halvings of the step length within one step
+#define MAX_LINE_SEARCH 30
+// relative energy change between steps that indicates a change of spins or energies from outside
+#define ENERGY_TOLERANCE 1e-9
+
+EnergyMinimizer::EnergyMinimizer(SpinOrientation* spinOrientation, int simulationSteps, double temperature,
+	QSharedPointer<Hamiltonian> hamilton, std::shared_ptr<RanGen> ranGen, int memorySize,
+	SimulationProgram* simulationProgram) :
+	SimulationMethod(spinOrientation, simulationSteps, temperature, hamilton, ranGen, simulationProgram)
+{
+	/**
+	* The temperature is ignored; the method finds the nearest local minimum of the total energy.
+	*
+	* @param[in] spinOrientation Spin information
+	* @param[in] simulationSteps Number of iterations per run
+	* @param[in] temperature Not used
+	* @param[in] hamilton Hamiltonian to calculate system energy and gradient
+	* @param[in] ranGen Not used
+	* @param[in] memorySize Number of previous steps used by L-BFGS. Typical value 5.
+	* @param[in] simulationProgram Needed to trigger updates in graphical user interface
+	*/
+
+	_memorySize = std::max(memorySize, 1);
+	int n = _numberActiveSites;
+
+	_gradient = new Threedim[n];
+	_previousGradient = new Threedim[n];
+	_direction = new Threedim[n];
+	_initialSpins = new Threedim[n];
+	_s = new Threedim[_memorySize * n];
+	_y = new Threedim[_memorySize * n];
+	_rho = new double[_memorySize];
+	_alpha = new double[_memorySize];
+
+	_energy = 0;
+	_stepLength = 1;
+	_maxField = 0;
+	reset_memory();
+}
+
+EnergyMinimizer::~EnergyMinimizer()
+{
+	delete[] _gradient;
+	delete[] _previousGradient;
+	delete[] _direction;
+	delete[] _initialSpins;
+	delete[] _s;
+	delete[] _y;
+	delete[] _rho;
+	delete[] _alpha;
+}
+
+double EnergyMinimizer::simulation_step(void)
+{
+	/*
+	* One iteration of the minimization. Costs one evaluation of the effective fields and, in most steps, two
+	* evaluations of the total energy (start and end of the line search).
+	*/
+
+	Threedim* spinArray = _spinOrientation->get_spin_array();
+	int n = _numberActiveSites;
+
+	// gradient at current spin configuration; |gradient| is the torque |m x B_eff|
+	_hamilton->effective_fields(_activeSites, n, _gradient);
+	// maxima of each thread merged after the loop (max reduction requires OpenMP 3.1)
+	double maxTorque2 = 0;
+	double maxField2 = 0;
+	#pragma omp parallel
+	{
+		double threadTorque2 = 0;
+		double threadField2 = 0;
+
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; ++i)
+		{
+			Threedim spin = spinArray[_activeSites[i]];
+			Threedim field = _gradient[i];
+			_initialSpins[i] = spin;
+			threadField2 = std::max(threadField2, MyMath::dot_product(field, field));
+			_gradient[i] = MyMath::mult(MyMath::difference(field, MyMath::mult(spin,
+				MyMath::dot_product(field, spin))), -1);
+			threadTorque2 = std::max(threadTorque2, MyMath::dot_product(_gradient[i], _gradient[i]));
+		}
+
+		#pragma omp critical
+		{
+			maxTorque2 = std::max(maxTorque2, threadTorque2);
+			maxField2 = std::max(maxField2, threadField2);
+		}
+	}
+	_maxField = sqrt(maxField2);
+
+	double energy = _hamilton->total_energy();
+	if (_boolPrevious == TRUE && fabs(energy - _energy) > ENERGY_TOLERANCE * (1 + fabs(energy)))
+	{
+		// spins, temperature or energy parameters changed since last step
+		reset_memory();
+	}
+	_energy = energy;
+
+	if (maxTorque2 == 0)
+	{
+		_boolPrevious = FALSE;
+		return 0;
+	}
+
+	if (_boolPrevious == TRUE)
+	{
+		update_memory();
+	}
+	lbfgs_direction();
+
+	double slope = dot(_gradient, _direction);
+	if (slope >= 0)
+	{
+		// no descent direction, restart with steepest descent
+		reset_memory();
+		lbfgs_direction();
+		slope = dot(_gradient, _direction);
+	}
+
+	// limit rotation angle of single spins
+	double maxAngle2 = 0;
+	#pragma omp parallel
+	{
+		double threadAngle2 = 0;
+
+		#pragma omp for schedule(static)
+		for (int i = 0; i < n; ++i)
+		{
+			threadAngle2 = std::max(threadAngle2, MyMath::dot_product(_direction[i], _direction[i]));
+		}
+
+		#pragma omp critical
+		{
+			maxAngle2 = std::max(maxAngle2, threadAngle2);
+		}
+	}
+	if (maxAngle2 > MAX_ANGLE * MAX_ANGLE)
+	{
+		double factor = MAX_ANGLE / sqrt(maxAngle2);
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i)
+		{
+			_direction[i] = MyMath::mult(_direction[i], factor);
+		}
+		slope *= factor;
+	}
+
+	// backtracking line search
+	double stepLength = 1;
+	int boolAccepted = FALSE;
+	for (int trial = 0; trial < MAX_LINE_SEARCH; ++trial)
+	{
+		rotate_spins(stepLength);
+		_hamilton->update_spin_configuration();
+		double trialEnergy = _hamilton->total_energy();
+		if (trialEnergy <= energy + ARMIJO * stepLength * slope)
+		{
+			_energy = trialEnergy;
+			boolAccepted = TRUE;
+			break;
+		}
+		stepLength *= 0.5;
+	}
+
+	if (boolAccepted == FALSE)
+	{
+		// no decrease within numerical precision; keep spin configuration of beginning of step
+		rotate_spins(0);
+		_hamilton->update_spin_configuration();
+		reset_memory();
+		return sqrt(maxTorque2);
+	}
+
+	_stepLength = stepLength;
+	std::copy(_gradient, _gradient + n, _previousGradient);
+	_boolPrevious = TRUE;
+
+	return sqrt(maxTorque2);
+}
+
+void EnergyMinimizer::reset_memory(void)
+{
+	_numberPairs = 0;
+	_newestPair = _memorySize - 1;
+	_boolPrevious = FALSE;
+}
+
+void EnergyMinimizer::update_memory(void)
+{
+	/**
+	* Stores s = (last step) and y = (gradient - previous gradient), both transported to the current tangent
+	* planes. Stored pairs are transported as well. Steps without positive curvature s.y are not stored.
+	*/
+
+	int n = _numberActiveSites;
+
+	for (int j = 0; j < _numberPairs; ++j)
+	{
+		int k = (_newestPair - j + _memorySize) % _memorySize;
+		project(_s + k * n);
+		project(_y + k * n);
+		double sy = dot(_s + k * n, _y + k * n);
+		if (sy <= 0)
+		{
+			reset_memory();
+			break;
+		}
+		_rho[k] = 1. / sy;
+	}
+
+	int slot = (_newestPair + 1) % _memorySize;
+	Threedim* s = _s + slot * n;
+	Threedim* y = _y + slot * n;
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i)
+	{
+		s[i] = MyMath::mult(_direction[i], _stepLength);
+		y[i] = _previousGradient[i];
+	}
+	project(s);
+	project(y);
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i)
+	{
+		y[i] = MyMath::difference(_gradient[i], y[i]);
+	}
+
+	double sy = dot(s, y);
+	if (sy > 0)
+	{
+		_rho[slot] = 1. / sy;
+		_newestPair = slot;
+		_numberPairs = std::min(_numberPairs + 1, _memorySize);
+	}
+}
+
+void EnergyMinimizer::lbfgs_direction(void)
+{
+	/**
+	* Two-loop recursion. Without stored pairs the direction is the steepest descent direction scaled by the
+	* inverse of the maximum effective field.
+	*/
+
+	int n = _numberActiveSites;
+	if (_numberPairs == 0)
+	{
+		double factor = -1. / _maxField;
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i)
+		{
+			_direction[i] = MyMath::mult(_gradient[i], factor);
+		}
+		return;
+	}
+
+	Threedim* q = _direction;
+	std::copy(_gradient, _gradient + n, q);
+
+	for (int j = 0; j < _numberPairs; ++j)
+	{
+		int k = (_newestPair - j + _memorySize) % _memorySize;
+		Threedim* s = _s + k * n;
+		Threedim* y = _y + k * n;
+		_alpha[k] = _rho[k] * dot(s, q);
+		double alpha = _alpha[k];
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i)
+		{
+			q[i] = MyMath::difference(q[i], MyMath::mult(y[i], alpha));
+		}
+	}
+
+	// initial inverse Hessian gamma * identity with gamma = s.y / y.y of newest pair
+	Threedim* yNewest = _y + _newestPair * n;
+	double gamma = 1. / (_rho[_newestPair] * dot(yNewest, yNewest));
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i)
+	{
+		q[i] = MyMath::mult(q[i], gamma);
+	}
+
+	for (int j = _numberPairs - 1; j >= 0; --j)
+	{
+		int k = (_newestPair - j + _memorySize) % _memorySize;
+		Threedim* s = _s + k * n;
+		Threedim* y = _y + k * n;
+		double factor = _alpha[k] - _rho[k] * dot(y, q);
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i)
+		{
+			q[i] = MyMath::add(q[i], MyMath::mult(s[i], factor));
+		}
+	}
+
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i)
+	{
+		q[i] = MyMath::mult(q[i], -1);
+	}
+}
+
+void EnergyMinimizer::rotate_spins(double stepLength)
+{
+	/**
+	* Each spin is rotated along the great circle given by its component of stepLength * _direction, the
+	* length of which is the rotation angle.
+	*
+	* @param[in] stepLength Factor of search direction
+	*/
+
+	Threedim* spinArray = _spinOrientation->get_spin_array();
+
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < _numberActiveSites; ++i)
+	{
+		Threedim spin = _initialSpins[i];
+		Threedim rotation = MyMath::mult(_direction[i], stepLength);
+		rotation = MyMath::difference(rotation, MyMath::mult(spin, MyMath::dot_product(rotation, spin)));
+		double angle = MyMath::norm(rotation);
+		Threedim newSpin = spin;
+		if (angle > 0)
+		{
+			newSpin = MyMath::add(MyMath::mult(spin, cos(angle)), MyMath::mult(rotation, sin(angle) / angle));
+		}
+		spinArray[_activeSites[i]] = MyMath::normalize(newSpin);
+	}
+}
+
+double EnergyMinimizer::dot(const Threedim* a, const Threedim* b) const
+{
+	double sum = 0;
+	#pragma omp parallel for schedule(static) reduction(+:sum)
+	for (int i = 0; i < _numberActiveSites; ++i)
+	{
+		sum += MyMath::dot_product(a[i], b[i]);
+	}
+	return sum;
+}
+
+void EnergyMinimizer::project(Threedim* a) const
+{
+	Threedim* spinArray = _spinOrientation->get_spin_array();
+
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < _numberActiveSites; ++i)
+	{
+		Threedim spin = spinArray[_activeSites[i]];
+		a[i] = MyMath::difference(a[i], MyMath::mult(spin, MyMath::dot_product(a[i], spin)));
+	}
+}
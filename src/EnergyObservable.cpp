@@ -24,46 +24,62 @@
 
 //forward includes
 #include "Hamiltonian.h"
+#include "ObservableEngine.h"
 
 #include "MyMath.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <sstream> 
 #include <iomanip>
 
 EnergyObservable::EnergyObservable(int numberMeasurements, QSharedPointer<Hamiltonian> hamilton,
-	int numberAtoms, bool eachSpin):
+	int numberAtoms, bool eachSpin, std::shared_ptr<ObservableEngine> engine):
 	Observable(numberMeasurements)
 {
 	/**
 	* @param[in] numberMeasurements Number of measurement values that can be stored
 	* @param[in] hamilton The Hamiltonian to obtain information about system energy
 	* @param[in] numberAtoms Total number of spins
+	* @param[in] eachSpin Energies resolved to lattice sites are stored as well
+	* @param[in] engine Evaluates the energies before take_value is called
 	*/
 
 	_hamilton = hamilton;
+	_engine = engine;
+	_engine->request_energies(hamilton, eachSpin ? TRUE : FALSE);
 	_numberEnergies = hamilton->get_number_energies();
 	_numberAtoms = numberAtoms;
 	_eachSpin = eachSpin;
 
+	_singleEnergies = NULL;
+	_singleEnergiesperspin = NULL;
+	_energyStatistics.resize(_numberEnergies);
+	allocate_storage();
+}
+
+EnergyObservable::~EnergyObservable()
+{
+	free_storage();
+}
+
+void EnergyObservable::allocate_storage(void)
+{
+	int storageSize = get_storage_size();
 	_singleEnergies = new double*[_numberEnergies];
 	for (int i = 0; i < _numberEnergies; ++i)
 	{
-		_singleEnergies[i] = new double[numberMeasurements];
+		_singleEnergies[i] = new double[storageSize];
 	}
-	_singleEnergiesperspin = new double**[_numberEnergies + 1];
-	for (int i = 0; i < _numberEnergies + 1; ++i)
+	if (_eachSpin)
 	{
-		_singleEnergiesperspin[i] = new double*[_numberAtoms];
-		for (int j = 0; j < _numberAtoms; ++j)
-		{
-			_singleEnergiesperspin[i][j] = new double[numberMeasurements];
-		}
+		_singleEnergiesperspin = new double[storageSize * (_numberEnergies + 1) * _numberAtoms];
+		_spinEnergySums.assign((_numberEnergies + 1) * _numberAtoms, 0);
 	}
 }
 
-EnergyObservable::~EnergyObservable()
+void EnergyObservable::free_storage(void)
 {
 	for (int i = 0; i < _numberEnergies; ++i)
 	{
@@ -72,16 +88,6 @@ EnergyObservable::~EnergyObservable()
 	}
 	delete[] _singleEnergies;
 	_singleEnergies = NULL;
-	for (int i = 0; i < _numberEnergies + 1; ++i)
-	{
-		for (int j = 0; j < _numberAtoms; ++j)
-		{
-			delete[] _singleEnergiesperspin[i][j];
-			_singleEnergiesperspin[i][j] = NULL;
-		}
-		delete[] _singleEnergiesperspin[i];
-		_singleEnergiesperspin[i] = NULL;
-	}
 	delete[] _singleEnergiesperspin;
 	_singleEnergiesperspin = NULL;
 }
@@ -134,6 +140,10 @@ std::string EnergyObservable::get_mean_header(void) const
 	*/
 	std::string header = get_steps_header();
 	header.append("C ");
+	if (_boolErrorAnalysis == TRUE)
+	{
+		header.append("dE tau_E dC ");
+	}
 
 	return header;
 }
@@ -143,57 +153,67 @@ void EnergyObservable::take_value(void)
 	/**
 	* Do a measurement on the system.
 	*/
-	double* valuesPntr = NULL;
-	double* valuesPntrperspin = NULL;
-	double* valuesPntrperspintotal = NULL;
+
+	int index = storage_index(_measurementIndex);
+	double totalEnergy = 0;
 	for (int i = 0; i < _numberEnergies; ++i)
 	{
-		valuesPntr = _singleEnergies[i];
-		valuesPntr[_measurementIndex] = _hamilton->part_energy(i);
-		if (_eachSpin)
+		double energy = _engine->get_part_energy(i);
+		_singleEnergies[i][index] = energy;
+		_energyStatistics[i].add(energy);
+		totalEnergy += energy;
+	}
+	_totalEnergyStatistics.add(totalEnergy);
+
+	if (_eachSpin)
+	{
+		double* valuesPntrperspin = _singleEnergiesperspin + index * (_numberEnergies + 1) * _numberAtoms;
+		double* valuesPntrperspintotal = valuesPntrperspin + _numberEnergies * _numberAtoms;
+		const double* siteEnergies = _engine->get_site_energies();
+		std::copy(siteEnergies, siteEnergies + _numberEnergies * _numberAtoms, valuesPntrperspin);
+		for (int j = 0; j < _numberAtoms; ++j)
+		{
+			valuesPntrperspintotal[j] = 0.0;
+		}
+		for (int i = 0; i < _numberEnergies; ++i)
 		{
 			for (int j = 0; j < _numberAtoms; ++j)
 			{
-				valuesPntrperspin = _singleEnergiesperspin[i][j];
-				valuesPntrperspin[_measurementIndex] = _hamilton->single_part_energy(i, j);
-				valuesPntrperspintotal = _singleEnergiesperspin[_numberEnergies][j];
-				if (i == 0)
-				{
-					valuesPntrperspintotal[_measurementIndex] = 0.0;
-				}
-				valuesPntrperspintotal[_measurementIndex] += valuesPntrperspin[_measurementIndex];
+				valuesPntrperspintotal[j] += valuesPntrperspin[i * _numberAtoms + j];
 			}
 		}
-
+		for (int k = 0; k < (_numberEnergies + 1) * _numberAtoms; ++k)
+		{
+			_spinEnergySums[k] += valuesPntrperspin[k];
+		}
 	}
 	++_measurementIndex;
 }
 
 std::string EnergyObservable::get_step_value(const int &index) const
 {
+	/**
+	* @param[in] index Measurement index. In accumulator mode only the last measurement is available.
+	*/
+
 	std::stringstream stream;
 	stream << std::setprecision(15);
 	if (index < _numberMeasurements)
 	{
-		double* valuesPntr = NULL;
-		double* valuesPntrperspin = NULL;
+		int storageIndex = storage_index(index);
 		double totalEnergy = 0;
 		for (int j = 0; j < _numberEnergies; ++j)
 		{
-			valuesPntr = _singleEnergies[j];
-			stream << valuesPntr[index] / _numberAtoms << " ";
-			totalEnergy += valuesPntr[index];
+			stream << _singleEnergies[j][storageIndex] / _numberAtoms << " ";
+			totalEnergy += _singleEnergies[j][storageIndex];
 		}
 		stream << totalEnergy / _numberAtoms << " ";
 		if (_eachSpin == TRUE)
 		{
-			for (int j = 0; j < _numberEnergies + 1; ++j)
+			double* valuesPntrperspin = _singleEnergiesperspin + storageIndex * (_numberEnergies + 1) * _numberAtoms;
+			for (int k = 0; k < (_numberEnergies + 1) * _numberAtoms; ++k)
 			{
-				for (int k = 0; k < _numberAtoms; ++k)
-				{
-					valuesPntrperspin = _singleEnergiesperspin[j][k];
-					stream << valuesPntrperspin[index] << " ";
-				}
+				stream << valuesPntrperspin[k] << " ";
 			}
 		}
 	}
@@ -209,58 +229,34 @@ std::string EnergyObservable::get_mean_value(const double &temperature) const
 {
 	std::stringstream stream;
 	stream << std::setprecision(15);
-	if (_measurementIndex == _numberMeasurements)
+	if (measurements_complete() == TRUE)
 	{
-		double* valuesPntr = NULL;
-		double value = 0;
 		for (int i = 0; i < _numberEnergies; ++i)
 		{
-			value = 0;
-			valuesPntr = _singleEnergies[i];
-			for (int j = 0; j < _numberMeasurements; ++j)
-			{
-				value += valuesPntr[j];
-			}
-			value /= _numberMeasurements;
-			value /= _numberAtoms;
-			stream << value << " ";
-		}
-
-		double* totalEnergies = new double[_numberMeasurements];
-		for (int i = 0; i < _numberMeasurements; ++i)
-		{
-			totalEnergies[i] = 0;
-			for (int j = 0; j < _numberEnergies; ++j)
-			{
-				totalEnergies[i] += _singleEnergies[j][i];
-			}
+			stream << _energyStatistics[i].get_mean() / _numberAtoms << " ";
 		}
 
-		stream << MyMath::mean_value(totalEnergies, _numberMeasurements) / _numberAtoms << " ";
+		stream << _totalEnergyStatistics.get_mean() / _numberAtoms << " ";
 
 		if (_eachSpin == TRUE)
 		{
-			double* valuesPntrperspin = NULL;
-			double valueperspin = 0.0;
-			for (int i = 0; i < _numberEnergies + 1; ++i)
+			for (int k = 0; k < (_numberEnergies + 1) * _numberAtoms; ++k)
 			{
-				for (int k = 0; k < _numberAtoms; ++k)
-				{
-					valueperspin = 0.0;
-					valuesPntrperspin = _singleEnergiesperspin[i][k];
-					for (int j = 0; j < _numberMeasurements; ++j)
-					{
-						valueperspin += valuesPntrperspin[j];
-					}
-					valueperspin /= _numberMeasurements;
-					stream << valueperspin << " ";
-				}
+				stream << _spinEnergySums[k] / _measurementIndex << " ";
 			}
 		}
 
-		stream << MyMath::variance(totalEnergies, _numberMeasurements) / (kB * pow(temperature, 2)) << " ";
+		stream << _totalEnergyStatistics.get_variance() / (kB * pow(temperature, 2)) << " ";
 
-		delete[] totalEnergies;
+		if (_boolErrorAnalysis == TRUE)
+		{
+			// error of mean energy, autocorrelation time in measurements, jackknife error of heat capacity
+			std::vector<double> variances;
+			_totalEnergyStatistics.jackknife_variances(variances, TRUE);
+			stream << _totalEnergyStatistics.get_error() / _numberAtoms << " "
+				<< _totalEnergyStatistics.get_autocorrelation_time() << " "
+				<< RunningStatistics::jackknife_error(variances) / (kB * pow(temperature, 2)) << " ";
+		}
 	}
 	else
 	{
@@ -269,39 +265,27 @@ std::string EnergyObservable::get_mean_value(const double &temperature) const
 	return stream.str();
 }
 
-void EnergyObservable::clear_storage()
+double EnergyObservable::get_relative_error(void) const
 {
-	for (int i = 0; i < _numberEnergies; ++i)
-	{
-		delete[] _singleEnergies[i];
-		_singleEnergies[i] = NULL;
-	}
-	delete[] _singleEnergies;
-	_singleEnergies = NULL;
-	for (int i = 0; i < _numberEnergies + 1; ++i)
+	/**
+	* @return Relative error of the mean total energy
+	*/
+
+	double mean = fabs(_totalEnergyStatistics.get_mean());
+	if (mean == 0)
 	{
-		for (int j = 0; j < _numberAtoms; ++j)
-		{
-			delete[] _singleEnergiesperspin[i][j];
-			_singleEnergiesperspin[i][j] = NULL;
-		}
-		delete[] _singleEnergiesperspin[i];
-		_singleEnergiesperspin[i] = NULL;
+		return 0;
 	}
-	delete[] _singleEnergiesperspin;
-	_singleEnergiesperspin = NULL;
-	_singleEnergies = new double*[_numberEnergies];
+	return _totalEnergyStatistics.get_error() / mean;
+}
+
+void EnergyObservable::clear_storage()
+{
+	free_storage();
+	allocate_storage();
 	for (int i = 0; i < _numberEnergies; ++i)
 	{
-		_singleEnergies[i] = new double[_numberMeasurements];
-	}
-	_singleEnergiesperspin = new double** [_numberEnergies + 1];
-	for (int i = 0; i < _numberEnergies + 1; ++i)
-	{
-		_singleEnergiesperspin[i] = new double* [_numberAtoms];
-		for (int j = 0; j < _numberAtoms; ++j)
-		{
-			_singleEnergiesperspin[i][j] = new double[_numberMeasurements];
-		}
+		_energyStatistics[i].clear();
 	}
+	_totalEnergyStatistics.clear();
 }
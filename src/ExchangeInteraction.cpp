@@ -75,6 +75,34 @@ Threedim ExchangeInteraction::effective_field(const int &position) const
 	return MyMath::mult(field,_energyParameter); // energy of single atom
 }
 
+double ExchangeInteraction::delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const
+{
+	return -MyMath::dot_product(MyMath::difference(newSpin, oldSpin), effective_field(position));
+}
+
+int ExchangeInteraction::linear_in_spin(void) const
+{
+	return TRUE;
+}
+
+int ExchangeInteraction::pair_couplings(const int &position, std::vector<int> &partners, 
+	std::vector<ThreedimMatrix> &couplings) const
+{
+	ThreedimMatrix coupling;
+	coupling.x = { _energyParameter, 0, 0 };
+	coupling.y = { 0, _energyParameter, 0 };
+	coupling.z = { 0, 0, _energyParameter };
+	for (int i = 0; i < _nbors; ++i)
+	{
+		if (_neighborArray[_nbors * position + i] != -1) // -1 refers to empty entry
+		{
+			partners.push_back(_neighborArray[_nbors * position + i]);
+			couplings.push_back(coupling);
+		}
+	}
+	return TRUE;
+}
+
 int ExchangeInteraction::get_nbors(void) const
 {
 	return _nbors;
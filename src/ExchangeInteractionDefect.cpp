@@ -79,6 +79,38 @@ Threedim ExchangeInteractionDefect::effective_field(const int &position) const
 	return field; // energy of single atom
 }
 
+double ExchangeInteractionDefect::delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const
+{
+	return -MyMath::dot_product(MyMath::difference(newSpin, oldSpin), effective_field(position));
+}
+
+int ExchangeInteractionDefect::linear_in_spin(void) const
+{
+	return TRUE;
+}
+
+int ExchangeInteractionDefect::pair_couplings(const int &position, std::vector<int> &partners, 
+	std::vector<ThreedimMatrix> &couplings) const
+{
+	if (_bondEnergies.count(position) != 0)
+	{
+		ThreedimMatrix coupling;
+		for (int i = 0; i < _nbors; ++i)
+		{
+			if (_neighborArray[_nbors * position + i] != -1) // -1 refers to empty entry
+			{
+				double bondEnergy = _bondEnergies.at(position)[i];
+				coupling.x = { bondEnergy, 0, 0 };
+				coupling.y = { 0, bondEnergy, 0 };
+				coupling.z = { 0, 0, bondEnergy };
+				partners.push_back(_neighborArray[_nbors * position + i]);
+				couplings.push_back(coupling);
+			}
+		}
+	}
+	return TRUE;
+}
+
 void ExchangeInteractionDefect::setup_energy_bonds(const std::unordered_map<int, double>& defects)
 {
 	/**
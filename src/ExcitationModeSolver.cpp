@@ -21,7 +21,6 @@
 */
 
 #include <Eigen/SparseCore>
-#include <spectra/MatOp/SparseGenRealShiftSolve.h>
 #include <spectra/GenEigsRealShiftSolver.h>
 
 #include "ExcitationModeSolver.h"
@@ -38,13 +37,46 @@
 #include "MyMath.h"
 #include "Functions.h"
 
+#include <omp.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+/// Shift and invert operation for Spectra with a sparse LU factorization that is computed outside
+/**
+* Replaces Spectra::SparseGenRealShiftSolve, which analyzes and factorizes the matrix in every call. The
+* factorization is of the matrix itself, so only the shift 0 is supported.
+*/
+class FactorizedShiftSolve
+{
+public:
+	FactorizedShiftSolve(const Eigen::SparseLU<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>> &solver,
+		int n) : _solver(solver), _n(n) {}
+	int rows(void) const { return _n; }
+	int cols(void) const { return _n; }
+	void set_shift(double sigma) {}
+	/// y = A^-1 x
+	void perform_op(const double* xIn, double* yOut) const
+	{
+		Eigen::Map<const Eigen::VectorXd> x(xIn, _n);
+		Eigen::Map<Eigen::VectorXd> y(yOut, _n);
+		y.noalias() = _solver.solve(x);
+	}
+
+private:
+	const Eigen::SparseLU<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>> &_solver;
+	int _n;
+};
 
 
 ExcitationModeSolver::ExcitationModeSolver(SpinOrientation* spinOrientation, 
 	QSharedPointer<Hamiltonian> hamilton)
 {
 	/**
-	* All information for calculation of eigenmodes is provided as parameters in constructor.
+	* All information for calculation of eigenmodes is provided as parameters in constructor. The solver can be
+	* used for several spin configurations of the same lattice and Hamiltonian (e.g. the steps of a temperature 
+	* and magnetic field loop).
 	*
 	* @param[in] spinOrientation The information about the spin configuration.
 	* @param[in] hamilton The Hamiltonian providing information about the energy of the system.
@@ -54,12 +86,8 @@ ExcitationModeSolver::ExcitationModeSolver(SpinOrientation* spinOrientation,
 	_numberAtoms = spinOrientation->get_number_atoms();
 	_hamilton = hamilton;
 	
-	_energies = _hamilton->get_energies();
-
-	_fnExEnergyIndex = -1;
-	_fnDMEnergyIndex = -1;
-	_AnisotropyIndex = -1;
-	_ZeemanEnergyIndex = -1;
+	_energies = find_energies();
+	_boolPatternAnalyzed = FALSE;
 }
 
 ExcitationModeSolver::~ExcitationModeSolver()
@@ -78,9 +106,14 @@ void ExcitationModeSolver::save_sparse_matrix(std::string fname)
 void ExcitationModeSolver::save_eigenmodes(std::string fname)
 {
 	/**
-	* Save eigenvalues and eigenvectors to text files.
+	* Save eigenvalues and eigenvectors to text files. Nothing is saved if the last diagonalization failed.
 	*/
 
+	if (_evalues.size() == 0)
+	{
+		return;
+	}
+
 	Functions::save(_evalues, fname + "Eigenvalues");
 	Functions::save(_evalues, _evectors, fname);
 }
@@ -88,43 +121,153 @@ void ExcitationModeSolver::save_eigenmodes(std::string fname)
 void ExcitationModeSolver::setup_matrix(void)
 {
 	/**
-	* Setup sparse matrix needed for the calculation of the eigenmodes.
+	* Setup sparse matrix needed for the calculation of the eigenmodes. The energy is expanded to second order
+	* in the deviations (x,y) of each spin in its own frame (z parallel to spin). The 2x2 blocks of this 
+	* expansion are H_ik = R_i (d2E/dS_i dS_k) R_k^T and on-site additionally (h_i * S_i) 1 with the effective
+	* field h_i. The second derivatives are provided by the energies (Energy::hessian_blocks), so all energies 
+	* of the Hamiltonian that provide them are included. The pattern of the matrix depends on the lattice and the
+	* energies only, not on the spin configuration. The lattice sites are processed in parallel; the 
+	* triplet list is in order of lattice sites independent of the number of threads.
 	*/
 
-	find_energy_indexes();
+	// rotation matrices of all lattice sites
+	_rotationMatrices.resize(_numberAtoms);
+	#pragma omp parallel for
+	for (int i = 0; i < _numberAtoms; ++i)
+	{
+		_rotationMatrices[i] = to_matrix(MyMath::rotation_matrix(_spinArray[i]));
+	}
+
+	int numberThreads = omp_get_max_threads();
+	std::vector<std::vector<Eigen::Triplet<double>>> threadTriplets(numberThreads);
+	#pragma omp parallel num_threads(numberThreads)
+	{
+		std::vector<Eigen::Triplet<double>> &triplets = threadTriplets[omp_get_thread_num()];
+		std::vector<int> partners;
+		std::vector<ThreedimMatrix> blocks;
+		std::vector<int> uniquePartners;
+		std::vector<Eigen::Matrix3d> sumBlocks;
+		std::vector<int> slot(_numberAtoms, -1); // index in uniquePartners of each lattice site
+
+		// contiguous ranges of lattice sites in order of threads
+		#pragma omp for schedule(static)
+		for (int i = 0; i < _numberAtoms; ++i)
+		{
+			ThreedimMatrix onSite;
+			partners.clear();
+			blocks.clear();
+			double fieldProjection = 0;
+			for (int e = 0; e < _energies.size(); ++e)
+			{
+				_energies[e]->hessian_blocks(i, onSite, partners, blocks);
+				fieldProjection += MyMath::dot_product(_energies[e]->effective_field(i), _spinArray[i]);
+			}
+
+			// blocks of the same partner (several energies) are summed
+			uniquePartners.clear();
+			sumBlocks.clear();
+			for (int k = 0; k < partners.size(); ++k)
+			{
+				if (slot[partners[k]] == -1)
+				{
+					slot[partners[k]] = uniquePartners.size();
+					uniquePartners.push_back(partners[k]);
+					sumBlocks.push_back(Eigen::Matrix3d::Zero());
+				}
+				sumBlocks[slot[partners[k]]] += to_matrix(blocks[k]);
+			}
+
+			// only the components perpendicular to the spins enter
+			Eigen::Matrix<double, 2, 3> frameI = _rotationMatrices[i].topRows<2>();
+			for (int k = 0; k < uniquePartners.size(); ++k)
+			{
+				Eigen::Matrix2d block = frameI * sumBlocks[k]
+					* _rotationMatrices[uniquePartners[k]].topRows<2>().transpose();
+				add_block(triplets, i, uniquePartners[k], block);
+				slot[uniquePartners[k]] = -1;
+			}
+			Eigen::Matrix2d block = frameI * to_matrix(onSite) * frameI.transpose();
+			block(0, 0) += fieldProjection;
+			block(1, 1) += fieldProjection;
+			add_block(triplets, i, i, block);
+		}
+	}
+
+	_tripletList.clear();
+	for (int t = 0; t < numberThreads; ++t)
+	{
+		_tripletList.insert(_tripletList.end(), threadTriplets[t].begin(), threadTriplets[t].end());
+	}
+}
+
+void ExcitationModeSolver::setup_matrix_direct(void)
+{
+	/**
+	* Reference implementation of setup_matrix: the previous assembly with a gsl_matrix for each rotation and
+	* bond coupling. Only nearest neighbor exchange and DM interaction, uniaxial anisotropy along z and Zeeman 
+	* energy are included (identified by their string id). Used by compare_matrix_assembly.
+	*/
+
+	// the four energy objects supported by the reference implementation
+	std::vector<std::shared_ptr<Energy>> energies = _hamilton->get_energies();
+	int fnExEnergyIndex = -1;
+	int fnDMEnergyIndex = -1;
+	int anisotropyIndex = -1;
+	int zeemanEnergyIndex = -1;
+	for (int i = 0; i < energies.size(); ++i)
+	{
+		if (energies[i]->get_string_id().compare(0, 3, "E_D") == 0)
+		{
+			fnDMEnergyIndex = i;
+		}
+		if (energies[i]->get_string_id().compare(0, 3, "E_J") == 0)
+		{
+			fnExEnergyIndex = i;
+		}
+		if (energies[i]->get_string_id().compare(0, 7, "E_Uniax") == 0)
+		{
+			anisotropyIndex = i;
+		}
+		if (energies[i]->get_string_id().compare(0, 8, "E_Zeeman") == 0)
+		{
+			zeemanEnergyIndex = i;
+		}
+	}
+
+	_tripletList.clear();
 
 	Threedim ZeemanField{ 0,0,0 };
-	if (_ZeemanEnergyIndex > -0.5)
+	if (zeemanEnergyIndex > -0.5)
 	{
-		ZeemanField = static_cast<ZeemanEnergy*>(_energies[_ZeemanEnergyIndex].get())->get_direction();
-		ZeemanField = MyMath::mult(ZeemanField, _energies[_ZeemanEnergyIndex]->get_energy_parameter());
+		ZeemanField = static_cast<ZeemanEnergy*>(energies[zeemanEnergyIndex].get())->get_direction();
+		ZeemanField = MyMath::mult(ZeemanField, energies[zeemanEnergyIndex]->get_energy_parameter());
 	}
 
 	double kAniso = 0;
-	if (_AnisotropyIndex > -0.5)
+	if (anisotropyIndex > -0.5)
 	{
 		// CAUTION: minus sign due to different convention for anisotropy energy
-		kAniso -= _energies[_AnisotropyIndex]->get_energy_parameter();
+		kAniso -= energies[anisotropyIndex]->get_energy_parameter();
 	}
 
 	double J1 = 0;
 	int fnbors = -1;
 	int* fnborArray = NULL;
-	if (_fnExEnergyIndex > -0.5)
+	if (fnExEnergyIndex > -0.5)
 	{
-		J1 -= _energies[_fnExEnergyIndex]->get_energy_parameter();
-		fnbors = static_cast<ExchangeInteraction*>(_energies[_fnExEnergyIndex].get())->get_nbors();
-		fnborArray = static_cast<ExchangeInteraction*>(_energies[_fnExEnergyIndex].get())->get_neighbor_array();
+		J1 -= energies[fnExEnergyIndex]->get_energy_parameter();
+		fnbors = static_cast<ExchangeInteraction*>(energies[fnExEnergyIndex].get())->get_nbors();
+		fnborArray = static_cast<ExchangeInteraction*>(energies[fnExEnergyIndex].get())->get_neighbor_array();
 	}
 
 	double D1 = 0;
 	Threedim* dmVectors = NULL;
-	if (_fnDMEnergyIndex > -0.5)
+	if (fnDMEnergyIndex > -0.5)
 	{
-		D1 -= _energies[_fnDMEnergyIndex]->get_energy_parameter();
-		fnbors = static_cast<DMInteraction*>(_energies[_fnDMEnergyIndex].get())->get_nbors();
-		fnborArray = static_cast<DMInteraction*>(_energies[_fnDMEnergyIndex].get())->get_neighbor_array();
-		dmVectors = static_cast<DMInteraction*>(_energies[_fnDMEnergyIndex].get())->get_dm_vectors();
+		D1 -= energies[fnDMEnergyIndex]->get_energy_parameter();
+		fnbors = static_cast<DMInteraction*>(energies[fnDMEnergyIndex].get())->get_nbors();
+		fnborArray = static_cast<DMInteraction*>(energies[fnDMEnergyIndex].get())->get_neighbor_array();
+		dmVectors = static_cast<DMInteraction*>(energies[fnDMEnergyIndex].get())->get_dm_vectors();
 	}
 
 	for (int i = 0; i < _numberAtoms; ++i)
@@ -214,12 +357,12 @@ void ExcitationModeSolver::setup_matrix(void)
 
 				// fill off-diagonal elements:
 				//element of matrix A
-				add_sparse_matrix_element(i, _numberAtoms + neighbor, JTilde_ik_xx);
+				_tripletList.push_back(Eigen::Triplet<double>(i, _numberAtoms + neighbor, JTilde_ik_xx));
 				//element of matrix C
-				add_sparse_matrix_element(_numberAtoms + i, neighbor, -JTilde_ik_yy);
+				_tripletList.push_back(Eigen::Triplet<double>(_numberAtoms + i, neighbor, -JTilde_ik_yy));
 				// element of matrix B
-				add_sparse_matrix_element(i, neighbor, JTilde_ik_xy);
-				add_sparse_matrix_element(_numberAtoms + neighbor, _numberAtoms + i, -JTilde_ik_xy);
+				_tripletList.push_back(Eigen::Triplet<double>(i, neighbor, JTilde_ik_xy));
+				_tripletList.push_back(Eigen::Triplet<double>(_numberAtoms + neighbor, _numberAtoms + i, -JTilde_ik_xy));
 
 				gsl_matrix_free(matrixK);
 				gsl_matrix_free(matrixJik);
@@ -229,78 +372,216 @@ void ExcitationModeSolver::setup_matrix(void)
 		// fill diagonal elements:
 		// element of matrix A
 		double a = -sumNeighborInteraction + 2 * KxxTilde - 2 * KzzTilde + BzTilde;
-		add_sparse_matrix_element(i, _numberAtoms + i, a);
+		_tripletList.push_back(Eigen::Triplet<double>(i, _numberAtoms + i, a));
 		// element of matrix C
 		double c = -sumNeighborInteraction + 2 * KyyTilde - 2 * KzzTilde + BzTilde;
-		add_sparse_matrix_element(_numberAtoms + i, i, -c);
+		_tripletList.push_back(Eigen::Triplet<double>(_numberAtoms + i, i, -c));
 		// element of matrix B
 		double b = 2 * KxyTilde;
-		add_sparse_matrix_element(i, i, b);
-		add_sparse_matrix_element(_numberAtoms + i, _numberAtoms + i, -b);
+		_tripletList.push_back(Eigen::Triplet<double>(i, i, b));
+		_tripletList.push_back(Eigen::Triplet<double>(_numberAtoms + i, _numberAtoms + i, -b));
 
 		gsl_matrix_free(matrixI);
 	}
 }
 
+int ExcitationModeSolver::compare_matrix_assembly(void)
+{
+	/**
+	* Benchmark of the matrix assembly. Runs setup_matrix() and the reference implementation 
+	* setup_matrix_direct() and compares the resulting sparse matrices (duplicate triplets summed). The order 
+	* of the triplets differs, so the pattern is compared exactly and the elements up to rounding. Meaningful
+	* only for Hamiltonians with the energies of the reference implementation. The triplet list of 
+	* setup_matrix() is kept.
+	*
+	* @return TRUE if both implementations give the same matrix, FALSE otherwise.
+	*/
+
+	auto start = std::chrono::steady_clock::now();
+	setup_matrix();
+	double timeBlocks = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::vector<Eigen::Triplet<double>> triplets;
+	triplets.swap(_tripletList);
+
+	start = std::chrono::steady_clock::now();
+	setup_matrix_direct();
+	double timeDirect = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	int n = 2 * _numberAtoms;
+	Eigen::SparseMatrix<double> matrix(n, n);
+	matrix.setFromTriplets(triplets.begin(), triplets.end());
+	Eigen::SparseMatrix<double> reference(n, n);
+	reference.setFromTriplets(_tripletList.begin(), _tripletList.end());
+	int numberDirect = _tripletList.size();
+	_tripletList.swap(triplets);
+
+	int identical = (matrix.nonZeros() == reference.nonZeros()
+		&& std::equal(matrix.outerIndexPtr(), matrix.outerIndexPtr() + n + 1, reference.outerIndexPtr())
+		&& std::equal(matrix.innerIndexPtr(), matrix.innerIndexPtr() + matrix.nonZeros(),
+			reference.innerIndexPtr())) ? TRUE : FALSE;
+	double maxDeviation = 0;
+	double maxElement = 0;
+	if (identical == TRUE)
+	{
+		for (int k = 0; k < matrix.nonZeros(); ++k)
+		{
+			maxDeviation = std::max(maxDeviation, fabs(matrix.valuePtr()[k] - reference.valuePtr()[k]));
+			maxElement = std::max(maxElement, fabs(reference.valuePtr()[k]));
+		}
+		identical = (maxDeviation <= 1e-12 * maxElement) ? TRUE : FALSE;
+	}
+
+	std::cout << "Eigenmode matrix for " << _numberAtoms << " lattice sites: Hessian blocks " << timeBlocks
+		<< " s (" << _tripletList.size() << " triplets), direct " << timeDirect << " s (" << numberDirect
+		<< " triplets), maximum deviation " << maxDeviation << ", results " 
+		<< (identical == TRUE ? "identical" : "DIFFERENT") << std::endl;
+	return identical;
+}
+
+void ExcitationModeSolver::add_block(std::vector<Eigen::Triplet<double>> &triplets, int i, int k,
+	const Eigen::Matrix2d &block) const
+{
+	/**
+	* The matrix acts on (x_1..x_N, y_1..y_N). Row i holds the equation of motion of x_i, row N+i that of y_i.
+	*
+	* @param[out] triplets Elements are appended
+	* @param[in] i Lattice site of row
+	* @param[in] k Lattice site of column
+	* @param[in] block Second derivatives with respect to (x,y) in the frames of spins i and k
+	*/
+
+	// element of matrix B
+	triplets.push_back(Eigen::Triplet<double>(i, k, block(0, 1)));
+	// element of matrix A
+	triplets.push_back(Eigen::Triplet<double>(i, _numberAtoms + k, block(0, 0)));
+	// element of matrix C
+	triplets.push_back(Eigen::Triplet<double>(_numberAtoms + i, k, -block(1, 1)));
+	// element of matrix B^T
+	triplets.push_back(Eigen::Triplet<double>(_numberAtoms + i, _numberAtoms + k, -block(1, 0)));
+}
+
+Eigen::Matrix3d ExcitationModeSolver::to_matrix(const ThreedimMatrix &matrix)
+{
+	Eigen::Matrix3d result;
+	result << matrix.x.x, matrix.x.y, matrix.x.z,
+		matrix.y.x, matrix.y.y, matrix.y.z,
+		matrix.z.x, matrix.z.y, matrix.z.z;
+	return result;
+}
+
 void ExcitationModeSolver::diagonalize(int numberEigenstates)
 {
 	/**
-	* Diagonalization of sparse matrix to obtain eigenvalues and eigenvectors of eigenmodes.
+	* Diagonalization of sparse matrix to obtain eigenvalues and eigenvectors of eigenmodes. The eigenvalues
+	* closest to 0 are found by the Arnoldi method applied to the inverse matrix (shift 0). If the previous 
+	* call was for a matrix of the same size (e.g. the previous step of a field sweep), the Arnoldi iteration
+	* starts from its eigenvectors instead of a random vector. If no eigenmodes are found, the eigenmodes of the
+	* previous call are discarded.
 	*
 	* @param[in] numberEigenstates The number of eigenstates to be calculated.
 	*/
 
-	int n = 2 * _numberAtoms;
-	Eigen::SparseMatrix<double> m(n, n);
-	m.setFromTriplets(_tripletList.begin(), _tripletList.end());
+	if (factorize() == FALSE)
+	{
+		std::cout << "Eigenmodes: sparse matrix is singular; no eigenmodes calculated." << std::endl;
+		_evalues.resize(0);
+		_evectors.resize(0, 0);
+		return;
+	}
 
-	// Construct matrix operation object using the wrapper class
-	Spectra::SparseGenRealShiftSolve<double> op(m);
+	int n = 2 * _numberAtoms;
+	FactorizedShiftSolve op(_solver, n);
 	// Construct eigen solver object with shift 0
 	// This will find eigenvalues that are closest to 0
 	int nev = 2*numberEigenstates; // number of eigenvalues
 	int ncv = 10 * nev; // convergence speed. should be ncv>=2*nev+1 according to documentation
-	Spectra::GenEigsRealShiftSolver< double, Spectra::LARGEST_MAGN, Spectra::SparseGenRealShiftSolve<double> > eigs(&op, nev, ncv, 0.0);
-	eigs.init();
+	Spectra::GenEigsRealShiftSolver< double, Spectra::LARGEST_MAGN, FactorizedShiftSolve > eigs(&op, nev, ncv, 0.0);
+	if (_evectors.rows() == n && _evectors.cols() > 0)
+	{
+		// the real parts of the previous eigenvectors span the previous invariant subspace; a small random 
+		// part prevents an early breakdown of the Arnoldi iteration if the matrix did not change
+		Eigen::VectorXd start = _evectors.real().rowwise().sum();
+		start += (1e-3 * start.norm() / sqrt((double)n)) * Eigen::VectorXd::Random(n);
+		eigs.init(start.data());
+	}
+	else
+	{
+		eigs.init();
+	}
 	eigs.compute();
 	if (eigs.info() == Spectra::SUCCESSFUL)
 	{
 		_evalues = eigs.eigenvalues();
 		_evectors = eigs.eigenvectors();
 	}
+	else
+	{
+		std::cout << "Eigenmodes: Arnoldi iteration did not converge." << std::endl;
+		_evalues.resize(0);
+		_evectors.resize(0, 0);
+	}
+}
+
+int ExcitationModeSolver::factorize(void)
+{
+	/**
+	* The symbolic analysis of the sparse LU factorization (fill-reducing column ordering and elimination 
+	* tree) depends on the pattern of the matrix only. It is done again only if the pattern differs from the
+	* one of the previous call; otherwise only the numerical factorization is repeated.
+	*
+	* @return TRUE if the matrix could be factorized
+	*/
+
+	int n = 2 * _numberAtoms;
+	Eigen::SparseMatrix<double> matrix(n, n);
+	matrix.setFromTriplets(_tripletList.begin(), _tripletList.end());
+
+	int boolSamePattern = (_boolPatternAnalyzed == TRUE && matrix.rows() == _matrix.rows()
+		&& matrix.nonZeros() == _matrix.nonZeros()
+		&& std::equal(matrix.outerIndexPtr(), matrix.outerIndexPtr() + n + 1, _matrix.outerIndexPtr())
+		&& std::equal(matrix.innerIndexPtr(), matrix.innerIndexPtr() + matrix.nonZeros(), 
+			_matrix.innerIndexPtr())) ? TRUE : FALSE;
+	_matrix.swap(matrix);
+
+	if (boolSamePattern == FALSE)
+	{
+		_solver.analyzePattern(_matrix);
+		_boolPatternAnalyzed = TRUE;
+	}
+	_solver.factorize(_matrix);
+	return (_solver.info() == Eigen::Success) ? TRUE : FALSE;
 }
 
 
-void ExcitationModeSolver::find_energy_indexes(void)
+std::vector<std::shared_ptr<Energy>> ExcitationModeSolver::find_energies(void) const
 {
 	/**
-	* The eigenmode solver only works for selected energy contributions. 
-	* These are currently NEAREST NEIGHBOR DM and exchange energy and anisotropy and Zeeman energy.
-	* The code will fail if higher order DM and exchange energies were defined!
+	* Energies without second derivatives (e.g. dipolar interaction evaluated by FFT or tree, four-spin, 
+	* three-site and biquadratic interaction, hexagonal anisotropy) are not included in the eigenmodes.
+	*
+	* @return Energies of the Hamiltonian that provide second derivatives
 	*/
 
-	for (int i = 0; i < _energies.size(); ++i)
+	std::vector<std::shared_ptr<Energy>> allEnergies = _hamilton->get_energies();
+	std::vector<std::shared_ptr<Energy>> energies;
+	if (_numberAtoms == 0)
 	{
-		if (_energies[i]->get_string_id().compare(0,3, "E_D") == 0)
-		{
-			_fnDMEnergyIndex = i;
-		}
-		if (_energies[i]->get_string_id().compare(0, 3, "E_J") == 0)
-		{
-			_fnExEnergyIndex = i;
-		}
-		if (_energies[i]->get_string_id().compare(0, 7, "E_Uniax") == 0)
+		return energies;
+	}
+	for (int i = 0; i < allEnergies.size(); ++i)
+	{
+		ThreedimMatrix onSite;
+		std::vector<int> partners;
+		std::vector<ThreedimMatrix> blocks;
+		if (allEnergies[i]->hessian_blocks(0, onSite, partners, blocks) == TRUE)
 		{
-			_AnisotropyIndex = i;
+			energies.push_back(allEnergies[i]);
 		}
-		if (_energies[i]->get_string_id().compare(0, 8, "E_Zeeman") == 0)
+		else
 		{
-			_ZeemanEnergyIndex = i;
+			std::cout << "Eigenmodes: energy " << allEnergies[i]->get_string_id() 
+				<< " provides no second derivatives and is not included." << std::endl;
 		}
 	}
-}
-
-void ExcitationModeSolver::add_sparse_matrix_element(int i, int j, double value)
-{
-	_tripletList.push_back(Eigen::Triplet<double>(i, j, value));
+	return energies;
 }
@@ -188,6 +188,9 @@ std::string Functions::folder_name(const Configuration* config)
 	case metropolis:
 		stream << "MC";
 		break;
+	case energyMinimizer:
+		stream << "MIN";
+		break;
 	}
 
 	/*if (config->_latticePath.empty())
@@ -47,6 +47,7 @@ void GUIProgramTypeElement::setup_elements(void)
 
 	_mw->_toolbar->comboBoxProgramType->addItem(tr("temperature-magnetic-field-loop"));
 	_mw->_toolbar->comboBoxProgramType->addItem(tr("spin-seebeck"));
+	_mw->_toolbar->comboBoxProgramType->addItem(tr("parallel-tempering"));
 	/*_mw->_toolbar->comboBoxProgramType->addItem(tr("tip-movement"));*/
 	_mw->_toolbar->comboBoxProgramType->addItem(tr("experiment01"));
 	_mw->_toolbar->comboBoxProgramType->addItem(tr("eigenFreq"));
@@ -75,6 +76,10 @@ void GUIProgramTypeElement::read_parameter(const std::shared_ptr<Configuration>
 	{
 		config->_programType = spinSeebeck;
 	}
+	if (qString.compare("parallel-tempering") == 0)
+	{
+		config->_programType = parallelTempering;
+	}
 	if (qString.compare("tip-movement") == 0)
 	{
 		config->_programType = tipMovement;
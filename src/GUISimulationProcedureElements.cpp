@@ -286,7 +286,7 @@ void GUISimulationProcedureElements::change_in_simulation_type(QString qString)
 void GUISimulationProcedureElements::change_in_program_type(QString qString)
 {
 	if (qString.compare("temperature-magnetic-field-loop") == 0
-		|| qString.compare("eigenFreq") == 0)
+		|| qString.compare("eigenFreq") == 0 || qString.compare("parallel-tempering") == 0)
 	{
 		QString header("<i>B</i><font size=4><sub>0 </sub></font size=4>[T];<i>\
 B</i><font size=4><sub>1 </sub></font size=4>[T];steps;e<font size=4><sub>x</sub>;\
@@ -534,7 +534,7 @@ void GUISimulationProcedureElements::set_gui_temperature_elements(QString qStrin
 	if (temperature != NULL)
 	{
 		QString qString = _mw->_toolbar->comboBoxProgramType->currentText();
-		if (qString.compare("temperature-magnetic-field-loop") == 0)
+		if (qString.compare("temperature-magnetic-field-loop") == 0 || qString.compare("parallel-tempering") == 0)
 		{
 			_mw->_toolbar->tableWidgetTemperature->item(0, 0)->setText(QString::number(temperature->start));
 			_mw->_toolbar->tableWidgetTemperature->item(0, 1)->setText(QString::number(temperature->end));
@@ -0,0 +1,393 @@
+/*
+* GeodesicNudgedElasticBand.cpp
+*
+* Copyright 2017 Julian Hagemeister
+*
+* This file is part of MonteCrystal.
+*
+* MonteCrystal is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* MonteCrystal is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with MonteCrystal.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include "GeodesicNudgedElasticBand.h"
+
+// forward and further includes
+#include "Hamiltonian.h"
+#include "MyMath.h"
+
+#include <algorithm>
+#include <omp.h>
+
+// maximum rotation angle of a single spin within one step [rad]
+#define MAX_ANGLE 0.2
+
+GeodesicNudgedElasticBand::GeodesicNudgedElasticBand(std::vector<QSharedPointer<Hamiltonian>> hamiltonians,
+	int numberAtoms, const int* activeSites, int numberActiveSites, const Threedim* initialSpins,
+	const Threedim* finalSpins, int numberImages, double springConstant, double timeStep)
+{
+	/**
+	* The initial path rotates each spin with constant angular velocity on the great circle from its initial
+	* to its final direction. Spins at inactive sites are taken from the initial configuration.
+	*
+	* @param[in] hamiltonians One Hamiltonian for each thread; the spin arrays of the Hamiltonians are
+	*                         redirected to the images
+	* @param[in] numberAtoms Number of lattice sites
+	* @param[in] activeSites Indexes of sites that are moved
+	* @param[in] numberActiveSites Number of active sites
+	* @param[in] initialSpins Initial spin configuration (energy minimum)
+	* @param[in] finalSpins Final spin configuration (energy minimum)
+	* @param[in] numberImages Number of images including initial and final configuration; at least 3
+	* @param[in] springConstant Spring constant between neighboring images [meV]. Typical value 1.
+	* @param[in] timeStep Time step of velocity projection optimization. Typical value 0.1.
+	*/
+
+	_hamiltonians = hamiltonians;
+	_numberAtoms = numberAtoms;
+	_activeSites.assign(activeSites, activeSites + numberActiveSites);
+	_numberActiveSites = numberActiveSites;
+	_numberImages = std::max(numberImages, 3);
+	_springConstant = springConstant;
+	_timeStep = timeStep;
+
+	int n = _numberActiveSites;
+	int numberInterior = _numberImages - 2;
+	_images.resize(_numberImages * _numberAtoms);
+	_fields.resize(numberInterior * n);
+	_forces.resize(numberInterior * n);
+	_velocities.assign(numberInterior * n, Threedim{ 0,0,0 });
+	_energies.assign(_numberImages, 0);
+	_distances.assign(_numberImages - 1, 0);
+
+	for (int k = 0; k < _numberImages; ++k)
+	{
+		std::copy(initialSpins, initialSpins + _numberAtoms, _images.begin() + k * _numberAtoms);
+	}
+
+	// geodesic interpolation between initial and final spin of each active site
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i)
+	{
+		int position = _activeSites[i];
+		Threedim spin1 = initialSpins[position];
+		Threedim spin2 = finalSpins[position];
+		Threedim axis = MyMath::vector_product(spin1, spin2);
+		double angle = atan2(MyMath::norm(axis), MyMath::dot_product(spin1, spin2));
+		if (MyMath::norm(axis) < PRECISION)
+		{
+			if (angle < 1)
+			{
+				// (nearly) parallel spins
+				axis = { 0,0,0 };
+			}
+			else
+			{
+				// antiparallel spins: any axis perpendicular to spin
+				Threedim unit = (fabs(spin1.x) < 0.5) ? Threedim{ 1,0,0 } : Threedim{ 0,1,0 };
+				axis = MyMath::vector_product(spin1, unit);
+			}
+		}
+		if (MyMath::norm(axis) > 0)
+		{
+			axis = MyMath::normalize(axis);
+		}
+		Threedim perpendicular = MyMath::vector_product(axis, spin1);
+		for (int k = 1; k < _numberImages - 1; ++k)
+		{
+			double phi = angle * k / (_numberImages - 1);
+			_images[k * _numberAtoms + position] = MyMath::normalize(MyMath::add(MyMath::mult(spin1, cos(phi)),
+				MyMath::mult(perpendicular, sin(phi))));
+		}
+		_images[(_numberImages - 1) * _numberAtoms + position] = spin2;
+	}
+
+	// energies of fixed initial and final configuration
+	for (int k = 0; k < _numberImages; k += _numberImages - 1)
+	{
+		_hamiltonians[0]->set_spin_array(&_images[k * _numberAtoms]);
+		_energies[k] = _hamiltonians[0]->total_energy();
+	}
+
+	evaluate_images();
+	update_distances();
+}
+
+GeodesicNudgedElasticBand::~GeodesicNudgedElasticBand()
+{
+}
+
+double GeodesicNudgedElasticBand::iterate(int boolClimbingImage)
+{
+	/**
+	* The velocities of all images are projected onto the direction of the forces of all images (velocity
+	* projection optimization) and accelerated by the forces. Each spin is rotated by timeStep * velocity,
+	* but at most by MAX_ANGLE.
+	*
+	* @param[in] boolClimbingImage TRUE: image of highest energy climbs to saddle point
+	*
+	* @return Maximum force on a single spin before the step [meV]
+	*/
+
+	forces(boolClimbingImage);
+
+	int size = _forces.size();
+	double power = 0;
+	double forceNorm2 = 0;
+	double maxForce2 = 0;
+	// maxima of each thread merged after the loop (max reduction requires OpenMP 3.1)
+	#pragma omp parallel
+	{
+		double threadForce2 = 0;
+
+		#pragma omp for schedule(static) reduction(+:power, forceNorm2)
+		for (int j = 0; j < size; ++j)
+		{
+			double force2 = MyMath::dot_product(_forces[j], _forces[j]);
+			power += MyMath::dot_product(_velocities[j], _forces[j]);
+			forceNorm2 += force2;
+			threadForce2 = std::max(threadForce2, force2);
+		}
+
+		#pragma omp critical
+		{
+			maxForce2 = std::max(maxForce2, threadForce2);
+		}
+	}
+	if (forceNorm2 == 0)
+	{
+		return 0;
+	}
+
+	// velocity parallel to force if moving downhill, zero otherwise
+	double projection = (power > 0) ? power / forceNorm2 : 0;
+	double maxAngle2 = 0;
+	#pragma omp parallel
+	{
+		double threadAngle2 = 0;
+
+		#pragma omp for schedule(static)
+		for (int j = 0; j < size; ++j)
+		{
+			_velocities[j] = MyMath::mult(_forces[j], projection + _timeStep);
+			Threedim displacement = MyMath::mult(_velocities[j], _timeStep);
+			threadAngle2 = std::max(threadAngle2, MyMath::dot_product(displacement, displacement));
+		}
+
+		#pragma omp critical
+		{
+			maxAngle2 = std::max(maxAngle2, threadAngle2);
+		}
+	}
+	double factor = _timeStep;
+	if (maxAngle2 > MAX_ANGLE * MAX_ANGLE)
+	{
+		factor *= MAX_ANGLE / sqrt(maxAngle2);
+	}
+
+	int n = _numberActiveSites;
+	for (int k = 1; k < _numberImages - 1; ++k)
+	{
+		Threedim* spins = &_images[k * _numberAtoms];
+		Threedim* velocities = &_velocities[(k - 1) * n];
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i)
+		{
+			int position = _activeSites[i];
+			Threedim spin = spins[position];
+			Threedim rotation = MyMath::mult(velocities[i], factor);
+			rotation = MyMath::difference(rotation, MyMath::mult(spin, MyMath::dot_product(rotation, spin)));
+			double angle = MyMath::norm(rotation);
+			if (angle > 0)
+			{
+				spin = MyMath::normalize(MyMath::add(MyMath::mult(spin, cos(angle)),
+					MyMath::mult(rotation, sin(angle) / angle)));
+				spins[position] = spin;
+			}
+			// velocity transported to new tangent plane
+			velocities[i] = MyMath::difference(velocities[i], MyMath::mult(spin,
+				MyMath::dot_product(velocities[i], spin)));
+		}
+	}
+
+	evaluate_images();
+	update_distances();
+
+	return sqrt(maxForce2);
+}
+
+void GeodesicNudgedElasticBand::evaluate_images(void)
+{
+	int n = _numberActiveSites;
+	int numberThreads = _hamiltonians.size();
+
+	#pragma omp parallel for schedule(dynamic, 1) num_threads(numberThreads)
+	for (int k = 1; k < _numberImages - 1; ++k)
+	{
+		const QSharedPointer<Hamiltonian> &hamilton = _hamiltonians[omp_get_thread_num()];
+		hamilton->set_spin_array(&_images[k * _numberAtoms]);
+		hamilton->effective_fields(_activeSites.data(), n, &_fields[(k - 1) * n]);
+		_energies[k] = hamilton->total_energy();
+	}
+}
+
+void GeodesicNudgedElasticBand::forces(int boolClimbingImage)
+{
+	/**
+	* The tangent of image k is the difference to the neighboring image of higher energy; at extrema of the
+	* energy along the path the differences to both neighbors are weighted with the energy differences.
+	* Force = effective field perpendicular to spins and tangent + spring force along tangent. The climbing
+	* image is moved by the effective field with inverted component along the tangent.
+	*
+	* @param[in] boolClimbingImage TRUE: image of highest energy climbs to saddle point
+	*/
+
+	int n = _numberActiveSites;
+	int saddle = get_saddle_image();
+
+	for (int k = 1; k < _numberImages - 1; ++k)
+	{
+		const Threedim* spins = &_images[k * _numberAtoms];
+		const Threedim* previous = &_images[(k - 1) * _numberAtoms];
+		const Threedim* next = &_images[(k + 1) * _numberAtoms];
+		const Threedim* fields = &_fields[(k - 1) * n];
+		Threedim* forces = &_forces[(k - 1) * n];
+
+		double energyMinus = _energies[k - 1] - _energies[k];
+		double energyPlus = _energies[k + 1] - _energies[k];
+		double weightPlus = 1;
+		double weightMinus = 1;
+		if (energyPlus > 0 && energyMinus < 0)
+		{
+			weightMinus = 0;
+		}
+		else if (energyPlus < 0 && energyMinus > 0)
+		{
+			weightPlus = 0;
+		}
+		else
+		{
+			double deltaMax = std::max(fabs(energyPlus), fabs(energyMinus));
+			double deltaMin = std::min(fabs(energyPlus), fabs(energyMinus));
+			if (deltaMax > 0)
+			{
+				weightPlus = (energyPlus > energyMinus) ? deltaMax : deltaMin;
+				weightMinus = (energyPlus > energyMinus) ? deltaMin : deltaMax;
+			}
+		}
+
+		// tangent (not normalized) is stored in forces
+		double tangentNorm2 = 0;
+		double fieldTangent = 0;
+		#pragma omp parallel for schedule(static) reduction(+:tangentNorm2, fieldTangent)
+		for (int i = 0; i < n; ++i)
+		{
+			int position = _activeSites[i];
+			Threedim spin = spins[position];
+			Threedim tangent = MyMath::add(MyMath::mult(MyMath::difference(next[position], spin), weightPlus),
+				MyMath::mult(MyMath::difference(spin, previous[position]), weightMinus));
+			tangent = MyMath::difference(tangent, MyMath::mult(spin, MyMath::dot_product(tangent, spin)));
+			forces[i] = tangent;
+			tangentNorm2 += MyMath::dot_product(tangent, tangent);
+			fieldTangent += MyMath::dot_product(fields[i], tangent);
+		}
+		double tangentNorm = sqrt(tangentNorm2);
+		if (tangentNorm > 0)
+		{
+			fieldTangent /= tangentNorm;
+		}
+		else
+		{
+			tangentNorm = 1;
+		}
+
+		// factor of normalized tangent
+		double tangentFactor = -fieldTangent + _springConstant * (_distances[k] - _distances[k - 1]);
+		if (boolClimbingImage == TRUE && k == saddle)
+		{
+			tangentFactor = -2 * fieldTangent;
+		}
+		tangentFactor /= tangentNorm;
+
+		#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i)
+		{
+			Threedim spin = spins[_activeSites[i]];
+			Threedim field = MyMath::difference(fields[i], MyMath::mult(spin, MyMath::dot_product(fields[i], spin)));
+			forces[i] = MyMath::add(field, MyMath::mult(forces[i], tangentFactor));
+		}
+	}
+}
+
+void GeodesicNudgedElasticBand::update_distances(void)
+{
+	for (int k = 0; k < _numberImages - 1; ++k)
+	{
+		_distances[k] = geodesic_distance(&_images[k * _numberAtoms], &_images[(k + 1) * _numberAtoms]);
+	}
+}
+
+double GeodesicNudgedElasticBand::geodesic_distance(const Threedim* spins1, const Threedim* spins2) const
+{
+	/**
+	* @param[in] spins1 Spin configuration (all lattice sites)
+	* @param[in] spins2 Spin configuration (all lattice sites)
+	*
+	* @return Square root of the sum of the squared angles between the spins at the active sites
+	*/
+
+	double distance2 = 0;
+	#pragma omp parallel for schedule(static) reduction(+:distance2)
+	for (int i = 0; i < _numberActiveSites; ++i)
+	{
+		int position = _activeSites[i];
+		double angle = atan2(MyMath::norm(MyMath::vector_product(spins1[position], spins2[position])),
+			MyMath::dot_product(spins1[position], spins2[position]));
+		distance2 += angle * angle;
+	}
+	return sqrt(distance2);
+}
+
+int GeodesicNudgedElasticBand::get_number_images(void) const
+{
+	return _numberImages;
+}
+
+const Threedim* GeodesicNudgedElasticBand::get_image(int image) const
+{
+	return &_images[image * _numberAtoms];
+}
+
+double GeodesicNudgedElasticBand::get_energy(int image) const
+{
+	return _energies[image];
+}
+
+double GeodesicNudgedElasticBand::get_reaction_coordinate(int image) const
+{
+	double coordinate = 0;
+	for (int k = 0; k < image; ++k)
+	{
+		coordinate += _distances[k];
+	}
+	return coordinate;
+}
+
+int GeodesicNudgedElasticBand::get_saddle_image(void) const
+{
+	return std::max_element(_energies.begin() + 1, _energies.end() - 1) - _energies.begin();
+}
+
+double GeodesicNudgedElasticBand::get_barrier(void) const
+{
+	return _energies[get_saddle_image()] - _energies[0];
+}
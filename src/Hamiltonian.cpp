@@ -24,6 +24,7 @@
 
 // forward and further includes
 #include "MyMath.h"
+#include "PairInteractionField.h"
 #include <iostream>
 
 Hamiltonian::Hamiltonian(std::vector<std::shared_ptr<Energy>> energies, int numberAtoms) 
@@ -35,6 +36,18 @@ Hamiltonian::Hamiltonian(std::vector<std::shared_ptr<Energy>> energies, int numb
 
 	_energies = energies;
 	_numberAtoms = numberAtoms;
+	_fieldEnergies = energies;
+	for (int i = 0; i < _energies.size(); i++)
+	{
+		if (_energies[i]->linear_in_spin() == TRUE)
+		{
+			_linearFieldEnergies.push_back(_energies[i]);
+		}
+		else
+		{
+			_nonlinearEnergies.push_back(_energies[i]);
+		}
+	}
 }
 
 Hamiltonian::~Hamiltonian() 
@@ -61,6 +74,25 @@ double Hamiltonian::single_energy(const int &position) const
 }
 
 
+double Hamiltonian::delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const
+{
+	/**
+	* This function evaluates the change of the energy if the spin at lattice site position is changed from 
+	* oldSpin to newSpin. The spin configuration is not altered.
+	*
+	* @param[in] position lattice site
+	* @param[in] oldSpin spin before reorientation
+	* @param[in] newSpin spin after reorientation
+	*
+	* @return Energy difference E(newSpin) - E(oldSpin).
+	*/
+	double energy = 0;
+	for (auto it = _energies.begin(); it != _energies.end(); ++it)
+	{
+		energy += (*it)->delta_energy(position, oldSpin, newSpin);
+	}
+	return energy;
+}
 
 double Hamiltonian::total_energy(void) const
 {
@@ -99,13 +131,7 @@ double Hamiltonian::part_energy(std::shared_ptr<Energy> &energy) const
 	*
 	* @return The energy.
 	*/
-	double partEnergy = 0;
-	for (int i = 0; i < _numberAtoms; ++i)
-	{
-		partEnergy += energy->single_energy(i);
-	}
-	// The multiplication by get_factor() takes care of double summations.
-	return (double)partEnergy * energy->get_factor();
+	return energy->total_energy(_numberAtoms);
 }
 
 double Hamiltonian::part_energy(const int &index) const
@@ -120,17 +146,13 @@ double Hamiltonian::part_energy(const int &index) const
 	double partEnergy = 0;
 	if (index > -1 && index < _energies.size())
 	{
-		for (int i = 0; i < _numberAtoms; ++i)
-		{
-			partEnergy += _energies[index]->single_energy(i);
-		}
+		partEnergy = _energies[index]->total_energy(_numberAtoms);
 	}
 	else
 	{
 		std::cout << "Index out of bounds in HeisenbergHamiltonian::SinglePartEnergy(int index)" << std::endl;
 	}
-	// The multiplication by get_factor() takes care of double summations.
-	return (double)partEnergy * _energies[index]->get_factor();
+	return partEnergy;
 }
 
 double Hamiltonian::single_part_energy(const int &index, const int &position) const
@@ -166,6 +188,82 @@ void Hamiltonian::set_spin_array(Threedim* spinArray)
 	for (int i = 0; i < _energies.size(); i++)
 	{
 		_energies[i]->set_spin_array(spinArray);
+		_energies[i]->update_spin_configuration();
+	}
+	if (_pairInteractionField != NULL)
+	{
+		_pairInteractionField->set_spin_array(spinArray);
+	}
+}
+
+void Hamiltonian::update_spin(const int &position, const Threedim &oldSpin, const Threedim &newSpin)
+{
+	/**
+	* Has to be called after a single spin update so that energies can update cached information.
+	*
+	* @param[in] position lattice site
+	* @param[in] oldSpin spin before reorientation
+	* @param[in] newSpin spin after reorientation
+	*/
+
+	for (int i = 0; i < _energies.size(); i++)
+	{
+		_energies[i]->update_spin(position, oldSpin, newSpin);
+	}
+}
+
+void Hamiltonian::update_spin_configuration(void)
+{
+	/**
+	* Has to be called after the spin configuration was changed other than by single spin updates.
+	*/
+
+	for (int i = 0; i < _energies.size(); i++)
+	{
+		_energies[i]->update_spin_configuration();
+	}
+}
+
+void Hamiltonian::setup_pair_interaction_field(Threedim* spinArray)
+{
+	/**
+	* Collects all energies that are bilinear pair interactions (exchange, DM, pseudo-dipolar and their defect
+	* variants) into one fused field kernel. Afterwards, effectiveField() and effective_fields() evaluate these 
+	* energies with the kernel and all remaining energies individually. Energies are unaffected.
+	*
+	* @param[in] spinArray Spin configuration
+	*/
+
+	std::vector<std::shared_ptr<Energy>> pairEnergies;
+	_fieldEnergies.clear();
+	_linearFieldEnergies.clear();
+	std::vector<int> partners;
+	std::vector<ThreedimMatrix> couplings;
+	for (int i = 0; i < _energies.size(); i++)
+	{
+		if (_energies[i]->pair_couplings(0, partners, couplings) == TRUE)
+		{
+			pairEnergies.push_back(_energies[i]);
+		}
+		else
+		{
+			_fieldEnergies.push_back(_energies[i]);
+			if (_energies[i]->linear_in_spin() == TRUE)
+			{
+				_linearFieldEnergies.push_back(_energies[i]);
+			}
+		}
+	}
+
+	if (pairEnergies.size() > 0)
+	{
+		_pairInteractionField = std::make_shared<PairInteractionField>(pairEnergies, _numberAtoms, spinArray);
+		std::cout << "Pair interaction field kernel was created with " 
+			<< _pairInteractionField->get_number_bonds() << " bonds." << std::endl;
+	}
+	else
+	{
+		_fieldEnergies = _energies;
 	}
 }
 
@@ -176,13 +274,91 @@ Threedim Hamiltonian::effectiveField(const int &position) const
 	*/
 
 	Threedim field = { 0,0,0 };
-	for (int i = 0; i < _energies.size(); i++)
+	if (_pairInteractionField != NULL)
+	{
+		field = _pairInteractionField->effective_field(position);
+	}
+	for (int i = 0; i < _fieldEnergies.size(); i++)
+	{
+		field = MyMath::add(field,_fieldEnergies[i]->effective_field(position));
+	}
+	return field;
+}
+
+void Hamiltonian::effective_fields(const int* sites, const int &numberSites, Threedim* fields) const
+{
+	/**
+	* Effective fields for a list of lattice sites. Faster than successive calls of effectiveField() if the
+	* pair interaction field kernel is set up or energies evaluate all fields at once (e.g. 
+	* DipolarInteractionFFT).
+	*
+	* @param[in] sites Indexes of lattice sites
+	* @param[in] numberSites Number of entries in sites
+	* @param[out] fields Effective fields. fields[i] belongs to sites[i].
+	*/
+
+	if (_pairInteractionField != NULL)
+	{
+		_pairInteractionField->effective_fields(sites, numberSites, fields);
+	}
+	else
+	{
+		for (int i = 0; i < numberSites; i++)
+		{
+			fields[i] = { 0,0,0 };
+		}
+	}
+	for (int j = 0; j < _fieldEnergies.size(); j++)
 	{
-		field = MyMath::add(field,_energies[i]->effective_field(position));
+		_fieldEnergies[j]->add_effective_fields(sites, numberSites, fields);
+	}
+}
+
+Threedim Hamiltonian::linear_effective_field(const int &position) const
+{
+	/**
+	* Effective field of all energies linear in the spin at position (see Energy::linear_in_spin). The energy
+	* change of these energies for a reorientation of the spin is -(newSpin - oldSpin) * field.
+	*
+	* @param[in] position Index of lattice site
+	*
+	* @return Effective field [meV]
+	*/
+
+	Threedim field = { 0,0,0 };
+	if (_pairInteractionField != NULL)
+	{
+		field = _pairInteractionField->effective_field(position);
+	}
+	for (int i = 0; i < _linearFieldEnergies.size(); i++)
+	{
+		field = MyMath::add(field, _linearFieldEnergies[i]->effective_field(position));
 	}
 	return field;
 }
 
+double Hamiltonian::nonlinear_delta_energy(const int &position, const Threedim &oldSpin,
+	const Threedim &newSpin) const
+{
+	/**
+	* Energy change of all energies that are not linear in the spin at position. Together with 
+	* linear_effective_field() this gives delta_energy().
+	*
+	* @param[in] position lattice site
+	* @param[in] oldSpin spin before reorientation
+	* @param[in] newSpin spin after reorientation
+	*
+	* @return Energy difference E(newSpin) - E(oldSpin) of the non-linear energies.
+	*/
+
+	double energy = 0;
+	for (int i = 0; i < _nonlinearEnergies.size(); i++)
+	{
+		energy += _nonlinearEnergies[i]->delta_energy(position, oldSpin, newSpin);
+	}
+	return energy;
+}
+
 std::vector<std::shared_ptr<Energy>> Hamiltonian::get_energies(void) const
 {
 	return _energies;
@@ -191,4 +367,9 @@ std::vector<std::shared_ptr<Energy>> Hamiltonian::get_energies(void) const
 int Hamiltonian::get_number_energies(void) const
 {
 	return _energies.size();
+}
+
+int Hamiltonian::get_number_nonlinear_energies(void) const
+{
+	return _nonlinearEnergies.size();
 }
\ No newline at end of file
@@ -28,6 +28,8 @@
 #include "RanGen.h"
 #include "MyMath.h"
 
+#include <algorithm>
+
 #include "SimulationProgram.h"
 
 
@@ -35,7 +37,8 @@ LandauLifshitzGilbert::LandauLifshitzGilbert(SpinOrientation* spinOrientation,
 	int simulationSteps, double temperature, QSharedPointer<Hamiltonian> hamilton, 
 	std::shared_ptr<RanGen> ranGen, double timeWidth, double dampingParameter, double magneticMoment,
 	SimulationProgram* simulationProgram):
-	SimulationMethod(spinOrientation, simulationSteps, temperature, hamilton, ranGen, simulationProgram)
+	SimulationMethod(spinOrientation, simulationSteps, temperature, hamilton, ranGen, simulationProgram),
+	_philox(0)
 {
 	/**
 	* @param[in] spinOrientation Spin information
@@ -55,9 +58,17 @@ LandauLifshitzGilbert::LandauLifshitzGilbert(SpinOrientation* spinOrientation,
 	_magneticMoment = magneticMoment * muBohr; //[meV/T]
 	_inverseMagneticMoment = 1./_magneticMoment; //[T/meV]
 	
-	// additional space; even number of thermal field vectors will be created and number should be larger than
-	// number of spins included in simulation
-	_thermalFieldVariance = new double[_numberActiveSites + 2];
+	// work space for simulation step
+	_thermalFieldVariance = new double[_numberActiveSites];
+	_effectiveFields = new Threedim[_numberActiveSites];
+	_randomFields = new Threedim[_numberActiveSites];
+	_initialSpins = new Threedim[_numberActiveSites];
+	_stepCounter = 0;
+
+	// key of thermal noise generator; the two words are drawn in a defined order
+	uint64_t keyHigh = (uint64_t)ranGen->IRandom(0, 2147483647);
+	uint64_t keyLow = (uint64_t)ranGen->IRandom(0, 2147483647);
+	_philox = Philox((keyHigh << 32) | keyLow);
 
 	set_reduced_gyromagnetic_ratio();
 	set_thermal_field_variance();
@@ -65,13 +76,18 @@ LandauLifshitzGilbert::LandauLifshitzGilbert(SpinOrientation* spinOrientation,
 
 LandauLifshitzGilbert::~LandauLifshitzGilbert()
 {
-	delete _thermalFieldVariance;
+	delete[] _thermalFieldVariance;
+	delete[] _effectiveFields;
+	delete[] _randomFields;
+	delete[] _initialSpins;
 }
 
 double LandauLifshitzGilbert::simulation_step(void)
 {
 	/*
-	* Simulation step for the Landau Lifshitz Gilbert differential equation
+	* Simulation step for the Landau Lifshitz Gilbert differential equation (Heun scheme). The predicted spin
+	* configuration is written into the spin array so that the energies evaluate the effective fields of the
+	* corrector step without exchange of spin arrays. The site loops are parallelized; no memory is allocated.
 	*/
 
 	// pointer to current spin array
@@ -80,136 +96,107 @@ double LandauLifshitzGilbert::simulation_step(void)
 	// prefactors
 	double bPrimeValue = -_reducedGyromagneticRatio / 4.;
 	double bValue = -_reducedGyromagneticRatio / 2.;
-	
-	// helper vectors
-	Threedim* bVector = new Threedim[_numberActiveSites];
-	Threedim* aVector = new Threedim[_numberActiveSites];
+	double fieldFactor = _inverseMagneticMoment*_timeWidth;
 
-	// effective field as derived from the energies acting on a certain spin
-	Threedim effectiveField = { 0,0,0 };
-	
-	// random field that arises due to temperature fluctuations
-	Threedim* randomField = new Threedim[_numberActiveSites+2];
+	double convergenceCriterion = 0;
+	int boolConvergenceCriterion = _boolConvergenceCriterion;
 
-	// temporary spin array at intermediate time step
-	Threedim* spinArrayTemp = new Threedim[_spinOrientation->get_number_atoms()];
+	// random fluctuation field at the active lattice sites
+	thermal_fields();
 
-	// lattice index as derived from array containing the indexes of the active lattice sites
-	int position = 0;
+	// effective field as derived from the energies acting on a certain spin
+	_hamilton->effective_fields(_activeSites, _numberActiveSites, _effectiveFields);
 
-	// loop to determine random fluctuation field at the active lattice sites
-	for (int i = 0; i < _numberActiveSites/2 + 1; i++)
+	// predictor; maximum torque of each thread merged after the loop (max reduction requires OpenMP 3.1)
+	#pragma omp parallel
 	{
-		// get two random fields with 3 components each at the same time
-		standard_normal_variables(randomField[2*i], randomField[2*i + 1]);
-
-		// random field
-		randomField[2*i] = MyMath::mult(randomField[2*i], _sqrtTimeWidth*_thermalFieldVariance[2*i]);
+		double threadCriterion = 0;
 
-		// random field
-		randomField[2*i+1] = MyMath::mult(randomField[2*i+1], _sqrtTimeWidth*_thermalFieldVariance[2*i+1]);
-	}
+		#pragma omp for schedule(static)
+		for (int i = 0; i < _numberActiveSites; i++)
+		{
+			int position = _activeSites[i];
+			Threedim spin = spinArray[position];
+			_initialSpins[i] = spin;
 
-	// helper vector and value
-	Threedim tmpVector = { 0,0,0 };
-	double tmpValue = 0;
+			if (boolConvergenceCriterion == TRUE)
+			{
+				// squared torque; square root is taken once after the loop
+				Threedim torque = MyMath::vector_product(spin, _effectiveFields[i]);
+				double norm2 = MyMath::dot_product(torque, torque);
+				if (threadCriterion < norm2)
+				{
+					threadCriterion = norm2;
+				}
+			}
 
-	double convergenceCriterion = 0;
+			Threedim bVector = MyMath::add(MyMath::mult(_effectiveFields[i], fieldFactor), _randomFields[i]);
+			bVector = MyMath::add(bVector, MyMath::mult(MyMath::vector_product(spin, bVector), _dampingParameter));
+			bVector = MyMath::mult(bVector, bPrimeValue);
 
-	for (int i = 0; i < _numberActiveSites; i++)
-	{
-		position = _activeSites[i];
+			Threedim aVector = MyMath::add(spin, MyMath::vector_product(spin, bVector));
 
-		effectiveField = _hamilton->effectiveField(position);
+			Threedim newSpin = MyMath::add(aVector, MyMath::vector_product(aVector, bVector));
+			newSpin = MyMath::add(newSpin, MyMath::mult(bVector, MyMath::dot_product(aVector, bVector)));
+			spinArray[position] = MyMath::mult(newSpin, 1. / (1 + MyMath::dot_product(bVector, bVector)));
+		}
 
-		if (_boolConvergenceCriterion == TRUE)
+		#pragma omp critical
 		{
-			double norm = MyMath::norm(MyMath::vector_product(spinArray[position], effectiveField));
-			if (convergenceCriterion < norm)
+			if (convergenceCriterion < threadCriterion)
 			{
-				convergenceCriterion = norm;
+				convergenceCriterion = threadCriterion;
 			}
 		}
-		
-		effectiveField = MyMath::mult(effectiveField, _inverseMagneticMoment*_timeWidth);
-		
-		bVector[i] = MyMath::add(effectiveField, randomField[i]);
-		tmpVector = MyMath::vector_product(spinArray[position],bVector[i]);
-
-		tmpVector = MyMath::mult(tmpVector, _dampingParameter);
-		bVector[i] = MyMath::add(bVector[i], tmpVector);
-		bVector[i] = MyMath::mult(bVector[i], bPrimeValue);
-
-		aVector[i] = MyMath::vector_product(spinArray[position], bVector[i]);
-		aVector[i] = MyMath::add(spinArray[position], aVector[i]);
-
-		tmpVector = MyMath::vector_product(aVector[i], bVector[i]);
-		spinArrayTemp[position] = MyMath::add(aVector[i], tmpVector);
-		tmpVector = MyMath::mult(bVector[i], MyMath::dot_product(aVector[i], bVector[i]));
-		spinArrayTemp[position] = MyMath::add(spinArrayTemp[position], tmpVector);
-		tmpValue = 1./(1 + MyMath::dot_product(bVector[i], bVector[i]));
-		spinArrayTemp[position] = MyMath::mult(spinArrayTemp[position], tmpValue);
-	}
-
-	for (int i = 0; i < _numberInactiveSites; i++)
-	{
-		position = _inactiveSites[i];
-		spinArrayTemp[position] = spinArray[position];
 	}
 
-	_hamilton->set_spin_array(spinArrayTemp);
+	_hamilton->update_spin_configuration();
+	_hamilton->effective_fields(_activeSites, _numberActiveSites, _effectiveFields);
 
+	// corrector
+	#pragma omp parallel for schedule(static)
 	for (int i = 0; i < _numberActiveSites; i++)
 	{
-		position = _activeSites[i];
-
-		effectiveField = MyMath::mult(_hamilton->effectiveField(position), _inverseMagneticMoment*_timeWidth);
+		Threedim spin = _initialSpins[i];
 
-		bVector[i] = MyMath::add(effectiveField, randomField[i]);
-		tmpVector = MyMath::vector_product(spinArray[position], bVector[i]);
-		tmpVector = MyMath::mult(tmpVector, _dampingParameter);
-		bVector[i] = MyMath::add(bVector[i], tmpVector);
-		bVector[i] = MyMath::mult(bVector[i], bValue);
-
-		aVector[i] = MyMath::vector_product(spinArray[position], bVector[i]);
-		aVector[i] = MyMath::add(spinArray[position], aVector[i]);
-	}
+		Threedim bVector = MyMath::add(MyMath::mult(_effectiveFields[i], fieldFactor), _randomFields[i]);
+		bVector = MyMath::add(bVector, MyMath::mult(MyMath::vector_product(spin, bVector), _dampingParameter));
+		bVector = MyMath::mult(bVector, bValue);
 
-	for (int i = 0; i < _numberActiveSites; i++)
-	{
-		position = _activeSites[i];
+		Threedim aVector = MyMath::add(spin, MyMath::vector_product(spin, bVector));
 
-		tmpVector = MyMath::vector_product(aVector[i], bVector[i]);
-		spinArray[position] = MyMath::add(aVector[i], tmpVector);
-		tmpVector = MyMath::mult(bVector[i], MyMath::dot_product(aVector[i], bVector[i]));
-		spinArray[position] = MyMath::add(spinArray[position], tmpVector);
-		tmpValue = 1./(1 + MyMath::dot_product(bVector[i], bVector[i]));
-		spinArray[position] = MyMath::mult(spinArray[position], tmpValue);
+		Threedim newSpin = MyMath::add(aVector, MyMath::vector_product(aVector, bVector));
+		newSpin = MyMath::add(newSpin, MyMath::mult(bVector, MyMath::dot_product(aVector, bVector)));
+		spinArray[_activeSites[i]] = MyMath::mult(newSpin, 1. / (1 + MyMath::dot_product(bVector, bVector)));
 	}
-	_hamilton->set_spin_array(spinArray);
+	_hamilton->update_spin_configuration();
 
-	delete[] bVector;
-	delete[] aVector;
-	delete[] randomField;
-	delete[] spinArrayTemp;
-
-	return convergenceCriterion;
+	return sqrt(convergenceCriterion);
 }
 
-void LandauLifshitzGilbert::standard_normal_variables(Threedim &vec1, Threedim &vec2)
+void LandauLifshitzGilbert::thermal_fields(void)
 {
 	/**
-	In the methods for the creation of normal distributed random numbers there are always two random numbers 
-	needed that yield two normal distributed random numbers. In order to not waste any created normal 
-	distributed random numbers the values of two thermal field vectors are set within this function. (6 values
-	needed which is multiple of two.)
-
-	@param[out] vec1 first vector which will contain three normal distributed random numbers
-	@param[out] vec2 second vector which will contain three normal distributed random numbers
+	* Random thermal fields at the active lattice sites. The field at a lattice site is determined by the key
+	* of _philox, the step counter and the lattice site index. Thus, it does not depend on the number of 
+	* threads or the order of evaluation.
 	*/
-	_ranGen->polar(vec1.x, vec1.y);
-	_ranGen->polar(vec1.z, vec2.x);
-	_ranGen->polar(vec2.y, vec2.z);
+
+	uint64_t step = _stepCounter++;
+	if (_boolThermalField == FALSE)
+	{
+		std::fill(_randomFields, _randomFields + _numberActiveSites, Threedim{ 0,0,0 });
+		return;
+	}
+
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < _numberActiveSites; i++)
+	{
+		double random[4];
+		_philox.gaussian(step, (uint64_t)_activeSites[i], random);
+		double factor = _sqrtTimeWidth*_thermalFieldVariance[i];
+		_randomFields[i] = Threedim{ random[0] * factor, random[1] * factor, random[2] * factor };
+	}
 }
 
 void LandauLifshitzGilbert::set_temperature(double temperature)
@@ -240,11 +227,16 @@ void LandauLifshitzGilbert::set_thermal_field_variance(void)
 	vary along system
 	*/
 	int position = 0;
+	_boolThermalField = FALSE;
 	for (int i = 0; i < _numberActiveSites; i++)
 	{
 		position = _activeSites[i];
 		_thermalFieldVariance[i] = sqrt(2*_dampingParameter*kB*_temperature[position]/
 			                       (gammaElectron * _magneticMoment));
+		if (_thermalFieldVariance[i] > 0)
+		{
+			_boolThermalField = TRUE;
+		}
 	}
 }
 
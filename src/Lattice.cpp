@@ -22,6 +22,10 @@
 
 #include "Lattice.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
 #include <CImg/CImg.h>
 
 Lattice::Lattice(LatticeType latticeType, std::vector<int> latticeDimensions, int* millerIndexes, 
@@ -1815,9 +1819,11 @@ void Lattice::find_center_site(void)
 	}
 }
 
-void Lattice::neighbor_distances(void)
+void Lattice::neighbor_distances_direct(void)
 {
 	/*
+	*  Reference implementation of neighbor_distances() with O(N**2) run time.
+	*
 	*  This method reads an given array with a lattice configuration and determines
 	* the distances between atom no.0 and all other atoms. That gives all possible
 	* distances in the lattice. After that, all different distances are stored into
@@ -1912,8 +1918,11 @@ void Lattice::neighbor_distances(void)
 	delete[] SortNeighArray;
 }
 
-void Lattice::assign_neighbors(void)
+void Lattice::assign_neighbors_direct(void)
 {
+	/*
+	* Reference implementation of assign_neighbors() with O(N**2) run time.
+	*/
 	if (_radiusMax == 0)
 	{
 		std::cout
@@ -2132,6 +2141,353 @@ void Lattice::assign_neighbors(void)
 	}
 }
 
+void Lattice::neighbor_distances(void)
+{
+	/**
+	* Determines the different distances between the center site and all other lattice sites. The distances
+	* are stored in ascending order in _distanceArray. _distanceNeigh contains for each distance the lowest
+	* index of a lattice site with this distance to the center site. Same result as neighbor_distances_direct()
+	* in O(N log N).
+	*/
+
+	if (!_latticeCoordArray)
+	{
+		std::cout << "_latticeCoordArray does not exist.Call Createmiller_idx_lattice()!" << std::endl;
+		exit(0);
+	}
+	find_center_site();
+
+	std::vector<std::pair<double, int>> distances;
+	distances.reserve(_numberAtoms);
+	for (int i = 0; i < _numberAtoms; ++i)
+	{
+		if (i != _centerSite)
+		{
+			distances.push_back(std::make_pair(MyMath::norm(MyMath::difference(_latticeCoordArray[_centerSite],
+				_latticeCoordArray[i])), i));
+		}
+	}
+	std::sort(distances.begin(), distances.end());
+
+	// distances differing by less than PRECISION are equal; the lowest lattice site index represents them
+	std::vector<double> differentDistances;
+	std::vector<int> distanceNeighbors;
+	int begin = 0;
+	while (begin < distances.size())
+	{
+		int end = begin + 1;
+		int neighbor = distances[begin].second;
+		double distance = distances[begin].first;
+		while (end < distances.size() && distances[end].first - distances[end - 1].first < PRECISION)
+		{
+			if (distances[end].second < neighbor)
+			{
+				neighbor = distances[end].second;
+				distance = distances[end].first;
+			}
+			++end;
+		}
+		if (distance > PRECISION)
+		{
+			differentDistances.push_back(distance);
+			distanceNeighbors.push_back(neighbor);
+		}
+		begin = end;
+	}
+
+	delete[] _distanceArray;
+	_distanceArray = new double[differentDistances.size()];
+	delete[] _distanceNeigh;
+	_distanceNeigh = new int[differentDistances.size()];
+	for (int i = 0; i < differentDistances.size(); ++i)
+	{
+		_distanceArray[i] = differentDistances[i];
+		_distanceNeigh[i] = distanceNeighbors[i];
+	}
+	_radiusMax = differentDistances.size();
+}
+
+void Lattice::assign_neighbors(void)
+{
+	/**
+	* Assigns the neighbors of the first (up to) eight orders to all lattice sites. Lattice sites are sorted
+	* into cells with an edge length of the largest neighbor distance so that only adjacent cells have to be
+	* searched. Same result as assign_neighbors_direct() in O(N): the neighbors of each site are stored in
+	* ascending order of their indexes, followed by -1 entries.
+	*/
+
+	if (_radiusMax == 0)
+	{
+		std::cout
+			<< "The matrix with the nearest distances does not exist or neighGrade is lager than the number of calculated neighbor distances in the distance matrix."
+			<< std::endl;
+		return;
+	}
+
+	int maxNeigh = std::min(_radiusMax, 8);
+	double precision = 0.01;
+	double cutoff = _distanceArray[maxNeigh - 1] + precision;
+
+	// cell list
+	Threedim min = _latticeCoordArray[0];
+	Threedim max = _latticeCoordArray[0];
+	for (int i = 1; i < _numberAtoms; ++i)
+	{
+		min = { std::min(min.x, _latticeCoordArray[i].x), std::min(min.y, _latticeCoordArray[i].y),
+			std::min(min.z, _latticeCoordArray[i].z) };
+		max = { std::max(max.x, _latticeCoordArray[i].x), std::max(max.y, _latticeCoordArray[i].y),
+			std::max(max.z, _latticeCoordArray[i].z) };
+	}
+	double cellSize = cutoff;
+	int cells[3];
+	while (true)
+	{
+		cells[0] = (int)((max.x - min.x) / cellSize) + 1;
+		cells[1] = (int)((max.y - min.y) / cellSize) + 1;
+		cells[2] = (int)((max.z - min.z) / cellSize) + 1;
+		// sparse lattices: limit number of (empty) cells
+		if ((long long)cells[0] * cells[1] * cells[2] <= 8LL * _numberAtoms + 27)
+		{
+			break;
+		}
+		cellSize *= 2;
+	}
+	int numberCells = cells[0] * cells[1] * cells[2];
+	std::vector<int> cellOfSite(_numberAtoms);
+	std::vector<int> cellStart(numberCells + 1, 0);
+	for (int i = 0; i < _numberAtoms; ++i)
+	{
+		int cx = std::min((int)((_latticeCoordArray[i].x - min.x) / cellSize), cells[0] - 1);
+		int cy = std::min((int)((_latticeCoordArray[i].y - min.y) / cellSize), cells[1] - 1);
+		int cz = std::min((int)((_latticeCoordArray[i].z - min.z) / cellSize), cells[2] - 1);
+		cellOfSite[i] = (cx * cells[1] + cy) * cells[2] + cz;
+		++cellStart[cellOfSite[i] + 1];
+	}
+	for (int c = 0; c < numberCells; ++c)
+	{
+		cellStart[c + 1] += cellStart[c];
+	}
+	std::vector<int> cellSites(_numberAtoms);
+	std::vector<int> cellFill(cellStart.begin(), cellStart.end() - 1);
+	for (int i = 0; i < _numberAtoms; ++i)
+	{
+		cellSites[cellFill[cellOfSite[i]]++] = i;
+	}
+
+	// all lattice sites within adjacent cells in ascending order of their indexes
+	auto candidates = [&](int i, std::vector<int> &sites)
+	{
+		sites.clear();
+		int cx = cellOfSite[i] / (cells[1] * cells[2]);
+		int cy = (cellOfSite[i] / cells[2]) % cells[1];
+		int cz = cellOfSite[i] % cells[2];
+		for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, cells[0] - 1); ++x)
+		{
+			for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, cells[1] - 1); ++y)
+			{
+				for (int z = std::max(cz - 1, 0); z <= std::min(cz + 1, cells[2] - 1); ++z)
+				{
+					int c = (x * cells[1] + y) * cells[2] + z;
+					for (int n = cellStart[c]; n < cellStart[c + 1]; ++n)
+					{
+						if (cellSites[n] != i)
+						{
+							sites.push_back(cellSites[n]);
+						}
+					}
+				}
+			}
+		}
+		std::sort(sites.begin(), sites.end());
+	};
+
+	// number of neighbors of each order
+	std::vector<int> numberNeighbors(maxNeigh * _numberAtoms, 0);
+	#pragma omp parallel
+	{
+		std::vector<int> sites;
+		#pragma omp for schedule(static)
+		for (int i = 0; i < _numberAtoms; ++i)
+		{
+			candidates(i, sites);
+			for (int n = 0; n < sites.size(); ++n)
+			{
+				double norm = MyMath::norm(MyMath::difference(_latticeCoordArray[sites[n]], _latticeCoordArray[i]));
+				for (int k = 0; k < maxNeigh; ++k)
+				{
+					if (fabs(norm - _distanceArray[k]) < precision)
+					{
+						++numberNeighbors[k * _numberAtoms + i];
+					}
+				}
+			}
+		}
+	}
+
+	int* neighborArrays[8];
+	Threedim* neighborVectorArrays[8];
+	for (int k = 0; k < maxNeigh; ++k)
+	{
+		int numNeigh = *std::max_element(numberNeighbors.begin() + k * _numberAtoms,
+			numberNeighbors.begin() + (k + 1) * _numberAtoms);
+		neighborVectorArrays[k] = NULL;
+		switch (k)
+		{
+		case 0:
+			delete[] _firstNeighborArray;
+			_firstNeighborArray = new int[_numberAtoms * numNeigh];
+			neighborArrays[k] = _firstNeighborArray;
+			delete[] _firstNeighborVectorArray;
+			_firstNeighborVectorArray = new Threedim[_numberAtoms * numNeigh];
+			neighborVectorArrays[k] = _firstNeighborVectorArray;
+			break;
+		case 1:
+			delete[] _secondNeighborArray;
+			_secondNeighborArray = new int[_numberAtoms * numNeigh];
+			neighborArrays[k] = _secondNeighborArray;
+			delete[] _secondNeighborVectorArray;
+			_secondNeighborVectorArray = new Threedim[_numberAtoms * numNeigh];
+			neighborVectorArrays[k] = _secondNeighborVectorArray;
+			break;
+		case 2:
+			delete[] _thirdNeighborArray;
+			_thirdNeighborArray = new int[_numberAtoms * numNeigh];
+			neighborArrays[k] = _thirdNeighborArray;
+			delete[] _thirdNeighborVectorArray;
+			_thirdNeighborVectorArray = new Threedim[_numberAtoms * numNeigh];
+			neighborVectorArrays[k] = _thirdNeighborVectorArray;
+			break;
+		case 3:
+			delete[] _fourthNeighborArray;
+			_fourthNeighborArray = new int[_numberAtoms * numNeigh];
+			neighborArrays[k] = _fourthNeighborArray;
+			delete[] _fourthNeighborVectorArray;
+			_fourthNeighborVectorArray = new Threedim[_numberAtoms * numNeigh];
+			neighborVectorArrays[k] = _fourthNeighborVectorArray;
+			break;
+		case 4:
+			delete[] _fifthNeighborArray;
+			_fifthNeighborArray = new int[_numberAtoms * numNeigh];
+			neighborArrays[k] = _fifthNeighborArray;
+			delete[] _fifthNeighborVectorArray;
+			_fifthNeighborVectorArray = new Threedim[_numberAtoms * numNeigh];
+			neighborVectorArrays[k] = _fifthNeighborVectorArray;
+			break;
+		case 5:
+			delete[] _sixthNeighborArray;
+			_sixthNeighborArray = new int[_numberAtoms * numNeigh];
+			neighborArrays[k] = _sixthNeighborArray;
+			break;
+		case 6:
+			delete[] _seventhNeighborArray;
+			_seventhNeighborArray = new int[_numberAtoms * numNeigh];
+			neighborArrays[k] = _seventhNeighborArray;
+			break;
+		case 7:
+			delete[] _eighthNeighborArray;
+			_eighthNeighborArray = new int[_numberAtoms * numNeigh];
+			neighborArrays[k] = _eighthNeighborArray;
+			break;
+		}
+		_numberNthNeighbors[k] = numNeigh;
+		for (int i = 0; i < _numberAtoms * numNeigh; ++i)
+		{ // default value is -1 for no neighbor
+			neighborArrays[k][i] = -1;
+		}
+	}
+
+	#pragma omp parallel
+	{
+		std::vector<int> sites;
+		int count[8];
+		#pragma omp for schedule(static)
+		for (int i = 0; i < _numberAtoms; ++i)
+		{
+			candidates(i, sites);
+			std::fill(count, count + 8, 0);
+			for (int n = 0; n < sites.size(); ++n)
+			{
+				int j = sites[n];
+				double norm = MyMath::norm(MyMath::difference(_latticeCoordArray[j], _latticeCoordArray[i]));
+				for (int k = 0; k < maxNeigh; ++k)
+				{
+					if (fabs(norm - _distanceArray[k]) < precision)
+					{
+						int index = i * _numberNthNeighbors[k] + count[k];
+						neighborArrays[k][index] = j;
+						if (neighborVectorArrays[k] != NULL)
+						{
+							neighborVectorArrays[k][index] = MyMath::difference(_latticeCoordArray[j],
+								_latticeCoordArray[i]);
+						}
+						++count[k];
+					}
+				}
+			}
+		}
+	}
+}
+
+int Lattice::compare_neighbor_search(void)
+{
+	/**
+	* Benchmark of the neighbor search. Runs neighbor_distances() and assign_neighbors() as well as the
+	* reference implementations and compares the results bit by bit. The neighbor information of the
+	* reference implementation is kept.
+	*
+	* @return TRUE if both implementations give identical results, FALSE otherwise.
+	*/
+
+	auto start = std::chrono::steady_clock::now();
+	neighbor_distances();
+	assign_neighbors();
+	double timeCellList = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	int radiusMax = _radiusMax;
+	std::vector<double> distances(_distanceArray, _distanceArray + _radiusMax);
+	std::vector<int> distanceNeighbors(_distanceNeigh, _distanceNeigh + _radiusMax);
+	int maxNeigh = std::min(_radiusMax, 8);
+	std::vector<std::vector<int>> neighbors(maxNeigh);
+	std::vector<std::vector<Threedim>> neighborVectors(maxNeigh);
+	for (int k = 0; k < maxNeigh; ++k)
+	{
+		int* neighborArray = get_neighbor_array(k + 1);
+		neighbors[k].assign(neighborArray, neighborArray + _numberAtoms * _numberNthNeighbors[k]);
+		Threedim* neighborVectorArray = get_neighbor_vector_array(k + 1);
+		if (neighborVectorArray != NULL)
+		{
+			neighborVectors[k].assign(neighborVectorArray, neighborVectorArray + _numberAtoms * _numberNthNeighbors[k]);
+		}
+	}
+
+	start = std::chrono::steady_clock::now();
+	neighbor_distances_direct();
+	assign_neighbors_direct();
+	double timeDirect = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	int identical = (radiusMax == _radiusMax);
+	if (identical == TRUE)
+	{
+		identical = std::memcmp(distances.data(), _distanceArray, sizeof(double) * _radiusMax) == 0
+			&& std::memcmp(distanceNeighbors.data(), _distanceNeigh, sizeof(int) * _radiusMax) == 0;
+	}
+	for (int k = 0; k < maxNeigh && identical == TRUE; ++k)
+	{
+		identical = (neighbors[k].size() == _numberAtoms * _numberNthNeighbors[k])
+			&& std::memcmp(neighbors[k].data(), get_neighbor_array(k + 1), sizeof(int) * neighbors[k].size()) == 0;
+		if (identical == TRUE && neighborVectors[k].size() > 0)
+		{
+			identical = std::memcmp(neighborVectors[k].data(), get_neighbor_vector_array(k + 1),
+				sizeof(Threedim) * neighborVectors[k].size()) == 0;
+		}
+	}
+
+	std::cout << "Neighbor search for " << _numberAtoms << " lattice sites: cell list " << timeCellList
+		<< " s, direct " << timeDirect << " s, results " << (identical == TRUE ? "identical" : "DIFFERENT")
+		<< std::endl;
+	return identical;
+}
+
 int Lattice::is_neighbor(const int &pos1, const int &pos2) const
 {
 	/*
@@ -2155,6 +2511,120 @@ int Lattice::is_neighbor(const int &pos1, const int &pos2) const
 	return isneigh;
 }
 
+std::vector<std::vector<int>> Lattice::create_color_classes(const std::vector<int> &orders, int boolFourSpin,
+	int boolThreeSite) const
+{
+	/**
+	* Partition the lattice sites into classes of sites that do not interact with each other (greedy graph
+	* coloring). Two sites interact if they are nth neighbors for one of the given orders or if they belong
+	* to a common four-spin or three-site cell. The spins of one class can be updated simultaneously.
+	*
+	* @param[in] orders Orders of neighbor shells included in the Hamiltonian
+	* @param[in] boolFourSpin TRUE if four-spin cells are included in the Hamiltonian
+	* @param[in] boolThreeSite TRUE if three-site cells are included in the Hamiltonian
+	*
+	* @return Lattice site indexes for each class.
+	*/
+
+	// interaction partners of each lattice site
+	std::vector<std::vector<int>> partners(_numberAtoms);
+
+	for (int i = 0; i < orders.size(); ++i)
+	{
+		int* neighborArray = get_neighbor_array(orders[i]);
+		if (neighborArray == NULL)
+		{
+			continue;
+		}
+		int nbors = get_number_nth_neighbors(orders[i]);
+		for (int pos = 0; pos < _numberAtoms; ++pos)
+		{
+			for (int j = 0; j < nbors; ++j)
+			{
+				int neighbor = neighborArray[nbors * pos + j];
+				if (neighbor != -1) // -1 refers to empty entry
+				{
+					partners[pos].push_back(neighbor);
+					partners[neighbor].push_back(pos);
+				}
+			}
+		}
+	}
+
+	if (boolFourSpin == TRUE && _fourSpinCells != NULL)
+	{
+		for (int i = 0; i < _numberAtoms * _fourSpinCellsPerAtom; ++i)
+		{
+			if (_fourSpinCells[i].i > -1)
+			{
+				int cell[4] = { _fourSpinCells[i].i, _fourSpinCells[i].j, _fourSpinCells[i].k,
+					_fourSpinCells[i].l };
+				for (int j = 0; j < 4; ++j)
+				{
+					for (int k = 0; k < 4; ++k)
+					{
+						if (j != k)
+						{
+							partners[cell[j]].push_back(cell[k]);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if (boolThreeSite == TRUE && _threeSiteCells != NULL)
+	{
+		for (int i = 0; i < _numberAtoms * _threeSiteCellsPerAtom; ++i)
+		{
+			if (_threeSiteCells[i].i > -1)
+			{
+				int cell[3] = { _threeSiteCells[i].i, _threeSiteCells[i].j, _threeSiteCells[i].k };
+				for (int j = 0; j < 3; ++j)
+				{
+					for (int k = 0; k < 3; ++k)
+					{
+						if (j != k)
+						{
+							partners[cell[j]].push_back(cell[k]);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// greedy coloring: each site obtains the smallest color not used by any of its interaction partners
+	std::vector<int> color(_numberAtoms, -1);
+	std::vector<int> usedBy; // usedBy[c] == pos if color c is used by a partner of pos
+	std::vector<std::vector<int>> colorClasses;
+	for (int pos = 0; pos < _numberAtoms; ++pos)
+	{
+		for (int j = 0; j < partners[pos].size(); ++j)
+		{
+			int partnerColor = color[partners[pos][j]];
+			if (partnerColor > -1)
+			{
+				usedBy[partnerColor] = pos;
+			}
+		}
+		int c = 0;
+		while (c < usedBy.size() && usedBy[c] == pos)
+		{
+			++c;
+		}
+		if (c == usedBy.size())
+		{
+			usedBy.push_back(-1);
+			colorClasses.push_back({});
+		}
+		color[pos] = c;
+		colorClasses[c].push_back(pos);
+	}
+
+	return colorClasses;
+}
+
 void Lattice::show_lattice_coordinates(void) const
 {
 	/*
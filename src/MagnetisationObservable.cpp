@@ -24,21 +24,25 @@
 
 //forward and further includes
 #include "SpinOrientation.h"
+#include "ObservableEngine.h"
 #include "MyMath.h"
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 
 MagnetisationObservable::MagnetisationObservable(int numberMeasurements, SpinOrientation* spinOrientation, 
-	int boolEachSpin) :
+	int boolEachSpin, std::shared_ptr<ObservableEngine> engine) :
 	Observable(numberMeasurements)
 {
 	/**
 	* @param[in] numberMeasurements Number of measurements.
 	* @param[in] spinOrientation Information about spin configuration.
 	* @param[in] boolEachSpin 1 to obtain spin resolved information, 0 to suppress spin resolved information
+	* @param[in] engine Evaluates the magnetization before take_value is called
 	*/
 
 	_spinOrientation = spinOrientation;
+	_engine = engine;
 	_boolEachSpin = boolEachSpin;
 	_numberAtoms = spinOrientation->get_number_atoms();
 	_valuesSpinResolved = NULL;
@@ -95,6 +99,10 @@ std::string MagnetisationObservable::get_mean_header(void) const
 	
 	header.append(get_steps_header());
 	header.append("SUS ");
+	if (_boolErrorAnalysis == TRUE)
+	{
+		header.append("dMx dMy dMz tau_M dSUS ");
+	}
 
 	return header;
 }
@@ -104,13 +112,18 @@ void MagnetisationObservable::take_value(void)
 	/**
 	* Make a measurement on the system.
 	*/
-	_values[_measurementIndex] = _spinOrientation->magnetisation();
+	int index = storage_index(_measurementIndex);
+	_values[index] = _engine->get_magnetisation();
+	_statistics[0].add(_values[index].x);
+	_statistics[1].add(_values[index].y);
+	_statistics[2].add(_values[index].z);
 	if (_boolEachSpin == TRUE)
 	{
-		Threedim* tmpPntr = _valuesSpinResolved + _measurementIndex * _numberAtoms;
+		Threedim* tmpPntr = _valuesSpinResolved + index * _numberAtoms;
 		for (int i = 0; i < _numberAtoms; i++, tmpPntr++)
 		{
 			*tmpPntr = _spinOrientation->get_spin(i);
+			_spinSums[i] = MyMath::add(_spinSums[i], *tmpPntr);
 		}
 	}
 	++_measurementIndex;
@@ -121,7 +134,7 @@ std::string MagnetisationObservable::get_step_value(const int &index) const
 	/**
 	* Get a measurement result that has been taken.
 	*
-	* @param[in] _i Index of a measurement result.
+	* @param[in] _i Index of a measurement result. In accumulator mode only the last measurement is available.
 	*
 	* @return The measurement result as a std::string.
 	*/
@@ -129,11 +142,12 @@ std::string MagnetisationObservable::get_step_value(const int &index) const
 	stream << std::setprecision(15);
 	if (index < _numberMeasurements)
 	{
-		stream << _values[index].x / _numberAtoms << " "  << _values[index].y / _numberAtoms << " "
-		 << _values[index].z / _numberAtoms;
+		int storageIndex = storage_index(index);
+		stream << _values[storageIndex].x / _numberAtoms << " "  << _values[storageIndex].y / _numberAtoms << " "
+		 << _values[storageIndex].z / _numberAtoms;
 		if (_boolEachSpin == TRUE)
 		{
-			Threedim* tmpPntr = _valuesSpinResolved + index * _numberAtoms;
+			Threedim* tmpPntr = _valuesSpinResolved + storageIndex * _numberAtoms;
 			for (int i = 0; i < _numberAtoms; i++, tmpPntr++)
 			{
 				stream << " " << (*tmpPntr).x << " " << (*tmpPntr).y << " " << (*tmpPntr).z;
@@ -158,16 +172,9 @@ std::string MagnetisationObservable::get_mean_value(const double &temperature) c
 	*/
 	std::stringstream stream;
 	stream << std::setprecision(15);
-	if (_measurementIndex == _numberMeasurements)
+	if (measurements_complete() == TRUE)
 	{
-		Threedim meanValues = {0,0,0};
-		for (int i = 0; i < _numberMeasurements; ++i)
-		{
-			meanValues.x += _values[i].x;
-			meanValues.y += _values[i].y;
-			meanValues.z += _values[i].z;
-		}
-		meanValues = MyMath::mult(meanValues, 1 / (double)_numberMeasurements);
+		Threedim meanValues = { _statistics[0].get_mean(), _statistics[1].get_mean(), _statistics[2].get_mean() };
 		meanValues = MyMath::mult(meanValues, 1 / (double)_numberAtoms);
 
 		stream  << meanValues.x << " "  << meanValues.y << " " << meanValues.z << " ";
@@ -175,28 +182,39 @@ std::string MagnetisationObservable::get_mean_value(const double &temperature) c
 		if (_boolEachSpin == TRUE)
 		{
 			Threedim spinAverage = { 0,0,0 };
-			Threedim* tmpPntr = NULL;
-			for (int i = 0; i < _numberAtoms; i++, tmpPntr++)
+			for (int i = 0; i < _numberAtoms; i++)
 			{
-				spinAverage = { 0,0,0 };
-				for (int j = 0; j < _numberMeasurements; j++)
-				{
-					tmpPntr = _valuesSpinResolved + j * _numberAtoms + i;
-					spinAverage = MyMath::add(spinAverage, *tmpPntr);
-				}
-				spinAverage = MyMath::mult(spinAverage, 1 / (double)_numberMeasurements);
+				spinAverage = MyMath::mult(_spinSums[i], 1 / (double)_measurementIndex);
 				stream << " " << spinAverage.x << " " << spinAverage.y << " " << spinAverage.z;
 			}
 		}
 		
-		double esq = 0;
-		for (int i = 0; i < _numberMeasurements; ++i)
+		// <M**2> - <M>**2
+		double variance = _statistics[0].get_population_variance() + _statistics[1].get_population_variance()
+			+ _statistics[2].get_population_variance();
+		stream << variance / (kB * temperature) << " ";
+
+		if (_boolErrorAnalysis == TRUE)
 		{
-			esq += _values[i].x * _values[i].x + _values[i].y * _values[i].y + _values[i].z * _values[i].z;
+			// errors of mean components, largest autocorrelation time of components, jackknife error of
+			// susceptibility
+			double autocorrelationTime = 0;
+			std::vector<double> variances;
+			std::vector<double> componentVariances;
+			for (int i = 0; i < 3; ++i)
+			{
+				stream << _statistics[i].get_error() / _numberAtoms << " ";
+				autocorrelationTime = std::max(autocorrelationTime, _statistics[i].get_autocorrelation_time());
+				_statistics[i].jackknife_variances(componentVariances, FALSE);
+				variances.resize(componentVariances.size(), 0);
+				for (int k = 0; k < componentVariances.size(); ++k)
+				{
+					variances[k] += componentVariances[k];
+				}
+			}
+			stream << autocorrelationTime << " " 
+				<< RunningStatistics::jackknife_error(variances) / (kB * temperature) << " ";
 		}
-		meanValues = MyMath::mult(meanValues, _numberAtoms);
-		esq /= _numberMeasurements;
-		stream << (esq - MyMath::dot_product(meanValues, meanValues)) / (kB * temperature) << " ";
 	}
 	return stream.str();
 }
@@ -204,7 +222,16 @@ std::string MagnetisationObservable::get_mean_value(const double &temperature) c
 void MagnetisationObservable::clear_storage()
 {
 	delete[] _values;
-	_values = new Threedim[_numberMeasurements];
+	_values = new Threedim[get_storage_size()];
 	delete[] _valuesSpinResolved;
-	_valuesSpinResolved = new Threedim[_numberMeasurements * _numberAtoms];
+	_valuesSpinResolved = NULL;
+	if (_boolEachSpin == TRUE)
+	{
+		_valuesSpinResolved = new Threedim[get_storage_size() * _numberAtoms];
+		_spinSums.assign(_numberAtoms, Threedim{ 0,0,0 });
+	}
+	for (int i = 0; i < 3; ++i)
+	{
+		_statistics[i].clear();
+	}
 }
@@ -22,14 +22,25 @@
 
 #include "Measurement.h"
 
-Measurement::Measurement(std::vector<std::shared_ptr<Observable>> observables):
-	_meanBody("")
+#include "ObservableEngine.h"
+
+#include <algorithm>
+#include <iomanip>
+
+// minimum number of measurements before a run may be stopped because the target error is reached
+#define MIN_MEASUREMENTS_TARGET_ERROR 1024
+
+Measurement::Measurement(std::vector<std::shared_ptr<Observable>> observables,
+	std::shared_ptr<ObservableEngine> engine):
+	_meanBody(""), _boolAccumulate(FALSE), _stepWidth(0)
 {
 	/**
 	* @param[in] observables Pointers to observables.
+	* @param[in] engine Engine the observables were created with. May be empty if there are no observables.
 	*/
 
 	_observables = observables; // pointer on array of pointers on observables
+	_engine = engine;
 }
 
 Measurement::~Measurement()
@@ -51,14 +62,29 @@ void Measurement::set_number_measurements(int numMeasurements)
 void Measurement::measure(void)
 {
 	/**
-	* Perform measurements on the system.
+	* Perform measurements on the system. The engine evaluates the quantities of all observables in one pass
+	* over the spin configuration; the observables then store them.
 	*/
 
+	if (_engine && _observables.size() > 0)
+	{
+		_engine->evaluate();
+	}
 	for (int i = 0; i < _observables.size(); ++i)
 	{
 		_observables[i]->take_value();
 	}
 
+	if (_stepStream.is_open())
+	{
+		int measurementIndex = _observables[0]->get_measurement_index();
+		_stepStream << _stepWidth * measurementIndex << " ";
+		for (int i = 0; i < _observables.size(); ++i)
+		{
+			_stepStream << _observables[i]->get_step_value(measurementIndex - 1);
+		}
+		_stepStream << "\n";
+	}
 }
 
 void Measurement::take_mean_values(std::string variable, double temperature)
@@ -89,10 +115,124 @@ void Measurement::reset_observables_measurement_index(void)
 	for (int j = 0; j < _observables.size(); ++j)
 	{
 		_observables[j]->set_measurement_index(0);
+		_observables[j]->set_stopped_early(FALSE);
 		_observables[j]->clear_storage();
 	}
 }
 
+void Measurement::set_accumulate(int boolAccumulate)
+{
+	/**
+	* @param[in] boolAccumulate TRUE: observables store only the last measurement, step values are written to
+	*                           file during the run (open_step_output). FALSE: all measurements of a run are 
+	*                           stored and can be saved afterwards (save_step_values).
+	*/
+
+	_boolAccumulate = boolAccumulate;
+	for (int i = 0; i < _observables.size(); ++i)
+	{
+		_observables[i]->set_accumulate(boolAccumulate);
+	}
+}
+
+int Measurement::get_accumulate(void) const
+{
+	return _boolAccumulate;
+}
+
+void Measurement::set_error_analysis(int boolErrorAnalysis)
+{
+	/**
+	* @param[in] boolErrorAnalysis TRUE: mean values of the observables are followed by their standard errors
+	*                              (blocking analysis), autocorrelation times and jackknife errors of heat 
+	*                              capacity and susceptibility
+	*/
+
+	for (int i = 0; i < _observables.size(); ++i)
+	{
+		_observables[i]->set_error_analysis(boolErrorAnalysis);
+	}
+}
+
+int Measurement::target_error_reached(double targetRelativeError) const
+{
+	/**
+	* At least MIN_MEASUREMENTS_TARGET_ERROR measurements are required so that the blocking analysis covers
+	* block sizes beyond the autocorrelation time. Observables without a relative error are not considered.
+	*
+	* @param[in] targetRelativeError Target relative error of the mean values
+	*
+	* @return TRUE if the run can be stopped
+	*/
+
+	if (_observables.size() == 0 || _observables[0]->get_measurement_index() < MIN_MEASUREMENTS_TARGET_ERROR)
+	{
+		return FALSE;
+	}
+	double relativeError = 0;
+	for (int i = 0; i < _observables.size(); ++i)
+	{
+		relativeError = std::max(relativeError, _observables[i]->get_relative_error());
+	}
+	return (relativeError < targetRelativeError) ? TRUE : FALSE;
+}
+
+void Measurement::stop_early(void)
+{
+	for (int i = 0; i < _observables.size(); ++i)
+	{
+		_observables[i]->set_stopped_early(TRUE);
+	}
+}
+
+void Measurement::open_step_output(std::string fname, std::string stepHeader, double simStepWidth)
+{
+	/**
+	* Only in accumulator mode and if there are any observables. The file has the same format as the file 
+	* written by save_step_values.
+	*
+	* @param[in] fname The name of the output file name
+	* @param[in] stepHeader The name of the steps. e.g. MCStep or LLGStep
+	* @param[in] simStepWidth The step width between two successive measurements
+	*/
+
+	close_step_output();
+	if (_boolAccumulate == FALSE || _observables.size() == 0)
+	{
+		return;
+	}
+	_stepWidth = simStepWidth;
+	_stepStream.open(fname, std::ofstream::out);
+	_stepStream << std::setprecision(15);
+	_stepStream << stepHeader << " ";
+	for (int i = 0; i < _observables.size(); ++i)
+	{
+		_stepStream << _observables[i]->get_steps_header();
+	}
+	_stepStream << "\n";
+}
+
+void Measurement::close_step_output(void)
+{
+	if (_stepStream.is_open())
+	{
+		_stepStream.close();
+	}
+}
+
+void Measurement::transfer_mean_values(Measurement &measurement)
+{
+	/**
+	* Appends the mean values stored so far to the mean values of another measurement object with the same
+	* types of observables, e.g. to save the mean values of several replicas of the spin system in one file.
+	*
+	* @param[in] measurement Measurement object which receives the mean values.
+	*/
+
+	measurement._meanBody.append(_meanBody);
+	_meanBody.clear();
+}
+
 void Measurement::save_mean_steps(std::string fname, std::string variableName)
 {
 	/**
@@ -105,7 +245,19 @@ void Measurement::save_mean_steps(std::string fname, std::string variableName)
 
 	std::fstream filestr;
 	filestr.open(fname, std::fstream::out);
+	filestr << mean_steps_text(variableName);
+	filestr.close();
+}
 
+std::string Measurement::mean_steps_text(std::string variableName)
+{
+	/**
+	* @param[in] variableHeader The name(s) of the variable(s) for which the measurements are done.
+	*
+	* @return Mean values of the observables as stored by save_mean_steps
+	*/
+
+	std::stringstream filestr;
 	filestr << variableName << " ";
 	for (int i = 0; i < _observables.size(); ++i)
 	{
@@ -113,5 +265,5 @@ void Measurement::save_mean_steps(std::string fname, std::string variableName)
 	}
 	filestr << std::endl;
 	filestr << _meanBody;
-	filestr.close();
+	return filestr.str();
 }
\ No newline at end of file
@@ -22,8 +22,9 @@
 #include "Mersenne.h"
 
 #include <algorithm>
+#include <cstdint>
 
-Mersenne::Mersenne(int seed): _mt(seed)
+Mersenne::Mersenne(int seed): _mt(seed), _uniform(0, 1)
 {
 }
 
@@ -45,8 +46,45 @@ double Mersenne::Random(void)
 	/**
 	* Pseudo random number uniformly drawn from inerval [0,1)
 	*/
-	std::uniform_real_distribution<double> dist(0, 1);
-	return dist(_mt);
+	return _uniform(_mt);
+}
+
+void Mersenne::set_seed(int seed)
+{
+	_mt.seed(seed);
+}
+
+void Mersenne::set_stream(int seed, int stream)
+{
+	_mt.seed(stream_seed(seed, stream));
+}
+
+std::shared_ptr<RanGen> Mersenne::split(void)
+{
+	/**
+	* @return Mersenne twister with a seed drawn from this generator
+	*/
+
+	return std::make_shared<Mersenne>(IRandom(0, 2147483646));
+}
+
+int Mersenne::stream_seed(int seed, int stream)
+{
+	/**
+	* Derives a seed for each of several generators from a single seed. Seeds of neighboring streams differ 
+	* in many bits (splitmix64 finalizer), so the streams are not correlated.
+	*
+	* @param[in] seed Seed specified by user
+	* @param[in] stream Index of stream
+	*
+	* @return Seed for stream
+	*/
+
+	uint64_t z = ((uint64_t)(uint32_t)seed << 32) + (uint32_t)stream + 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z = z ^ (z >> 31);
+	return (int)(z & 0x7FFFFFFF);
 }
 
 void Mersenne::Shuffle(std::vector<int>& vector)
@@ -24,8 +24,20 @@
 
 //forward and further includes
 #include "SpinOrientation.h"
+#include "SpinOrientationHeisenbergRestrictedCone.h"
 #include "RanGen.h"
 #include "Hamiltonian.h"
+#include "MyMath.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <iostream>
+
+// change of log(sigma) per step of adaptation for unit deviation of acceptance from target
+#define CONE_ADAPTATION_GAIN 1.0
+// limits of cone width; for large sigma the trial spin is almost uniformly distributed
+#define CONE_SIGMA_MIN 1e-4
+#define CONE_SIGMA_MAX 10.0
 
 
 Metropolis::Metropolis(SpinOrientation* spinOrientation, int simulationSteps, double temperature, 
@@ -45,6 +57,15 @@ Metropolis::Metropolis(SpinOrientation* spinOrientation, int simulationSteps, do
 	{
 		_randomizedSiteList.push_back(_activeSites[i]);
 	}
+
+	_numberThreads = 1;
+	_heatBathFraction = 0;
+	_overRelaxationSweeps = 0;
+
+	_cone = NULL;
+	_targetAcceptance = 0.5;
+	_equilibrationSteps = 0;
+	_equilibrationStepsLeft = 0;
 }
 
 Metropolis::~Metropolis()
@@ -57,55 +78,459 @@ double Metropolis::simulation_step(void)
 	* This method performs a Monte-Carlo step according to the Metropolis algorithm. One simulation step
 	* consists of N trial steps where N is the number of lattice sites included in the simulation process.
 	* (Some lattice sites can be excluded from the simulation. See class SpinOrientation for more information)
+	* With set_kernels(), trial steps are replaced by heat-bath steps and followed by over-relaxation sweeps.
+	* With set_adaptive_cone(), the cone width is adapted after the step during equilibration.
+	*
+	* @return Acceptance rate of the trial steps.
 	*/
 
 	// helper value. lattice index determined randomly from array containing indexes of active lattice sites
 	int position = 0;
-	// energy difference between before and after random trial change
-	double deltaEnergy = 0;
-	// random Number between (0,1) to decline trial state with higher energy by certain probability
-	double randomNumber = 0;
-	// probability by which trial state is accepted
-	double boltzmann = 0;
+	// spin before and after random trial change
+	Threedim oldSpin = { 0,0,0 };
+	Threedim newSpin = { 0,0,0 };
 
 	int numberRejectedStates = 0;
 
+	if (!_colorClasses.empty())
+	{
+		return parallel_simulation_step();
+	}
+
+	Threedim* spinArray = _spinOrientation->get_spin_array();
+
 	_ranGen->Shuffle(_randomizedSiteList);
 
+	int boolAdapt = equilibrating();
+
 	// one Monte Carlo steps consists of as many trial steps as there are active lattice sites.
 	for (int i = 0; i < _numberActiveSites; ++i)
 	{ 
 		// choose a random active lattice site for trial change
 		position = _randomizedSiteList[i];
 		
-		// energy before random spin reorientation
-		deltaEnergy = _hamilton->single_energy(position);
+		// The spin configuration is only changed if the trial state is accepted.
+		oldSpin = spinArray[position];
+		int boolMetropolis = TRUE;
+		int boolAccepted = trial_step(position, *_ranGen, newSpin, boolMetropolis);
+		if (boolAdapt == TRUE && boolMetropolis == TRUE)
+		{
+			_coneAttempts[_coneGroupOfSite[position]] += 1;
+			_coneAccepted[_coneGroupOfSite[position]] += boolAccepted;
+		}
+		if (boolAccepted == FALSE)
+		{
+			numberRejectedStates += 1;
+			continue;
+		}
+		spinArray[position] = newSpin;
+		_hamilton->update_spin(position, oldSpin, newSpin);
+	}
+
+	// microcanonical sweeps
+	for (int sweep = 0; sweep < _overRelaxationSweeps; ++sweep)
+	{
+		for (int i = 0; i < _numberActiveSites; ++i)
+		{
+			position = _randomizedSiteList[i];
+			oldSpin = spinArray[position];
+			if (over_relaxation(position, *_ranGen, newSpin) == TRUE)
+			{
+				spinArray[position] = newSpin;
+				_hamilton->update_spin(position, oldSpin, newSpin);
+			}
+		}
+	}
+
+	if (boolAdapt == TRUE)
+	{
+		adapt_cone();
+	}
+	return (double)(_numberActiveSites-numberRejectedStates)/_numberActiveSites;
+}
+
+void Metropolis::set_kernels(double heatBathFraction, int overRelaxationSweeps)
+{
+	/**
+	* Heat-bath steps draw the new spin directly from the Boltzmann distribution in the effective field of the
+	* energies linear in the spin and are always accepted if all energies are linear. Over-relaxation steps
+	* reflect the spin about this field, which conserves the energy, and need no random numbers. Energies not
+	* linear in the spin (e.g. anisotropy, four-spin, three-site, biquadratic) are included by an additional
+	* Metropolis acceptance of their energy change. Only valid for Heisenberg spins.
+	*
+	* @param[in] heatBathFraction Probability of a heat-bath step instead of a Metropolis trial step at a site.
+	* @param[in] overRelaxationSweeps Number of over-relaxation sweeps after each sweep of trial steps.
+	*/
+
+	_heatBathFraction = std::min(std::max(heatBathFraction, 0.), 1.);
+	_overRelaxationSweeps = std::max(overRelaxationSweeps, 0);
+}
+
+void Metropolis::set_adaptive_cone(double targetAcceptance, int equilibrationSteps,
+	const std::vector<std::vector<int>> &siteGroups)
+{
+	/**
+	* After each change of the temperature, the first equilibrationSteps simulation steps adapt the width of 
+	* the cone of the trial steps (see SpinOrientationHeisenbergRestrictedCone) such that the acceptance of 
+	* the Metropolis trial steps approaches targetAcceptance. log(sigma) changes after every step 
+	* proportionally to the deviation of the acceptance from the target. The cone width is then kept fixed 
+	* and measurements are taken. The equilibration steps are performed by run_simulation in addition to the
+	* measured _simulationSteps. Each group of sites obtains its own cone width. The cone width of the 
+	* previous temperature is the starting point for the next temperature.
+	*
+	* @param[in] targetAcceptance Target acceptance of Metropolis trial steps. Typical value 0.5.
+	* @param[in] equilibrationSteps Number of simulation steps with adaptation.
+	* @param[in] siteGroups Lattice sites with common cone width (e.g. sublattices). Empty: one group.
+	*/
+
+	_cone = dynamic_cast<SpinOrientationHeisenbergRestrictedCone*>(_spinOrientation);
+	if (_cone == NULL)
+	{
+		std::cout << "Adaptive cone width requires trial steps restricted to a cone (sigma > 0)." << std::endl;
+		return;
+	}
+
+	_targetAcceptance = std::min(std::max(targetAcceptance, 0.01), 0.99);
+	_equilibrationSteps = std::max(equilibrationSteps, 0);
+	_equilibrationStepsLeft = _equilibrationSteps;
+
+	// only active sites are updated
+	std::vector<std::vector<int>> groups = siteGroups;
+	if (groups.empty())
+	{
+		groups.push_back(std::vector<int>(_activeSites, _activeSites + _numberActiveSites));
+	}
+	int* activityList = _spinOrientation->get_activity_list();
+	_coneGroups.clear();
+	_coneSigma.clear();
+	_coneGroupOfSite.assign(_spinOrientation->get_number_atoms(), -1);
+	for (int g = 0; g < groups.size(); ++g)
+	{
+		std::vector<int> activeSites;
+		for (int j = 0; j < groups[g].size(); ++j)
+		{
+			if (activityList[groups[g][j]] == 1 && _coneGroupOfSite[groups[g][j]] == -1)
+			{
+				activeSites.push_back(groups[g][j]);
+				_coneGroupOfSite[groups[g][j]] = _coneGroups.size();
+			}
+		}
+		if (!activeSites.empty())
+		{
+			_coneSigma.push_back(_cone->get_sigma(activeSites[0]));
+			_coneGroups.push_back(activeSites);
+		}
+	}
+	delete[] activityList;
+
+	// active sites not contained in any group
+	std::vector<int> remainingSites;
+	for (int i = 0; i < _numberActiveSites; ++i)
+	{
+		if (_coneGroupOfSite[_activeSites[i]] == -1)
+		{
+			remainingSites.push_back(_activeSites[i]);
+			_coneGroupOfSite[_activeSites[i]] = _coneGroups.size();
+		}
+	}
+	if (!remainingSites.empty())
+	{
+		_coneSigma.push_back(_cone->get_sigma(remainingSites[0]));
+		_coneGroups.push_back(remainingSites);
+	}
+
+	_coneAttempts.assign(_coneGroups.size(), 0);
+	_coneAccepted.assign(_coneGroups.size(), 0);
+}
+
+void Metropolis::set_temperature(double temperature)
+{
+	SimulationMethod::set_temperature(temperature);
+	_equilibrationStepsLeft = _equilibrationSteps;
+}
+
+void Metropolis::set_temperature_gradient(double temperatureMin, double temperatureMax, Threedim direction,
+	Lattice* lattice)
+{
+	SimulationMethod::set_temperature_gradient(temperatureMin, temperatureMax, direction, lattice);
+	_equilibrationStepsLeft = _equilibrationSteps;
+}
+
+int Metropolis::equilibrating(void) const
+{
+	return (_cone != NULL && _equilibrationStepsLeft > 0) ? TRUE : FALSE;
+}
+
+void Metropolis::adapt_cone(void)
+{
+	for (int g = 0; g < _coneGroups.size(); ++g)
+	{
+		if (_coneAttempts[g] > 0)
+		{
+			double acceptance = (double)_coneAccepted[g] / _coneAttempts[g];
+			_coneSigma[g] *= exp(CONE_ADAPTATION_GAIN * (acceptance - _targetAcceptance));
+			_coneSigma[g] = std::min(std::max(_coneSigma[g], CONE_SIGMA_MIN), CONE_SIGMA_MAX);
+			_cone->set_sigma(_coneSigma[g], _coneGroups[g]);
+		}
+		_coneAttempts[g] = 0;
+		_coneAccepted[g] = 0;
+	}
+	_equilibrationStepsLeft -= 1;
+}
+
+int Metropolis::trial_step(int position, RanGen &ranGen, Threedim &newSpin, int &boolMetropolis)
+{
+	/**
+	* @param[in] position Index of lattice site
+	* @param[in] ranGen Random number generator
+	* @param[out] newSpin Trial spin
+	* @param[out] boolMetropolis TRUE for a Metropolis, FALSE for a heat-bath step
+	*
+	* @return TRUE if the trial spin is accepted
+	*/
+
+	Threedim oldSpin = _spinOrientation->get_spin_array()[position];
+	double temperature = _temperature[position];
+
+	boolMetropolis = TRUE;
+	if (_heatBathFraction > 0 && (_heatBathFraction >= 1 || ranGen.Random() < _heatBathFraction))
+	{
+		boolMetropolis = FALSE;
+		newSpin = heat_bath_spin(_hamilton->linear_effective_field(position), temperature, ranGen);
+		if (_hamilton->get_number_nonlinear_energies() == 0)
+		{
+			return TRUE;
+		}
+		return accept_nonlinear(position, oldSpin, newSpin, ranGen);
+	}
 
-		// randomly reorientate the spin at the previously determined lattice site
-		this->_spinOrientation->single_orientation(position); 
+	// random reorientation of the spin
+	newSpin = _spinOrientation->trial_spin(position, ranGen);
 
-		// energy difference before and after reorientation. negative sign -> energy increased
-		deltaEnergy = deltaEnergy - _hamilton->single_energy(position);
+	// energy difference after and before reorientation. positive sign -> energy increased
+	double deltaEnergy = _hamilton->delta_energy(position, oldSpin, newSpin);
 
-		// if energy difference is positive, the energy decreased and the new state will be accepted. Nothing
-		// needs to be done in this case. If energy increased, the new configuration is accepted with a 
-		// probability according to a Boltzman factor.
-		if (deltaEnergy < 0)
+	// if energy difference is negative, the energy decreased and the new state will be accepted. If energy 
+	// increased, the new configuration is accepted with a probability according to a Boltzman factor.
+	if (deltaEnergy > 0 && ranGen.Random() > exp(-deltaEnergy / (temperature * kB)))
+	{
+		return FALSE;
+	}
+	return TRUE;
+}
+
+int Metropolis::over_relaxation(int position, RanGen &ranGen, Threedim &newSpin)
+{
+	/**
+	* The spin is rotated by pi about the effective field of the energies linear in the spin.
+	*
+	* @param[in] position Index of lattice site
+	* @param[in] ranGen Random number generator (only needed for non-linear energies)
+	* @param[out] newSpin Reflected spin
+	*
+	* @return TRUE if the reflected spin is accepted
+	*/
+
+	Threedim oldSpin = _spinOrientation->get_spin_array()[position];
+	Threedim field = _hamilton->linear_effective_field(position);
+	double field2 = MyMath::dot_product(field, field);
+	if (field2 == 0)
+	{
+		return FALSE;
+	}
+	newSpin = MyMath::normalize(MyMath::difference(
+		MyMath::mult(field, 2 * MyMath::dot_product(oldSpin, field) / field2), oldSpin));
+	if (_hamilton->get_number_nonlinear_energies() == 0)
+	{
+		return TRUE;
+	}
+	return accept_nonlinear(position, oldSpin, newSpin, ranGen);
+}
+
+Threedim Metropolis::heat_bath_spin(const Threedim &field, double temperature, RanGen &ranGen) const
+{
+	/**
+	* Spin S with probability density proportional to exp(S * field / (kB * temperature)). The cosine of the
+	* angle to the field is obtained by inversion of its cumulative distribution, the azimuth is uniform.
+	*
+	* @param[in] field Effective field [meV]
+	* @param[in] temperature Temperature [K]
+	* @param[in] ranGen Random number generator
+	*
+	* @return Normalised spin vector
+	*/
+
+	double fieldNorm = MyMath::norm(field);
+	double x = (temperature > 0) ? fieldNorm / (kB * temperature) : HUGE_VAL;
+
+	// axis and two perpendicular unit vectors
+	Threedim e = { 0, 0, 1 };
+	if (fieldNorm > 0)
+	{
+		e = MyMath::mult(field, 1. / fieldNorm);
+	}
+	Threedim helper = (fabs(e.x) < 0.9) ? Threedim{ 1, 0, 0 } : Threedim{ 0, 1, 0 };
+	Threedim e1 = MyMath::normalize(MyMath::vector_product(e, helper));
+	Threedim e2 = MyMath::vector_product(e, e1);
+
+	double cosTheta = 1;
+	double u = ranGen.Random();
+	if (x < 1e-12)
+	{
+		cosTheta = 2 * u - 1;
+	}
+	else if (x < HUGE_VAL)
+	{
+		// cos = 1 + ln(1 - (1 - u) (1 - exp(-2x))) / x
+		cosTheta = std::max(1 + log1p((1 - u) * expm1(-2 * x)) / x, -1.);
+	}
+	double sinTheta = sqrt(std::max(1 - cosTheta * cosTheta, 0.));
+	double phi = 2 * Pi * ranGen.Random();
+
+	return MyMath::normalize(MyMath::add(MyMath::mult(e, cosTheta), MyMath::add(
+		MyMath::mult(e1, sinTheta * cos(phi)), MyMath::mult(e2, sinTheta * sin(phi)))));
+}
+
+int Metropolis::accept_nonlinear(int position, const Threedim &oldSpin, const Threedim &newSpin,
+	RanGen &ranGen) const
+{
+	double deltaEnergy = _hamilton->nonlinear_delta_energy(position, oldSpin, newSpin);
+	if (deltaEnergy > 0 && ranGen.Random() > exp(-deltaEnergy / (_temperature[position] * kB)))
+	{
+		return FALSE;
+	}
+	return TRUE;
+}
+
+void Metropolis::set_parallel_sweep(const std::vector<std::vector<int>> &colorClasses, int numberThreads)
+{
+	/**
+	* Enable the parallel sweep. Sites of one class do not interact with each other and are updated 
+	* simultaneously, the classes are updated one after another in random order. Each thread draws its 
+	* random numbers from its own generator which is seeded from the generator of this object. For a given
+	* seed and number of threads the simulation is reproducible.
+	*
+	* @param[in] colorClasses Lattice sites partitioned into classes of non-interacting sites.
+	* @param[in] numberThreads Number of threads.
+	*/
+
+	_numberThreads = numberThreads;
+	_colorClasses.clear();
+	_randomizedColorList.clear();
+	_threadRanGens.clear();
+
+	// only active sites are updated
+	int* activityList = _spinOrientation->get_activity_list();
+	for (int i = 0; i < colorClasses.size(); ++i)
+	{
+		std::vector<int> activeSites;
+		for (int j = 0; j < colorClasses[i].size(); ++j)
 		{
-			// random number between (0,1)
-			randomNumber = _ranGen->Random();
-			// boltzmann factor
-			boltzmann = exp(deltaEnergy / (_temperature[position] * kB));
-			
-			// reject trial state if random number between (0,1) is larger than boltzmann factor
-			if (randomNumber > boltzmann)
+			if (activityList[colorClasses[i][j]] == 1)
 			{
-				// restore original orientation
-				_spinOrientation->restore_single_orientation(); 
+				activeSites.push_back(colorClasses[i][j]);
+			}
+		}
+		if (!activeSites.empty())
+		{
+			_randomizedColorList.push_back(_colorClasses.size());
+			_colorClasses.push_back(activeSites);
+		}
+	}
+	delete[] activityList;
+
+	for (int i = 0; i < _numberThreads; ++i)
+	{
+		_threadRanGens.push_back(_ranGen->split());
+	}
+
+	std::cout << "Parallel Metropolis sweep: " << _colorClasses.size() << " classes, " << _numberThreads
+		<< " threads." << std::endl;
+}
+
+double Metropolis::parallel_simulation_step(void)
+{
+	/**
+	* Monte-Carlo step according to the Metropolis algorithm where the sites of each class of non-interacting
+	* sites are updated in parallel. As in the serial sweep, each active site obtains one trial step.
+	*/
+
+	int numberRejectedStates = 0;
+
+	Threedim* spinArray = _spinOrientation->get_spin_array();
+
+	_ranGen->Shuffle(_randomizedColorList);
+
+	int boolAdapt = equilibrating();
+
+	for (int c = 0; c < _randomizedColorList.size(); ++c)
+	{
+		const std::vector<int> &colorClass = _colorClasses[_randomizedColorList[c]];
+		int classSize = colorClass.size();
 
+		// outcome of trial steps for adaptation of cone width
+		std::vector<int> metropolisSteps((boolAdapt == TRUE) ? classSize : 0);
+		std::vector<int> acceptedSteps((boolAdapt == TRUE) ? classSize : 0);
+
+#pragma omp parallel for num_threads(_numberThreads) schedule(static) reduction(+:numberRejectedStates)
+		for (int i = 0; i < classSize; ++i)
+		{
+			RanGen &ranGen = *_threadRanGens[omp_get_thread_num()];
+			int position = colorClass[i];
+
+			Threedim newSpin;
+			int boolMetropolis = TRUE;
+			int boolAccepted = trial_step(position, ranGen, newSpin, boolMetropolis);
+			if (boolAdapt == TRUE)
+			{
+				metropolisSteps[i] = boolMetropolis;
+				acceptedSteps[i] = boolAccepted;
+			}
+			if (boolAccepted == FALSE)
+			{
 				numberRejectedStates += 1;
 			}
+			else
+			{
+				spinArray[position] = newSpin;
+			}
+		}
+
+		if (boolAdapt == TRUE)
+		{
+			for (int i = 0; i < classSize; ++i)
+			{
+				int group = _coneGroupOfSite[colorClass[i]];
+				_coneAttempts[group] += metropolisSteps[i];
+				_coneAccepted[group] += metropolisSteps[i] * acceptedSteps[i];
+			}
 		}
 	}
-	return (double)(_numberActiveSites-numberRejectedStates)/_numberActiveSites;
-}
\ No newline at end of file
+
+	for (int sweep = 0; sweep < _overRelaxationSweeps; ++sweep)
+	{
+		for (int c = 0; c < _colorClasses.size(); ++c)
+		{
+			const std::vector<int> &colorClass = _colorClasses[c];
+			int classSize = colorClass.size();
+
+#pragma omp parallel for num_threads(_numberThreads) schedule(static)
+			for (int i = 0; i < classSize; ++i)
+			{
+				Threedim newSpin;
+				if (over_relaxation(colorClass[i], *_threadRanGens[omp_get_thread_num()], newSpin) == TRUE)
+				{
+					spinArray[colorClass[i]] = newSpin;
+				}
+			}
+		}
+	}
+	// single spin notifications are not thread safe; energies update their caches once per sweep
+	_hamilton->update_spin_configuration();
+
+	if (boolAdapt == TRUE)
+	{
+		adapt_cone();
+	}
+	return (double)(_numberActiveSites - numberRejectedStates) / _numberActiveSites;
+}
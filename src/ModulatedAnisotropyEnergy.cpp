@@ -78,7 +78,32 @@ double ModulatedAnisotropyEnergy::single_energy(const int &position) const
 
 Threedim ModulatedAnisotropyEnergy::effective_field(const int &position) const
 {
-	return Threedim{ 0,0,0 };
+	/**
+	* @param[in] position lattice site
+	* @return Effective field of both anisotropy contributions
+	*/
+
+	Threedim direction = MyMath::normalize(_directionArray[position]);
+	Threedim direction2 = MyMath::normalize(_direction);
+	Threedim field = MyMath::mult(direction,
+		2 * _anisotropyArray[position] * MyMath::dot_product(direction, _spinArray[position]));
+	return MyMath::add(field, MyMath::mult(direction2,
+		2 * _anisotropyArrayDefectLine[position] * MyMath::dot_product(direction2, _spinArray[position])));
+}
+
+int ModulatedAnisotropyEnergy::hessian_blocks(const int &position, ThreedimMatrix &onSite, 
+	std::vector<int> &partners, std::vector<ThreedimMatrix> &blocks) const
+{
+	/**
+	* E = K (1 - (S*e)^2) for both contributions yields d2E/dS dS = -2 K e e^T.
+	*/
+
+	Threedim direction = MyMath::normalize(_directionArray[position]);
+	Threedim direction2 = MyMath::normalize(_direction);
+	onSite = MyMath::add(onSite, MyMath::outer_product(direction, direction, -2 * _anisotropyArray[position]));
+	onSite = MyMath::add(onSite, MyMath::outer_product(direction2, direction2, 
+		-2 * _anisotropyArrayDefectLine[position]));
+	return TRUE;
 }
 
 void ModulatedAnisotropyEnergy::setup_anisotropy_array(int modulationNumber)
@@ -77,7 +77,46 @@ double ModulatedExchangeInteraction::single_energy(const int &position) const
 
 Threedim ModulatedExchangeInteraction::effective_field(const int &position) const
 {
-	return Threedim{ 0,0,0 };
+	/**
+	* The modulation of a bond is the same seen from both spins.
+	*
+	* @param[in] position lattice site
+	* @return Effective field of modulated exchange
+	*/
+
+	Threedim field{ 0,0,0 };
+	for (int i = 0; i < _nbors; ++i)
+	{
+		if (_neighborArray[_nbors * position + i] != -1) // -1 refers to empty entry
+		{
+			field = MyMath::add(field, MyMath::mult(_spinArray[_neighborArray[_nbors * position + i]],
+				_modulationArray[_nbors * position + i]));
+		}
+	}
+	return field;
+}
+
+int ModulatedExchangeInteraction::hessian_blocks(const int &position, ThreedimMatrix &onSite, 
+	std::vector<int> &partners, std::vector<ThreedimMatrix> &blocks) const
+{
+	/**
+	* Exchange with modulated coupling of each bond: block -J_ik * 1.
+	*/
+
+	for (int i = 0; i < _nbors; ++i)
+	{
+		if (_neighborArray[_nbors * position + i] != -1) // -1 refers to empty entry
+		{
+			double coupling = -_modulationArray[_nbors * position + i];
+			ThreedimMatrix block;
+			block.x = { coupling, 0, 0 };
+			block.y = { 0, coupling, 0 };
+			block.z = { 0, 0, coupling };
+			partners.push_back(_neighborArray[_nbors * position + i]);
+			blocks.push_back(block);
+		}
+	}
+	return TRUE;
 }
 
 void ModulatedExchangeInteraction::setup_modulation_array(int modulationNumber)
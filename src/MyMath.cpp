@@ -223,57 +223,122 @@ Threedim MyMath::matrix_vector_product(gsl_matrix* matrix, const Threedim &vec)
 	return result;
 }
 
-gsl_matrix * MyMath::get_rotation_matrix(Threedim * array1, const int &index)
+Threedim MyMath::matrix_vector_product(const ThreedimMatrix &matrix, const Threedim &vec)
+{
+	/**
+	* matrix * vector.
+	*
+	* param[in] matrix
+	* param[in] vec
+	* @return matrix*vector
+	*/
+	Threedim result{ 0,0,0 };
+	result.x = dot_product(matrix.x, vec);
+	result.y = dot_product(matrix.y, vec);
+	result.z = dot_product(matrix.z, vec);
+	return result;
+}
+
+ThreedimMatrix MyMath::add(const ThreedimMatrix &matrix1, const ThreedimMatrix &matrix2)
+{
+	/**
+	* @param[in] matrix1
+	* @param[in] matrix2
+	* @return matrix1 + matrix2
+	*/
+	ThreedimMatrix result;
+	result.x = add(matrix1.x, matrix2.x);
+	result.y = add(matrix1.y, matrix2.y);
+	result.z = add(matrix1.z, matrix2.z);
+	return result;
+}
+
+ThreedimMatrix MyMath::outer_product(const Threedim &vec1, const Threedim &vec2, const double &mult)
+{
+	/**
+	* @param[in] vec1
+	* @param[in] vec2
+	* @param[in] mult Scalar factor.
+	* @return mult * vec1 * vec2^T, i.e. (mult * vec1 * vec2^T) * v = mult * vec1 * (vec2.v)
+	*/
+	ThreedimMatrix result;
+	result.x = MyMath::mult(vec2, mult*vec1.x);
+	result.y = MyMath::mult(vec2, mult*vec1.y);
+	result.z = MyMath::mult(vec2, mult*vec1.z);
+	return result;
+}
+
+ThreedimMatrix MyMath::cross_product_matrix(const Threedim &vec, const double &mult)
+{
+	/**
+	* @param[in] vec
+	* @param[in] mult Scalar factor.
+	* @return matrix M with M * v = mult * (vec x v)
+	*/
+	ThreedimMatrix result;
+	result.x = { 0, -mult*vec.z, mult*vec.y };
+	result.y = { mult*vec.z, 0, -mult*vec.x };
+	result.z = { -mult*vec.y, mult*vec.x, 0 };
+	return result;
+}
+
+ThreedimMatrix MyMath::rotation_matrix(const Threedim &vec)
 {
 	/**
 	* Get rotation matrix for transformation to coordinate system in which
 	* z-direction is parallel to vector(/spin). Needed for calculation and display 
 	* of eigenmodes.
+	*
+	* @param[in] vec Unit vector
+	* @return Rotation matrix; rows stored as Threedim
 	*/
 
-	gsl_matrix* matrix = gsl_matrix_calloc(3, 3);
-	gsl_matrix_set(matrix, 0, 0, 1);
-	gsl_matrix_set(matrix, 1, 1, 1);
-	gsl_matrix_set(matrix, 2, 2, 1);
+	ThreedimMatrix matrix;
+	matrix.x = { 1, 0, 0 };
+	matrix.y = { 0, 1, 0 };
+	matrix.z = { 0, 0, 1 };
 
 	Threedim ez{0,0,1};
-	Threedim rotDir = MyMath::vector_product(array1[index], ez);
+	Threedim rotDir = MyMath::vector_product(vec, ez);
 	double sinT = MyMath::norm(rotDir);
 	if (sinT > 0.000000000001)
 	{
 		rotDir = MyMath::normalize(rotDir);
-		double cosT = MyMath::dot_product(array1[index], ez);
+		double cosT = MyMath::dot_product(vec, ez);
 
 		double omc = (1 - cosT);
 
-		double value = pow(rotDir.x, 2)*omc + cosT;
-		gsl_matrix_set(matrix, 0, 0,  value);
-
-		value = rotDir.x*rotDir.y*omc - rotDir.z*sinT;
-		gsl_matrix_set(matrix, 0, 1, value);
-
-		value = rotDir.x*rotDir.z*omc + rotDir.y*sinT;
-		gsl_matrix_set(matrix, 0, 2, value);
-
-		value = rotDir.y*rotDir.x*omc + rotDir.z*sinT;
-		gsl_matrix_set(matrix, 1, 0, value);
-
-		value = pow(rotDir.y,2)*omc + cosT;
-		gsl_matrix_set(matrix, 1, 1, value);
-
-		value = rotDir.y*rotDir.z*omc - rotDir.x*sinT;
-		gsl_matrix_set(matrix, 1, 2, value);
-
-		value = rotDir.z*rotDir.x*omc - rotDir.y*sinT;
-		gsl_matrix_set(matrix, 2, 0, value);
+		matrix.x.x = pow(rotDir.x, 2)*omc + cosT;
+		matrix.x.y = rotDir.x*rotDir.y*omc - rotDir.z*sinT;
+		matrix.x.z = rotDir.x*rotDir.z*omc + rotDir.y*sinT;
+		matrix.y.x = rotDir.y*rotDir.x*omc + rotDir.z*sinT;
+		matrix.y.y = pow(rotDir.y,2)*omc + cosT;
+		matrix.y.z = rotDir.y*rotDir.z*omc - rotDir.x*sinT;
+		matrix.z.x = rotDir.z*rotDir.x*omc - rotDir.y*sinT;
+		matrix.z.y = rotDir.z*rotDir.y*omc + rotDir.x*sinT;
+		matrix.z.z = pow(rotDir.z,2)*omc + cosT;
+	}
 
-		value = rotDir.z*rotDir.y*omc + rotDir.x*sinT;
-		gsl_matrix_set(matrix, 2, 1, value);
+	return matrix;
+}
 
-		value = pow(rotDir.z,2)*omc + cosT;
-		gsl_matrix_set(matrix, 2, 2, value);
-	}
+gsl_matrix * MyMath::get_rotation_matrix(Threedim * array1, const int &index)
+{
+	/**
+	* Rotation matrix of rotation_matrix() as gsl_matrix (allocated on the heap).
+	*/
 
+	ThreedimMatrix rotation = rotation_matrix(array1[index]);
+	gsl_matrix* matrix = gsl_matrix_alloc(3, 3);
+	gsl_matrix_set(matrix, 0, 0, rotation.x.x);
+	gsl_matrix_set(matrix, 0, 1, rotation.x.y);
+	gsl_matrix_set(matrix, 0, 2, rotation.x.z);
+	gsl_matrix_set(matrix, 1, 0, rotation.y.x);
+	gsl_matrix_set(matrix, 1, 1, rotation.y.y);
+	gsl_matrix_set(matrix, 1, 2, rotation.y.z);
+	gsl_matrix_set(matrix, 2, 0, rotation.z.x);
+	gsl_matrix_set(matrix, 2, 1, rotation.z.y);
+	gsl_matrix_set(matrix, 2, 2, rotation.z.z);
 	return matrix;
 }
 
@@ -638,3 +703,46 @@ double MyMath::topological_charge(const Threedim &x1, const Threedim &x2, const
 		+ MyMath::dot_product(x2, x3);
 	return 2 * atan2(N, D) / (4 * Pi);
 }
+
+void MyMath::fft(std::complex<double>* data, const int &n, const int &direction)
+{
+	/**
+	* In-place radix-2 fast Fourier transform. The backward transform is not normalized, i.e. a forward 
+	* followed by a backward transform multiplies data by n.
+	*
+	* @param[in,out] data Complex values
+	* @param[in] n Number of values; has to be a power of two
+	* @param[in] direction -1 for forward transform, +1 for backward transform
+	*/
+
+	// bit reversal permutation
+	for (int i = 1, j = 0; i < n; ++i)
+	{
+		int bit = n >> 1;
+		for (; j & bit; bit >>= 1)
+		{
+			j ^= bit;
+		}
+		j ^= bit;
+		if (i < j)
+		{
+			std::swap(data[i], data[j]);
+		}
+	}
+
+	const double pi = acos(-1.);
+	for (int length = 2; length <= n; length <<= 1)
+	{
+		int half = length / 2;
+		for (int k = 0; k < half; ++k)
+		{
+			std::complex<double> twiddle = std::polar(1., direction * 2 * pi * k / length);
+			for (int i = 0; i < n; i += length)
+			{
+				std::complex<double> tmp = data[i + k + half] * twiddle;
+				data[i + k + half] = data[i + k] - tmp;
+				data[i + k] += tmp;
+			}
+		}
+	}
+}
@@ -22,34 +22,36 @@
 
 #include "NCMRContrastObservable.h"
 
-#include "MyMath.h"
+#include "ObservableEngine.h"
 
 #include <sstream> 
 #include <iomanip>
 #include <iostream>
 
-NCMRContrastObservable::NCMRContrastObservable(int numberMeasurements, Threedim* spinArray, int numberAtoms, 
-	int* neighborArray, int nbors): Observable(numberMeasurements)
+NCMRContrastObservable::NCMRContrastObservable(int numberMeasurements, int numberAtoms, int* neighborArray,
+	int nbors, std::shared_ptr<ObservableEngine> engine): Observable(numberMeasurements)
 {
-	_spinArray = spinArray;
+	/**
+	* The contrast of a lattice site is the sum of the scalar products of its spin with the spins of the
+	* neighbors.
+	*
+	* @param[in] numberMeasurements Number of measurement values that can be stored
+	* @param[in] numberAtoms Number of lattice sites
+	* @param[in] neighborArray nbors neighbors per lattice site; -1 for empty entry
+	* @param[in] nbors Number of entries per lattice site
+	* @param[in] engine Evaluates the contrast before take_value is called
+	*/
+
+	_engine = engine;
+	_engine->request_ncmr_contrast(neighborArray, nbors);
 	_numberAtoms = numberAtoms;
-	_neighborArray = neighborArray;
-	_nbors = nbors;
 
-	_ncmrValues = new double*[_numberAtoms];
-	for (int i = 0; i < _numberAtoms; ++i)
-	{
-		_ncmrValues[i] = new double[numberMeasurements];
-	}
+	_ncmrValues = NULL;
+	clear_storage();
 }
 
 NCMRContrastObservable::~NCMRContrastObservable()
 {
-	for (int i = 0; i < _numberAtoms; ++i)
-	{
-		delete[] _ncmrValues[i];
-		_ncmrValues[i] = NULL;
-	}
 	delete[] _ncmrValues;
 	_ncmrValues = NULL;
 }
@@ -71,11 +73,12 @@ std::string NCMRContrastObservable::get_mean_header(void) const
 
 void NCMRContrastObservable::take_value(void)
 {
-	double* valuesPntr = NULL;
+	double* valuesPntr = _ncmrValues + storage_index(_measurementIndex) * _numberAtoms;
+	const double* contrast = _engine->get_ncmr_contrast();
 	for (int i = 0; i < _numberAtoms; i++)
 	{
-		valuesPntr = _ncmrValues[i];
-		valuesPntr[_measurementIndex] = ncmr_contrast_value(i);
+		valuesPntr[i] = contrast[i];
+		_ncmrSums[i] += valuesPntr[i];
 	}
 	++_measurementIndex;
 }
@@ -86,11 +89,10 @@ std::string NCMRContrastObservable::get_step_value(const int &index) const
 	stream << std::setprecision(15);
 	if (index < _numberMeasurements)
 	{
-		double* valuesPntr = NULL;
+		double* valuesPntr = _ncmrValues + storage_index(index) * _numberAtoms;
 		for (int j = 0; j < _numberAtoms; ++j)
 		{
-			valuesPntr = _ncmrValues[j];
-			stream << valuesPntr[index] << " ";
+			stream << valuesPntr[j] << " ";
 		}
 	}
 	else
@@ -106,20 +108,11 @@ std::string NCMRContrastObservable::get_mean_value(const double &temperature) co
 {
 	std::stringstream stream;
 	stream << std::setprecision(15);
-	if (_measurementIndex == _numberMeasurements)
+	if (measurements_complete() == TRUE)
 	{
-		double* valuesPntr = NULL;
-		double value = 0;
 		for (int i = 0; i < _numberAtoms; ++i)
 		{
-			value = 0;
-			valuesPntr = _ncmrValues[i];
-			for (int j = 0; j < _numberMeasurements; ++j)
-			{
-				value += valuesPntr[j];
-			}
-			value /= _numberMeasurements;
-			stream << value << " ";
+			stream << _ncmrSums[i] / _measurementIndex << " ";
 		}
 	}
 	return stream.str();
@@ -127,31 +120,7 @@ std::string NCMRContrastObservable::get_mean_value(const double &temperature) co
 
 void NCMRContrastObservable::clear_storage()
 {
-	for (int i = 0; i < _numberAtoms; ++i)
-	{
-		delete[] _ncmrValues[i];
-		_ncmrValues[i] = NULL;
-	}
 	delete[] _ncmrValues;
-	_ncmrValues = NULL;
-	_ncmrValues = new double*[_numberAtoms];
-	for (int i = 0; i < _numberAtoms; ++i)
-	{
-		_ncmrValues[i] = new double[_numberMeasurements];
-	}
-}
-
-double NCMRContrastObservable::ncmr_contrast_value(int position)
-{
-	double ncmrValue = 0;
-	int neighbor = 0; // index of neighbor atom
-	for (int i = 0; i < _nbors; ++i) // -1 refers to empty entry
-	{
-		if (_neighborArray[_nbors * position + i] != -1) // -1 refers to empty entry
-		{
-			neighbor = _neighborArray[_nbors * position + i]; // index of neighbor atom
-			ncmrValue += MyMath::dot_product(_spinArray[position], _spinArray[neighbor]);
-		}
-	}
-	return ncmrValue; // energy of single atom
+	_ncmrValues = new double[get_storage_size() * _numberAtoms];
+	_ncmrSums.assign(_numberAtoms, 0);
 }
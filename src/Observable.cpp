@@ -33,6 +33,9 @@ Observable::Observable(int numberMeasurements)
 
 	_numberMeasurements = numberMeasurements;
 	_measurementIndex = 0;
+	_boolAccumulate = FALSE;
+	_boolErrorAnalysis = FALSE;
+	_boolStoppedEarly = FALSE;
 }
 
 Observable::~Observable()
@@ -51,6 +54,54 @@ void Observable::set_number_measurements(const int &numberMeasurements)
 	set_measurement_index(0);
 }
 
+void Observable::set_accumulate(const int &boolAccumulate)
+{
+	/**
+	* In accumulator mode the memory of an observable does not depend on the number of measurements. Only the
+	* step value of the last measurement is available from get_step_value.
+	*
+	* @param[in] boolAccumulate TRUE for accumulator mode, FALSE to store all step values of a run
+	*/
+
+	_boolAccumulate = boolAccumulate;
+	clear_storage();
+	set_measurement_index(0);
+}
+
+void Observable::set_error_analysis(const int &boolErrorAnalysis)
+{
+	_boolErrorAnalysis = boolErrorAnalysis;
+}
+
+void Observable::set_stopped_early(const int &boolStoppedEarly)
+{
+	_boolStoppedEarly = boolStoppedEarly;
+}
+
+double Observable::get_relative_error(void) const
+{
+	return 0;
+}
+
+int Observable::measurements_complete(void) const
+{
+	if (_measurementIndex == _numberMeasurements)
+	{
+		return TRUE;
+	}
+	return (_boolStoppedEarly == TRUE && _measurementIndex > 0) ? TRUE : FALSE;
+}
+
+int Observable::storage_index(const int &index) const
+{
+	return (_boolAccumulate == TRUE) ? 0 : index;
+}
+
+int Observable::get_storage_size(void) const
+{
+	return (_boolAccumulate == TRUE) ? 1 : _numberMeasurements;
+}
+
 int Observable::get_measurement_index(void) const
 {
 	return _measurementIndex;
@@ -0,0 +1,239 @@
+/*
+* ObservableEngine.cpp
+*
+* Copyright 2017 Julian Hagemeister
+*
+* This file is part of MonteCrystal.
+*
+* MonteCrystal is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* MonteCrystal is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with MonteCrystal.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include "ObservableEngine.h"
+
+// forward and further includes
+#include "Hamiltonian.h"
+#include "Energy.h"
+#include "MyMath.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+
+ObservableEngine::ObservableEngine(Threedim* spinArray, int numberAtoms) :
+	_spinArray(spinArray), _numberAtoms(numberAtoms), _boolSiteEnergies(FALSE), _neighborArray(NULL), _nbors(0),
+	_cells(NULL), _cellNum(0), _windingNumber(0)
+{
+	/**
+	* Magnetization and absolute magnetization are always evaluated. All other quantities only if requested.
+	*
+	* @param[in] spinArray Spin configuration
+	* @param[in] numberAtoms Number of lattice sites
+	*/
+
+	_magnetisation = { 0,0,0 };
+	_absoluteMagnetisation = { 0,0,0 };
+}
+
+ObservableEngine::~ObservableEngine()
+{
+}
+
+void ObservableEngine::request_energies(QSharedPointer<Hamiltonian> hamilton, int boolEachSpin)
+{
+	/**
+	* @param[in] hamilton Hamiltonian with the energy objects
+	* @param[in] boolEachSpin TRUE: energies resolved to lattice sites are evaluated as well
+	*/
+
+	_energies = hamilton->get_energies();
+	_boolSiteEnergies = boolEachSpin;
+	_siteAdditive.clear();
+	_otherEnergies.clear();
+	for (int i = 0; i < _energies.size(); ++i)
+	{
+		if (_energies[i]->site_additive() == TRUE)
+		{
+			_siteAdditive.push_back(i);
+		}
+		else
+		{
+			_otherEnergies.push_back(i);
+		}
+	}
+	_partEnergies.assign(_energies.size(), 0);
+	_siteEnergies.clear();
+	if (_boolSiteEnergies == TRUE)
+	{
+		_siteEnergies.assign(_energies.size() * _numberAtoms, 0);
+	}
+}
+
+void ObservableEngine::request_ncmr_contrast(const int* neighborArray, int nbors)
+{
+	/**
+	* @param[in] neighborArray nbors neighbors per lattice site; -1 for empty entry
+	* @param[in] nbors Number of entries per lattice site
+	*/
+
+	_neighborArray = neighborArray;
+	_nbors = nbors;
+	_ncmrContrast.assign(_numberAtoms, 0);
+}
+
+void ObservableEngine::request_winding_number(const TopologicalChargeCell* cells, int cellNum)
+{
+	/**
+	* @param[in] cells Cells of three lattice sites each
+	* @param[in] cellNum Number of cells
+	*/
+
+	_cells = cells;
+	_cellNum = cellNum;
+}
+
+void ObservableEngine::evaluate(void)
+{
+	/**
+	* The sums over lattice sites and cells are OpenMP reductions. The energies of the site additive energy
+	* objects are summed per thread and added afterwards in the order of the threads. Energy objects that are
+	* not site additive are evaluated by their own total_energy (e.g. dipolar interaction by FFT).
+	*/
+
+	int numberSiteAdditive = _siteAdditive.size();
+	int numberThreads = omp_get_max_threads();
+	_threadEnergies.assign(numberThreads * numberSiteAdditive, 0);
+
+	int numberCells = (_cells != NULL) ? _cellNum : 0;
+	int length = std::max(_numberAtoms, numberCells);
+	double mx = 0, my = 0, mz = 0;
+	double absX = 0, absY = 0, absZ = 0;
+	double solidAngle = 0;
+
+	#pragma omp parallel num_threads(numberThreads)
+	{
+		std::vector<double> energies(numberSiteAdditive, 0);
+
+		#pragma omp for schedule(static) reduction(+:mx, my, mz, absX, absY, absZ, solidAngle)
+		for (int n = 0; n < length; ++n)
+		{
+			if (n < _numberAtoms)
+			{
+				const Threedim &spin = _spinArray[n];
+				mx += spin.x;
+				my += spin.y;
+				mz += spin.z;
+				absX += fabs(spin.x);
+				absY += fabs(spin.y);
+				absZ += fabs(spin.z);
+
+				for (int e = 0; e < numberSiteAdditive; ++e)
+				{
+					const Energy &energy = *_energies[_siteAdditive[e]];
+					double value = energy.single_energy(n) * energy.get_factor();
+					energies[e] += value;
+					if (_boolSiteEnergies == TRUE)
+					{
+						_siteEnergies[_siteAdditive[e] * _numberAtoms + n] = value;
+					}
+				}
+
+				if (_neighborArray != NULL)
+				{
+					double contrast = 0;
+					const int* neighbors = _neighborArray + _nbors * n;
+					for (int k = 0; k < _nbors; ++k)
+					{
+						if (neighbors[k] != -1) // -1 refers to empty entry
+						{
+							contrast += MyMath::dot_product(spin, _spinArray[neighbors[k]]);
+						}
+					}
+					_ncmrContrast[n] = contrast;
+				}
+			}
+
+			if (n < numberCells)
+			{
+				const Threedim &spin1 = _spinArray[_cells[n].i];
+				const Threedim &spin2 = _spinArray[_cells[n].j];
+				const Threedim &spin3 = _spinArray[_cells[n].k];
+				double numerator = MyMath::dot_product(spin1, MyMath::vector_product(spin2, spin3));
+				double denominator = 1 + MyMath::dot_product(spin1, spin2) + MyMath::dot_product(spin1, spin3)
+					+ MyMath::dot_product(spin2, spin3);
+				solidAngle += 2 * atan2(numerator, denominator);
+			}
+		}
+
+		std::copy(energies.begin(), energies.end(), 
+			_threadEnergies.begin() + omp_get_thread_num() * numberSiteAdditive);
+	}
+
+	_magnetisation = { mx, my, mz };
+	_absoluteMagnetisation = { absX, absY, absZ };
+	_windingNumber = solidAngle / (4 * Pi);
+
+	for (int e = 0; e < numberSiteAdditive; ++e)
+	{
+		double energy = 0;
+		for (int t = 0; t < numberThreads; ++t)
+		{
+			energy += _threadEnergies[t * numberSiteAdditive + e];
+		}
+		_partEnergies[_siteAdditive[e]] = energy;
+	}
+	for (int e = 0; e < _otherEnergies.size(); ++e)
+	{
+		const Energy &energy = *_energies[_otherEnergies[e]];
+		_partEnergies[_otherEnergies[e]] = energy.total_energy(_numberAtoms);
+		if (_boolSiteEnergies == TRUE)
+		{
+			double* siteEnergies = _siteEnergies.data() + _otherEnergies[e] * _numberAtoms;
+			for (int j = 0; j < _numberAtoms; ++j)
+			{
+				siteEnergies[j] = energy.single_energy(j) * energy.get_factor();
+			}
+		}
+	}
+}
+
+Threedim ObservableEngine::get_magnetisation(void) const
+{
+	return _magnetisation;
+}
+
+Threedim ObservableEngine::get_absolute_magnetisation(void) const
+{
+	return _absoluteMagnetisation;
+}
+
+double ObservableEngine::get_part_energy(int index) const
+{
+	return _partEnergies[index];
+}
+
+const double* ObservableEngine::get_site_energies(void) const
+{
+	return _siteEnergies.data();
+}
+
+const double* ObservableEngine::get_ncmr_contrast(void) const
+{
+	return _ncmrContrast.data();
+}
+
+double ObservableEngine::get_winding_number(void) const
+{
+	return _windingNumber;
+}
@@ -0,0 +1,231 @@
+/*
+* OutputWriter.cpp
+*
+* Copyright 2017 Julian Hagemeister
+*
+* This file is part of MonteCrystal.
+*
+* MonteCrystal is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* MonteCrystal is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with MonteCrystal.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include "OutputWriter.h"
+
+// forward and further includes
+#include "Functions.h"
+#include "SpinConfigurationFile.h"
+
+#include <fstream>
+
+OutputWriter::OutputWriter(int numberBuffers):
+	_numberBuffers(numberBuffers), _numberWriting(0), _boolStop(FALSE)
+{
+	/**
+	* @param[in] numberBuffers Maximum number of pending jobs. Each buffer holds one spin configuration once
+	*                          it has been used. 0: no writer thread, files are written in calling thread.
+	*/
+
+	if (_numberBuffers < 0)
+	{
+		_numberBuffers = 0;
+	}
+	for (int i = 0; i < _numberBuffers; ++i)
+	{
+		_freeBuffers.push_back(std::unique_ptr<OutputBuffer>(new OutputBuffer));
+	}
+	if (_numberBuffers > 0)
+	{
+		_thread = std::thread(&OutputWriter::run, this);
+	}
+}
+
+OutputWriter::~OutputWriter()
+{
+	if (_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_boolStop = TRUE;
+		}
+		_jobAvailable.notify_all();
+		// pending jobs are written before the thread terminates
+		_thread.join();
+	}
+}
+
+void OutputWriter::save_text(std::string fname, std::string text)
+{
+	/**
+	* Nothing is written for empty text (e.g. step values of a measurement without observables).
+	*
+	* @param[in] fname File name
+	* @param[in] text Content of file
+	*/
+
+	if (text.empty())
+	{
+		return;
+	}
+	std::unique_ptr<OutputBuffer> buffer = acquire_buffer();
+	buffer->type = outputText;
+	buffer->fname = fname;
+	buffer->text = std::move(text);
+	submit(std::move(buffer));
+}
+
+void OutputWriter::save_spin_configuration(std::string fname, const int* activityList,
+	const Threedim* spinArray, int numberAtoms)
+{
+	/**
+	* @param[in] fname File name
+	* @param[in] activityList Activity of each lattice site
+	* @param[in] spinArray Spin configuration
+	* @param[in] numberAtoms Number of lattice sites
+	*/
+
+	std::unique_ptr<OutputBuffer> buffer = acquire_buffer();
+	buffer->type = outputSpinText;
+	buffer->fname = fname;
+	buffer->activityList.assign(activityList, activityList + numberAtoms);
+	buffer->spins.assign(spinArray, spinArray + numberAtoms);
+	submit(std::move(buffer));
+}
+
+void OutputWriter::save_spin_configuration(std::string fname, const int* activityList,
+	const Threedim* spinArray, int numberAtoms, uint64_t latticeHash, int precision)
+{
+	/**
+	* @param[in] fname File name
+	* @param[in] activityList Activity of each lattice site
+	* @param[in] spinArray Spin configuration
+	* @param[in] numberAtoms Number of lattice sites
+	* @param[in] latticeHash Hash of lattice (see SpinConfigurationFile::lattice_hash)
+	* @param[in] precision Bytes per spin component: 4 or 8
+	*/
+
+	std::unique_ptr<OutputBuffer> buffer = acquire_buffer();
+	buffer->type = outputSpinBinary;
+	buffer->fname = fname;
+	buffer->activityList.assign(activityList, activityList + numberAtoms);
+	buffer->spins.assign(spinArray, spinArray + numberAtoms);
+	buffer->latticeHash = latticeHash;
+	buffer->precision = precision;
+	submit(std::move(buffer));
+}
+
+void OutputWriter::append_frame(std::shared_ptr<SpinConfigurationFile> file, const Threedim* spinArray,
+	int numberAtoms, int64_t label)
+{
+	/**
+	* The file is kept open until the last pending frame is written, even if the caller releases it.
+	*
+	* @param[in] file Binary file created by caller
+	* @param[in] spinArray Spin configuration
+	* @param[in] numberAtoms Number of lattice sites
+	* @param[in] label Label of frame
+	*/
+
+	std::unique_ptr<OutputBuffer> buffer = acquire_buffer();
+	buffer->type = outputSpinFrame;
+	buffer->spins.assign(spinArray, spinArray + numberAtoms);
+	buffer->label = label;
+	buffer->file = file;
+	submit(std::move(buffer));
+}
+
+void OutputWriter::flush(void)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_bufferAvailable.wait(lock, [this] { return _queue.empty() && _numberWriting == 0; });
+}
+
+std::unique_ptr<OutputBuffer> OutputWriter::acquire_buffer(void)
+{
+	if (_numberBuffers == 0)
+	{
+		return std::unique_ptr<OutputBuffer>(new OutputBuffer);
+	}
+	std::unique_lock<std::mutex> lock(_mutex);
+	_bufferAvailable.wait(lock, [this] { return !_freeBuffers.empty(); });
+	std::unique_ptr<OutputBuffer> buffer = std::move(_freeBuffers.back());
+	_freeBuffers.pop_back();
+	return buffer;
+}
+
+void OutputWriter::submit(std::unique_ptr<OutputBuffer> buffer)
+{
+	if (_numberBuffers == 0)
+	{
+		write(*buffer);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_queue.push_back(std::move(buffer));
+	}
+	_jobAvailable.notify_one();
+}
+
+void OutputWriter::write(OutputBuffer &buffer)
+{
+	switch (buffer.type)
+	{
+	case outputText:
+	{
+		// existing file is overwritten as by Measurement::save_step_values
+		std::fstream filestr;
+		filestr.open(buffer.fname, std::fstream::out);
+		filestr << buffer.text;
+		filestr.close();
+		break;
+	}
+	case outputSpinText:
+		Functions::save(buffer.activityList.data(), buffer.spins.data(), buffer.spins.size(), buffer.fname);
+		break;
+	case outputSpinBinary:
+		SpinConfigurationFile::save(buffer.fname, buffer.activityList.data(), buffer.spins.data(),
+			buffer.spins.size(), buffer.latticeHash, buffer.precision);
+		break;
+	case outputSpinFrame:
+		buffer.file->append_frame(buffer.spins.data(), buffer.label);
+		break;
+	}
+}
+
+void OutputWriter::run(void)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true)
+	{
+		_jobAvailable.wait(lock, [this] { return !_queue.empty() || _boolStop == TRUE; });
+		if (_queue.empty())
+		{
+			return;
+		}
+		std::unique_ptr<OutputBuffer> buffer = std::move(_queue.front());
+		_queue.pop_front();
+		_numberWriting = 1;
+		lock.unlock();
+
+		write(*buffer);
+		// release file and text, keep allocated spin storage for next job
+		buffer->file.reset();
+		buffer->text.clear();
+
+		lock.lock();
+		_numberWriting = 0;
+		_freeBuffers.push_back(std::move(buffer));
+		_bufferAvailable.notify_all();
+	}
+}
@@ -0,0 +1,206 @@
+/*
+* PairInteractionField.cpp
+*
+* Copyright 2017 Julian Hagemeister
+*
+* This file is part of MonteCrystal.
+*
+* MonteCrystal is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* MonteCrystal is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with MonteCrystal.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include "PairInteractionField.h"
+
+// forward and further includes
+#include "Energy.h"
+#include "MyMath.h"
+
+PairInteractionField::PairInteractionField(const std::vector<std::shared_ptr<Energy>> &energies,
+	int numberAtoms, Threedim* spinArray):
+	_numberAtoms(numberAtoms), _spinArray(spinArray)
+{
+	/**
+	* @param[in] energies Energy objects that are bilinear pair interactions (see Energy::pair_couplings)
+	* @param[in] numberAtoms Number of lattice sites
+	* @param[in] spinArray Spin configuration
+	*/
+
+	// spin component arrays are padded to a multiple of 8 doubles (one AVX-512 register)
+	_paddedNumberAtoms = ((numberAtoms + 7) / 8) * 8;
+	_spinX.assign(_paddedNumberAtoms, 0);
+	_spinY.assign(_paddedNumberAtoms, 0);
+	_spinZ.assign(_paddedNumberAtoms, 0);
+
+	setup_bonds(energies);
+}
+
+PairInteractionField::~PairInteractionField()
+{
+}
+
+void PairInteractionField::setup_bonds(const std::vector<std::shared_ptr<Energy>> &energies)
+{
+	/**
+	* Collects the bonds of all energies into one compressed neighbor list without empty entries. Bonds of
+	* different energies connecting the same pair of sites are merged into one coupling tensor.
+	*/
+
+	_rowStart.assign(_numberAtoms + 1, 0);
+
+	std::vector<int> energyPartners;
+	std::vector<ThreedimMatrix> energyCouplings;
+	std::vector<int> sitePartners;
+	std::vector<ThreedimMatrix> siteCouplings;
+	for (int position = 0; position < _numberAtoms; ++position)
+	{
+		sitePartners.clear();
+		siteCouplings.clear();
+		for (auto it = energies.begin(); it != energies.end(); ++it)
+		{
+			energyPartners.clear();
+			energyCouplings.clear();
+			(*it)->pair_couplings(position, energyPartners, energyCouplings);
+			for (int i = 0; i < energyPartners.size(); ++i)
+			{
+				int k = 0;
+				while (k < sitePartners.size() && sitePartners[k] != energyPartners[i])
+				{
+					++k;
+				}
+				if (k < sitePartners.size())
+				{
+					siteCouplings[k] = MyMath::add(siteCouplings[k], energyCouplings[i]);
+				}
+				else
+				{
+					sitePartners.push_back(energyPartners[i]);
+					siteCouplings.push_back(energyCouplings[i]);
+				}
+			}
+		}
+
+		for (int k = 0; k < sitePartners.size(); ++k)
+		{
+			_partners.push_back(sitePartners[k]);
+			_couplings[0].push_back(siteCouplings[k].x.x);
+			_couplings[1].push_back(siteCouplings[k].x.y);
+			_couplings[2].push_back(siteCouplings[k].x.z);
+			_couplings[3].push_back(siteCouplings[k].y.x);
+			_couplings[4].push_back(siteCouplings[k].y.y);
+			_couplings[5].push_back(siteCouplings[k].y.z);
+			_couplings[6].push_back(siteCouplings[k].z.x);
+			_couplings[7].push_back(siteCouplings[k].z.y);
+			_couplings[8].push_back(siteCouplings[k].z.z);
+		}
+		_rowStart[position + 1] = _partners.size();
+	}
+}
+
+void PairInteractionField::copy_spins(void)
+{
+	double* spinX = _spinX.data();
+	double* spinY = _spinY.data();
+	double* spinZ = _spinZ.data();
+	const Threedim* spinArray = _spinArray;
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < _numberAtoms; ++i)
+	{
+		spinX[i] = spinArray[i].x;
+		spinY[i] = spinArray[i].y;
+		spinZ[i] = spinArray[i].z;
+	}
+}
+
+Threedim PairInteractionField::effective_field(const int &position) const
+{
+	/**
+	* Evaluates the field directly from the spin configuration. Used for single site updates where the
+	* spin component arrays would be outdated.
+	*
+	* @param[in] position Index of lattice site
+	*
+	* @return Effective field of all pair interactions [meV]
+	*/
+
+	double fieldX = 0;
+	double fieldY = 0;
+	double fieldZ = 0;
+	for (int k = _rowStart[position]; k < _rowStart[position + 1]; ++k)
+	{
+		const Threedim &spin = _spinArray[_partners[k]];
+		fieldX += _couplings[0][k] * spin.x + _couplings[1][k] * spin.y + _couplings[2][k] * spin.z;
+		fieldY += _couplings[3][k] * spin.x + _couplings[4][k] * spin.y + _couplings[5][k] * spin.z;
+		fieldZ += _couplings[6][k] * spin.x + _couplings[7][k] * spin.y + _couplings[8][k] * spin.z;
+	}
+	return Threedim{ fieldX, fieldY, fieldZ };
+}
+
+void PairInteractionField::effective_fields(const int* sites, const int &numberSites, Threedim* fields)
+{
+	/**
+	* Copies the spin configuration into separate component arrays and evaluates the effective fields of
+	* all given sites. The loop over sites is parallelized; vectorization is left to the compiler.
+	*
+	* @param[in] sites Indexes of lattice sites
+	* @param[in] numberSites Number of entries in sites
+	* @param[out] fields Effective fields [meV]. fields[i] belongs to sites[i]. Existing entries are
+	*                    overwritten.
+	*/
+
+	copy_spins();
+
+	const double* spinX = _spinX.data();
+	const double* spinY = _spinY.data();
+	const double* spinZ = _spinZ.data();
+	const int* rowStart = _rowStart.data();
+	const int* partners = _partners.data();
+	const double* cxx = _couplings[0].data();
+	const double* cxy = _couplings[1].data();
+	const double* cxz = _couplings[2].data();
+	const double* cyx = _couplings[3].data();
+	const double* cyy = _couplings[4].data();
+	const double* cyz = _couplings[5].data();
+	const double* czx = _couplings[6].data();
+	const double* czy = _couplings[7].data();
+	const double* czz = _couplings[8].data();
+
+	#pragma omp parallel for schedule(static)
+	for (int i = 0; i < numberSites; ++i)
+	{
+		double fieldX = 0;
+		double fieldY = 0;
+		double fieldZ = 0;
+		for (int k = rowStart[sites[i]]; k < rowStart[sites[i] + 1]; ++k)
+		{
+			int j = partners[k];
+			fieldX += cxx[k] * spinX[j] + cxy[k] * spinY[j] + cxz[k] * spinZ[j];
+			fieldY += cyx[k] * spinX[j] + cyy[k] * spinY[j] + cyz[k] * spinZ[j];
+			fieldZ += czx[k] * spinX[j] + czy[k] * spinY[j] + czz[k] * spinZ[j];
+		}
+		fields[i] = Threedim{ fieldX, fieldY, fieldZ };
+	}
+}
+
+void PairInteractionField::set_spin_array(Threedim* spinArray)
+{
+	/**
+	* @param[in] spinArray Spin configuration
+	*/
+	_spinArray = spinArray;
+}
+
+int PairInteractionField::get_number_bonds(void) const
+{
+	return _partners.size();
+}
@@ -0,0 +1,113 @@
+/*
+* Philox.cpp
+*
+* Copyright 2017 Julian Hagemeister
+*
+* This file is part of MonteCrystal.
+*
+* MonteCrystal is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* MonteCrystal is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with MonteCrystal.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include "Philox.h"
+
+#include <cmath>
+
+Philox::Philox(uint64_t key)
+{
+	/**
+	* @param[in] key Key of generator. Generators with different keys yield independent streams.
+	*/
+
+	_key[0] = (uint32_t)key;
+	_key[1] = (uint32_t)(key >> 32);
+}
+
+Philox::~Philox()
+{
+}
+
+void Philox::generate(uint64_t counterHigh, uint64_t counterLow, uint32_t* result) const
+{
+	/**
+	* Ten rounds of the Philox4x32 bijection applied to the counter.
+	*
+	* @param[in] counterHigh Upper 64 bits of counter
+	* @param[in] counterLow Lower 64 bits of counter
+	* @param[out] result Four 32 bit random numbers
+	*/
+
+	uint32_t counter[4] = { (uint32_t)counterLow, (uint32_t)(counterLow >> 32), (uint32_t)counterHigh,
+		(uint32_t)(counterHigh >> 32) };
+	uint32_t key[2] = { _key[0], _key[1] };
+
+	for (int round = 0; round < 10; ++round)
+	{
+		uint64_t product0 = (uint64_t)0xD2511F53 * counter[0];
+		uint64_t product1 = (uint64_t)0xCD9E8D57 * counter[2];
+		uint32_t next[4] = { (uint32_t)(product1 >> 32) ^ counter[1] ^ key[0], (uint32_t)product1,
+			(uint32_t)(product0 >> 32) ^ counter[3] ^ key[1], (uint32_t)product0 };
+		counter[0] = next[0];
+		counter[1] = next[1];
+		counter[2] = next[2];
+		counter[3] = next[3];
+		key[0] += 0x9E3779B9;
+		key[1] += 0xBB67AE85;
+	}
+
+	for (int i = 0; i < 4; ++i)
+	{
+		result[i] = counter[i];
+	}
+}
+
+void Philox::uniform(uint64_t counterHigh, uint64_t counterLow, double* result) const
+{
+	/**
+	* @param[in] counterHigh Upper 64 bits of counter
+	* @param[in] counterLow Lower 64 bits of counter
+	* @param[out] result Four pseudo random numbers in (0,1)
+	*/
+
+	uint32_t random[4];
+	generate(counterHigh, counterLow, random);
+	for (int i = 0; i < 4; ++i)
+	{
+		result[i] = (random[i] + 0.5) * (1. / 4294967296.);
+	}
+}
+
+void Philox::gaussian(uint64_t counterHigh, uint64_t counterLow, double* result) const
+{
+	/**
+	* @param[in] counterHigh Upper 64 bits of counter
+	* @param[in] counterLow Lower 64 bits of counter
+	* @param[out] result Four pseudo random numbers according to standard normal distribution
+	*/
+
+	double random[4];
+	uniform(counterHigh, counterLow, random);
+	const double twoPi = 2 * acos(-1.);
+	for (int i = 0; i < 4; i += 2)
+	{
+		double radius = sqrt(-2 * log(random[i]));
+		result[i] = radius * cos(twoPi * random[i + 1]);
+		result[i + 1] = radius * sin(twoPi * random[i + 1]);
+	}
+}
+
+uint64_t Philox::get_key(void) const
+{
+	return ((uint64_t)_key[1] << 32) | _key[0];
+}
@@ -0,0 +1,230 @@
+/*
+* PhiloxRanGen.cpp
+*
+* Copyright 2017 Julian Hagemeister
+*
+* This file is part of MonteCrystal.
+*
+* MonteCrystal is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* MonteCrystal is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with MonteCrystal.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "PhiloxRanGen.h"
+
+#include <algorithm>
+#include <cmath>
+
+PhiloxRanGen::PhiloxRanGen(int seed, uint64_t stream) : _philox((uint64_t)(uint32_t)seed)
+{
+	/**
+	* @param[in] seed Seed specified by user; key of Philox
+	* @param[in] stream Index of stream
+	*/
+
+	_stream = stream;
+	_counter = 0;
+	_bufferIndex = 4;
+	_numberSplits = 0;
+}
+
+PhiloxRanGen::~PhiloxRanGen()
+{
+}
+
+uint32_t PhiloxRanGen::next(void)
+{
+	if (_bufferIndex == 4)
+	{
+		_philox.generate(_stream, _counter, _buffer);
+		_counter += 1;
+		_bufferIndex = 0;
+	}
+	return _buffer[_bufferIndex++];
+}
+
+int PhiloxRanGen::IRandom(int min, int max)
+{
+	/**
+	* Pseudo random number uniformly drawn from inerval [min,max]. Multiplication of a 32 bit number with the
+	* size of the interval and rejection of the few values that would favor some results (Lemire's method).
+	*/
+
+	uint64_t range = (uint64_t)((int64_t)max - min) + 1;
+	uint64_t product = (uint64_t)next() * range;
+	uint32_t low = (uint32_t)product;
+	if (low < range)
+	{
+		uint32_t threshold = (uint32_t)((((uint64_t)1 << 32) - range) % range);
+		while (low < threshold)
+		{
+			product = (uint64_t)next() * range;
+			low = (uint32_t)product;
+		}
+	}
+	return (int)((int64_t)min + (int64_t)(product >> 32));
+}
+
+double PhiloxRanGen::Random(void)
+{
+	/**
+	* Pseudo random number uniformly drawn from inerval (0,1)
+	*/
+
+	return (next() + 0.5) * (1. / 4294967296.);
+}
+
+void PhiloxRanGen::Shuffle(std::vector<int> &vector)
+{
+	/**
+	* Randomize positions of integer values in a vector of integer values (Fisher-Yates).
+	*
+	* @param[in] vector Integer values
+	*/
+
+	for (int i = (int)vector.size() - 1; i > 0; --i)
+	{
+		std::swap(vector[i], vector[IRandom(0, i)]);
+	}
+}
+
+void PhiloxRanGen::polar(double &x1, double &x2)
+{
+	/**
+	* Box-Muller transform of two uniform numbers of the stream. No rejection, so every call consumes two
+	* numbers.
+	*
+	* @param[out] x1 normal distributed number by reference
+	* @param[out] x2 normal distributed number by reference
+	*/
+
+	double u1 = Random();
+	double u2 = Random();
+	const double twoPi = 2 * acos(-1.);
+	double radius = sqrt(-2 * log(u1));
+	x1 = radius * cos(twoPi * u2);
+	x2 = radius * sin(twoPi * u2);
+}
+
+void PhiloxRanGen::uniform_block(double* result, int n)
+{
+	/**
+	* Next n numbers of the stream, the same as n calls of Random(). Complete blocks of four are generated
+	* directly from their counters.
+	*
+	* @param[out] result n pseudo random numbers in (0,1)
+	* @param[in] n Number of pseudo random numbers
+	*/
+
+	int i = 0;
+	while (i < n && _bufferIndex < 4)
+	{
+		result[i++] = Random();
+	}
+	for (; i + 4 <= n; i += 4)
+	{
+		_philox.uniform(_stream, _counter, result + i);
+		_counter += 1;
+	}
+	for (; i < n; ++i)
+	{
+		result[i] = Random();
+	}
+}
+
+void PhiloxRanGen::gaussian_block(double* result, int n)
+{
+	/**
+	* Box-Muller transform of the next n uniform numbers of the stream (n + 1 for odd n), the same as the
+	* corresponding calls of polar().
+	*
+	* @param[out] result n pseudo random numbers according to standard normal distribution
+	* @param[in] n Number of pseudo random numbers
+	*/
+
+	int pairs = n / 2;
+	uniform_block(result, 2 * pairs);
+	const double twoPi = 2 * acos(-1.);
+	for (int i = 0; i < 2 * pairs; i += 2)
+	{
+		double radius = sqrt(-2 * log(result[i]));
+		double angle = twoPi * result[i + 1];
+		result[i] = radius * cos(angle);
+		result[i + 1] = radius * sin(angle);
+	}
+	if (n % 2 == 1)
+	{
+		double x2 = 0;
+		polar(result[n - 1], x2);
+	}
+}
+
+void PhiloxRanGen::set_stream(int seed, int stream)
+{
+	/**
+	* @param[in] seed Seed specified by user; key of Philox
+	* @param[in] stream Index of stream. Starts at its first number.
+	*/
+
+	_philox = Philox((uint64_t)(uint32_t)seed);
+	_stream = (uint64_t)(uint32_t)stream;
+	_counter = 0;
+	_bufferIndex = 4;
+}
+
+std::shared_ptr<RanGen> PhiloxRanGen::split(void)
+{
+	/**
+	* The stream index of the new generator is a hash of this stream and the number of previous splits, so 
+	* it is reproducible and does not coincide with the small stream indexes of set_stream().
+	*
+	* @return Generator with same seed and new stream
+	*/
+
+	_numberSplits += 1;
+	uint64_t stream = mix(mix(_stream) + _numberSplits) | ((uint64_t)1 << 63);
+	return std::make_shared<PhiloxRanGen>((int)(uint32_t)_philox.get_key(), stream);
+}
+
+uint64_t PhiloxRanGen::mix(uint64_t z)
+{
+	/**
+	* splitmix64 finalizer
+	*/
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+uint64_t PhiloxRanGen::get_position(void) const
+{
+	return 4 * _counter - (4 - _bufferIndex);
+}
+
+void PhiloxRanGen::set_position(uint64_t position)
+{
+	/**
+	* @param[in] position Number of pseudo random numbers to skip from start of stream
+	*/
+
+	_counter = position / 4;
+	_bufferIndex = 4;
+	int skip = position % 4;
+	if (skip > 0)
+	{
+		_philox.generate(_stream, _counter, _buffer);
+		_counter += 1;
+		_bufferIndex = skip;
+	}
+}
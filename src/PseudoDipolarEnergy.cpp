@@ -73,3 +73,28 @@ Threedim PseudoDipolarEnergy::effective_field(const int &position) const
 	}
 	return MyMath::mult(field, _energyParameter); // energy of single atom
 }
+
+double PseudoDipolarEnergy::delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const
+{
+	return -MyMath::dot_product(MyMath::difference(newSpin, oldSpin), effective_field(position));
+}
+
+int PseudoDipolarEnergy::linear_in_spin(void) const
+{
+	return TRUE;
+}
+
+int PseudoDipolarEnergy::pair_couplings(const int &position, std::vector<int> &partners, 
+	std::vector<ThreedimMatrix> &couplings) const
+{
+	for (int i = 0; i < _nbors; ++i)
+	{
+		if (_neighborArray[_nbors * position + i] != -1) // -1 refers to empty entry
+		{
+			partners.push_back(_neighborArray[_nbors * position + i]);
+			couplings.push_back(MyMath::outer_product(_neighborVectorArray[_nbors * position + i],
+				_neighborVectorArray[_nbors * position + i], _energyParameter));
+		}
+	}
+	return TRUE;
+}
@@ -30,6 +30,9 @@ RanGen::~RanGen() {
 void RanGen::polar(double &x1, double &x2)
 {
 	/**
+	* Marsaglia polar method. Uses the uniform numbers of this generator so that the result depends on the
+	* seed and generators of different threads are independent.
+	*
 	* @param[out] x1 normal distributed number by reference
 	* @param[out] x2 normal distributed number by reference
 	*/
@@ -41,12 +44,45 @@ void RanGen::polar(double &x1, double &x2)
 
 	while (q <= 0.0 || q >= 1.0)
 	{
-		u = 2.0 * (( (double) rand() ) / RAND_MAX) - 1;
-		v = 2.0 * (((double)rand()) / RAND_MAX) - 1;
+		u = 2.0 * Random() - 1;
+		v = 2.0 * Random() - 1;
 		q = u * u + v * v;
 	};
 
 	p = sqrt(-2 * log(q) / q);
 	x1 = u * p;
 	x2 = v * p;
-}
\ No newline at end of file
+}
+
+void RanGen::uniform_block(double* result, int n)
+{
+	/**
+	* Fills an array with uniform numbers. Generators that create several numbers at once override this method.
+	*
+	* @param[out] result n pseudo random numbers in [0,1]
+	* @param[in] n Number of pseudo random numbers
+	*/
+
+	for (int i = 0; i < n; ++i)
+	{
+		result[i] = Random();
+	}
+}
+
+void RanGen::gaussian_block(double* result, int n)
+{
+	/**
+	* @param[out] result n pseudo random numbers according to standard normal distribution
+	* @param[in] n Number of pseudo random numbers
+	*/
+
+	double x2 = 0;
+	for (int i = 0; i + 1 < n; i += 2)
+	{
+		polar(result[i], result[i + 1]);
+	}
+	if (n % 2 == 1)
+	{
+		polar(result[n - 1], x2);
+	}
+}
@@ -0,0 +1,267 @@
+/*
+* RunningStatistics.cpp
+*
+* Copyright 2017 Julian Hagemeister
+*
+* This file is part of MonteCrystal.
+*
+* MonteCrystal is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* MonteCrystal is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with MonteCrystal.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include "RunningStatistics.h"
+
+// forward and further includes
+#include "typedefs.h"
+
+#include <algorithm>
+#include <cmath>
+
+// minimum number of blocks of a blocking level to be considered for the error estimate
+#define MIN_BLOCKS 32
+// number of jackknife bins is between NUMBER_BINS and 2*NUMBER_BINS-1 once NUMBER_BINS values are added
+#define NUMBER_BINS 64
+
+RunningStatistics::RunningStatistics()
+{
+	clear();
+}
+
+RunningStatistics::~RunningStatistics()
+{
+}
+
+void RunningStatistics::add(const double &value)
+{
+	/**
+	* Updates mean and variance of all block sizes completed by value. O(1) on average.
+	*
+	* @param[in] value Measurement value
+	*/
+
+	if (_levels[0].count == 0)
+	{
+		_shift = value;
+	}
+	++_currentBin.count;
+	_currentBin.sum += value - _shift;
+	_currentBin.sumSquares += (value - _shift) * (value - _shift);
+	if (_currentBin.count == _binSize)
+	{
+		_bins.push_back(_currentBin);
+		_currentBin = JackknifeBin();
+		if (_bins.size() == 2 * NUMBER_BINS)
+		{
+			// merge pairs of bins
+			for (int i = 0; i < NUMBER_BINS; ++i)
+			{
+				_bins[i].count = _bins[2 * i].count + _bins[2 * i + 1].count;
+				_bins[i].sum = _bins[2 * i].sum + _bins[2 * i + 1].sum;
+				_bins[i].sumSquares = _bins[2 * i].sumSquares + _bins[2 * i + 1].sumSquares;
+			}
+			_bins.resize(NUMBER_BINS);
+			_binSize *= 2;
+		}
+	}
+
+	double blockMean = value;
+	for (int level = 0; ; ++level)
+	{
+		BlockLevel &block = _levels[level];
+		++block.count;
+		double delta = blockMean - block.mean;
+		block.mean += delta / block.count;
+		block.m2 += delta * (blockMean - block.mean);
+
+		if (block.boolPending == FALSE)
+		{
+			block.pending = blockMean;
+			block.boolPending = TRUE;
+			return;
+		}
+		// two blocks of this level form one block of the next level
+		blockMean = 0.5 * (block.pending + blockMean);
+		block.boolPending = FALSE;
+		if (level + 1 == _levels.size())
+		{
+			_levels.push_back(BlockLevel());
+		}
+	}
+}
+
+void RunningStatistics::clear(void)
+{
+	_levels.assign(1, BlockLevel());
+	_shift = 0;
+	_binSize = 1;
+	_bins.clear();
+	_currentBin = JackknifeBin();
+}
+
+int64_t RunningStatistics::get_count(void) const
+{
+	return _levels[0].count;
+}
+
+double RunningStatistics::get_mean(void) const
+{
+	return _levels[0].mean;
+}
+
+double RunningStatistics::get_variance(void) const
+{
+	return get_level_variance(0);
+}
+
+double RunningStatistics::get_population_variance(void) const
+{
+	if (_levels[0].count == 0)
+	{
+		return 0;
+	}
+	return _levels[0].m2 / _levels[0].count;
+}
+
+int RunningStatistics::get_number_levels(void) const
+{
+	int numberLevels = _levels.size();
+	while (numberLevels > 0 && _levels[numberLevels - 1].count == 0)
+	{
+		--numberLevels;
+	}
+	return numberLevels;
+}
+
+int64_t RunningStatistics::get_level_count(const int &level) const
+{
+	if (level < 0 || level >= _levels.size())
+	{
+		return 0;
+	}
+	return _levels[level].count;
+}
+
+double RunningStatistics::get_level_variance(const int &level) const
+{
+	/**
+	* @param[in] level Block size is 2**level
+	*
+	* @return Sample variance of block means; 0 for less than two blocks
+	*/
+
+	if (level < 0 || level >= _levels.size() || _levels[level].count < 2)
+	{
+		return 0;
+	}
+	return _levels[level].m2 / (_levels[level].count - 1);
+}
+
+double RunningStatistics::get_error(void) const
+{
+	/**
+	* The variance of the block means divided by the number of blocks grows with the block size until the
+	* blocks are longer than the autocorrelation time and then levels off. The largest value among the levels
+	* with at least MIN_BLOCKS blocks is taken. For few values the error of uncorrelated values is returned.
+	*
+	* @return Standard error of the mean
+	*/
+
+	double errorSquared = 0;
+	if (_levels[0].count > 1)
+	{
+		errorSquared = get_level_variance(0) / _levels[0].count;
+	}
+	for (int level = 1; level < _levels.size(); ++level)
+	{
+		if (_levels[level].count >= MIN_BLOCKS)
+		{
+			errorSquared = std::max(errorSquared, get_level_variance(level) / _levels[level].count);
+		}
+	}
+	return sqrt(errorSquared);
+}
+
+double RunningStatistics::get_autocorrelation_time(void) const
+{
+	/**
+	* @return tau_int = N * error**2 / (2 * variance)
+	*/
+
+	double variance = get_variance();
+	if (variance <= 0)
+	{
+		return 0.5;
+	}
+	double error = get_error();
+	return 0.5 * _levels[0].count * error * error / variance;
+}
+
+void RunningStatistics::jackknife_variances(std::vector<double> &variances, const int &boolSample) const
+{
+	/**
+	* Values of the incomplete bin are always included. Bins of different RunningStatistics objects with the
+	* same number of values are aligned, so the estimates can be combined before jackknife_error is called.
+	*
+	* @param[out] variances Variance of all values except those of bin i for each complete bin i
+	* @param[in] boolSample TRUE: sample variance (division by count - 1), FALSE: division by count
+	*/
+
+	JackknifeBin total = _currentBin;
+	for (int i = 0; i < _bins.size(); ++i)
+	{
+		total.count += _bins[i].count;
+		total.sum += _bins[i].sum;
+		total.sumSquares += _bins[i].sumSquares;
+	}
+
+	variances.assign(_bins.size(), 0);
+	for (int i = 0; i < _bins.size(); ++i)
+	{
+		double count = total.count - _bins[i].count;
+		double sum = total.sum - _bins[i].sum;
+		double sumSquares = total.sumSquares - _bins[i].sumSquares;
+		double divisor = (boolSample == TRUE) ? count - 1 : count;
+		if (divisor > 0)
+		{
+			variances[i] = (sumSquares - sum * sum / count) / divisor;
+		}
+	}
+}
+
+double RunningStatistics::jackknife_error(const std::vector<double> &estimates)
+{
+	/**
+	* @param[in] estimates Estimates of a quantity with one bin left out
+	*
+	* @return sqrt((B-1)/B * sum_i (estimate_i - mean)**2) for B bins; 0 for less than two bins
+	*/
+
+	int numberBins = estimates.size();
+	if (numberBins < 2)
+	{
+		return 0;
+	}
+	double mean = 0;
+	for (int i = 0; i < numberBins; ++i)
+	{
+		mean += estimates[i];
+	}
+	mean /= numberBins;
+	double sum = 0;
+	for (int i = 0; i < numberBins; ++i)
+	{
+		sum += (estimates[i] - mean) * (estimates[i] - mean);
+	}
+	return sqrt(sum * (numberBins - 1) / numberBins);
+}
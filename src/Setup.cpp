@@ -45,6 +45,8 @@
 #include "FourSpinInteraction.h"
 #include "BiquadraticInteraction.h"
 #include "DipolarInteraction.h"
+#include "DipolarInteractionFFT.h"
+#include "DipolarInteractionTree.h"
 #include "ZeemanEnergy.h"
 #include "Tip.h"
 #include "ModulatedExchangeInteraction.h"
@@ -58,6 +60,7 @@
 #include "NCMRContrastObservable.h"
 #include "WindingNumber.h"
 #include "Measurement.h"
+#include "ObservableEngine.h"
 
 Setup::Setup(const std::shared_ptr<Configuration> &config)
 {
@@ -188,39 +191,46 @@ void Setup::setup_measurement(void)
 
 	int numberMeasurements = 1; // arbitrary choice, changed later anyway
 
+	// the observables request their quantities from the engine, which evaluates all of them in one pass
+	auto engine = std::make_shared<ObservableEngine>(_spinOrientation->get_spin_array(), 
+		_spinOrientation->get_number_atoms());
+
 	if (_config->_doEnergyOutput)
 	{
 		observables.push_back(std::make_shared<EnergyObservable>(numberMeasurements, _hamilton,
-			_spinOrientation->get_number_atoms(), _config->_doSpinResolvedOutput));
+			_spinOrientation->get_number_atoms(), _config->_doSpinResolvedOutput, engine));
 	}
 
 	if (_config->_doMagnetisationOutput)
 	{
 		observables.push_back(std::make_shared<MagnetisationObservable>(numberMeasurements, 
-			_spinOrientation.data(), _config->_doSpinResolvedOutput));
+			_spinOrientation.data(), _config->_doSpinResolvedOutput, engine));
 	}
 
 	if (_config->_doAbsoluteMagnetisationOutput)
 	{
 		observables.push_back(std::make_shared<AbsoluteMagnetisationObservable>(numberMeasurements, 
-			                  _spinOrientation.data()));
+			                  _spinOrientation.data(), engine));
 	}
 
 	if (_config->_doNCMROutput)
 	{
 		observables.push_back(std::make_shared<NCMRContrastObservable>(numberMeasurements,
-			_spinOrientation->get_spin_array(), _spinOrientation->get_number_atoms(), 
-			_lattice->get_neighbor_array(1), _lattice->get_number_nth_neighbors(1)));
+			_spinOrientation->get_number_atoms(), _lattice->get_neighbor_array(1), 
+			_lattice->get_number_nth_neighbors(1), engine));
 	}
 
 	if (_config->_doWindingNumberOutput == TRUE)
 	{
 		observables.push_back(std::make_shared<WindingNumber>(numberMeasurements, 
-			_spinOrientation->get_spin_array(),	_lattice->get_skN_cells(), _lattice->get_skN_cell_number()));
+			_spinOrientation->get_spin_array(),	_lattice->get_skN_cells(), _lattice->get_skN_cell_number(),
+			engine));
 	}
 
 	// create measurement object. this will be used for all measurements later on in the programme.
-	_measurement = std::make_shared<Measurement>(observables);
+	_measurement = std::make_shared<Measurement>(observables, engine);
+	_measurement->set_accumulate(_config->_accumulateObservables);
+	_measurement->set_error_analysis(_config->_errorAnalysis);
 }
 
 void Setup::setup_hamiltonian(void)
@@ -234,6 +244,10 @@ void Setup::setup_hamiltonian(void)
 
 	// setup Hamilton object
 	_hamilton = QSharedPointer<Hamiltonian>(new Hamiltonian(_energies, _lattice->get_number_atoms()));
+	if (_config->_fusedPairField == TRUE)
+	{
+		_hamilton->setup_pair_interaction_field(_spinOrientation->get_spin_array());
+	}
 
 	std::cout << "Hamiltonian was created." << std::endl;
 }
@@ -275,6 +289,52 @@ void Setup::setup_energies(void)
 	setup_anisotropy_defects();
 }
 
+std::vector<std::vector<int>> Setup::create_color_classes(void) const
+{
+	/**
+	* Partition lattice sites into classes of sites that do not interact with each other via the energies 
+	* specified in _config. Needed for the parallel Metropolis sweep.
+	*
+	* @return Classes of lattice site indexes. Empty if the Hamiltonian contains the long-ranged dipolar
+	*         interaction.
+	*/
+
+	if (_config->_dipolEnergy == TRUE)
+	{
+		std::cout << "Parallel sweep not possible with dipolar interaction. Serial sweep is used." << std::endl;
+		return {};
+	}
+
+	// orders of neighbor shells included in the Hamiltonian
+	std::vector<int> orders;
+	for (auto it = _config->_exchangeEnergies.begin(); it != _config->_exchangeEnergies.end(); ++it)
+	{
+		orders.push_back(it->order);
+	}
+	for (auto it = _config->_DMEnergies.begin(); it != _config->_DMEnergies.end(); ++it)
+	{
+		orders.push_back(it->order);
+	}
+	if (fabs(_config->_pseudoDipolarEnergy) > PRECISION || fabs(_config->_biQuadraticEnergy) > PRECISION
+		|| !_config->_modulatedExchangeEnergies.empty())
+	{
+		orders.push_back(1);
+	}
+	for (auto it = _config->_exchangeDefects.begin(); it != _config->_exchangeDefects.end(); ++it)
+	{
+		orders.push_back(it->first);
+	}
+	for (auto it = _config->_dmDefects.begin(); it != _config->_dmDefects.end(); ++it)
+	{
+		orders.push_back(it->first);
+	}
+
+	int boolFourSpin = fabs(_config->_fourSpinEnergy) > PRECISION;
+	int boolThreeSite = fabs(_config->_threeSiteEnergy) > PRECISION;
+
+	return _lattice->create_color_classes(orders, boolFourSpin, boolThreeSite);
+}
+
 void Setup::set_magnetic_field(Threedim direction)
 {
 	/**
@@ -479,8 +539,28 @@ void Setup::setup_dipol_interaction(void)
 
 	if (_config->_dipolEnergy == TRUE) // dipol-dipol energy setup
 	{
-		_energies.push_back(std::make_shared<DipolarInteraction>(_spinOrientation->get_spin_array(), 
-			_config->_magneticMoment, _config->_latticeConstant, _lattice.data()));
+		if (_config->_dipolarMethod == dipolarTree)
+		{
+			_energies.push_back(std::make_shared<DipolarInteractionTree>(_spinOrientation->get_spin_array(),
+				_config->_magneticMoment, _config->_latticeConstant, _lattice.data(), 
+				_config->_dipolarOpeningAngle));
+		}
+		else if (_config->_dipolarMethod != dipolarDirect 
+			&& DipolarInteractionFFT::lattice_on_grid(_lattice.data()) == TRUE)
+		{
+			_energies.push_back(std::make_shared<DipolarInteractionFFT>(_spinOrientation->get_spin_array(),
+				_config->_magneticMoment, _config->_latticeConstant, _lattice.data()));
+		}
+		else
+		{
+			if (_config->_dipolarMethod == dipolarFFT)
+			{
+				std::cout << "Lattice sites do not lie on a regular grid. Dipolar interaction is evaluated "
+					"by direct summation." << std::endl;
+			}
+			_energies.push_back(std::make_shared<DipolarInteraction>(_spinOrientation->get_spin_array(),
+				_config->_magneticMoment, _config->_latticeConstant, _lattice.data()));
+		}
 	}
 }
 
@@ -24,6 +24,8 @@
 
 #include <QMutex>
 
+#include <algorithm>
+
 // forward includes
 #include "SpinOrientation.h"
 #include "Hamiltonian.h"
@@ -31,6 +33,8 @@
 #include "Measurement.h"
 #include "SimulationProgram.h"
 #include "Lattice.h"
+#include "OutputWriter.h"
+#include "SpinConfigurationFile.h"
 
 
 SimulationMethod::SimulationMethod(SpinOrientation* spinOrientation, int simulationSteps, double temperature, 
@@ -60,6 +64,20 @@ SimulationMethod::SimulationMethod(SpinOrientation* spinOrientation, int simulat
 
 	_boolConvergenceCriterion = FALSE;
 
+	_spinFileFormat = spinFileText;
+	_outputWriter = NULL;
+	_targetRelativeError = 0;
+	_latticeHash = 0;
+
+	_torqueTolerance = 0;
+	_energyTolerance = 0;
+	_convergenceChecks = 1;
+	_convergenceWidth = 0;
+	_numberConverged = 0;
+	_boolLastEnergy = FALSE;
+	_lastEnergy = 0;
+	_stepsPerformed = 0;
+
 	_simulationProgram = simulationProgram;
 }
 
@@ -85,17 +103,42 @@ void SimulationMethod::run_simulation(int uiUpdateWidth, std::shared_ptr<Measure
 
 	std::stringstream stream;
 
+	// binary output: all spin configurations between movieStart and movieEnd in one file
+	std::shared_ptr<SpinConfigurationFile> movieFile;
+
 	double convergenceCriterion = 1;
+	_numberConverged = 0;
+	_boolLastEnergy = FALSE;
+	_stepsPerformed = 0;
+
+	// spin configuration may have been changed since the last run
+	_hamilton->update_spin_configuration();
+
+	// equilibration (e.g. adaptation of cone width) in addition to the measured steps
+	while (equilibrating() == TRUE)
+	{
+		_simulationProgram->_mutex->lock();
+		simulation_step();
+		int boolTerminate = *(_simulationProgram->_terminateThread);
+		_simulationProgram->_mutex->unlock();
+		if (boolTerminate == 1)
+		{
+			return;
+		}
+	}
 	
 	for (int i = 1; i < _simulationSteps + 1; i++)
 	{
+		_stepsPerformed = i;
+		int boolCheck = (_convergenceWidth > 0 && (i % _convergenceWidth) == 0) ? TRUE : FALSE;
 
 		_simulationProgram->_mutex->lock();
-		if ((i % uiUpdateWidth) == 0)
+		if ((i % uiUpdateWidth) == 0 || boolCheck == TRUE)
 		{
 			_boolConvergenceCriterion = TRUE;
 		}
 		convergenceCriterion = simulation_step();
+		_boolConvergenceCriterion = FALSE;
 		_simulationProgram->_mutex->unlock();
 
 		if ((i % uiUpdateWidth) == 0)
@@ -112,12 +155,17 @@ void SimulationMethod::run_simulation(int uiUpdateWidth, std::shared_ptr<Measure
 				return;
 			}
 			_simulationProgram->_mutex->unlock();
-			_boolConvergenceCriterion = FALSE;
 		}
 
 		if ((i % outputWidth) == 0)
 		{
 			measurement->measure();
+			if (_targetRelativeError > 0 && measurement->target_error_reached(_targetRelativeError) == TRUE)
+			{
+				measurement->stop_early();
+				_simulationProgram->send_simulation_step("Step = " + QString::number(i) + " (target error)");
+				return;
+			}
 		}
 
 		if ((i >= movieStart) && (i <= movieEnd))
@@ -130,13 +178,197 @@ void SimulationMethod::run_simulation(int uiUpdateWidth, std::shared_ptr<Measure
 				_simulationProgram->send_repaint_request();
 				_simulationProgram->send_save_image_request(QString::fromStdString(fname + stream.str()
 					+  ".png"));
-				Functions::save(_spinOrientation->get_activity_list(), _spinOrientation->get_spin_array(), 
-					_spinOrientation->get_number_atoms(), fname + stream.str());
+				if (_spinFileFormat == spinFileText)
+				{
+					int* activityList = _spinOrientation->get_activity_list();
+					if (_outputWriter != NULL)
+					{
+						_outputWriter->save_spin_configuration(fname + stream.str(), activityList,
+							_spinOrientation->get_spin_array(), _spinOrientation->get_number_atoms());
+					}
+					else
+					{
+						Functions::save(activityList, _spinOrientation->get_spin_array(),
+							_spinOrientation->get_number_atoms(), fname + stream.str());
+					}
+					delete[] activityList;
+				}
+				else
+				{
+					if (!movieFile)
+					{
+						int* activityList = _spinOrientation->get_activity_list();
+						movieFile = std::make_shared<SpinConfigurationFile>();
+						movieFile->create(fname + "SpinConfigurations", _spinOrientation->get_number_atoms(),
+							activityList, _latticeHash, (_spinFileFormat == spinFileFloat32) ? 4 : 8);
+						delete[] activityList;
+					}
+					if (_outputWriter != NULL)
+					{
+						// file is closed by writer thread after last frame
+						_outputWriter->append_frame(movieFile, _spinOrientation->get_spin_array(),
+							_spinOrientation->get_number_atoms(), i);
+					}
+					else
+					{
+						movieFile->append_frame(_spinOrientation->get_spin_array(), i);
+					}
+				}
+			}
+		}
+
+		if (boolCheck == TRUE && converged(convergenceCriterion) == TRUE)
+		{
+			measurement->stop_early();
+			_simulationProgram->send_simulation_step("Step = " + QString::number(i) + " (converged)");
+			_simulationProgram->send_simulation_convergence_criterion("conv. = "
+				+ QString::number(convergenceCriterion));
+			_simulationProgram->send_repaint_request();
+			return;
+		}
+	}
+}
+
+void SimulationMethod::run_simulation(std::shared_ptr<Measurement> measurement, int outputWidth)
+{
+	/**
+	* Simulation run with _simulationSteps number of simulation steps for simulations that run in parallel to 
+	* other simulations. The GUI is neither updated nor locked out.
+	*
+	* @param[in] measurement Take measurement values for energy, magnetization...
+	* @param[in] outputWidth Take measurement value every outputWidth simulation steps
+	*/
+
+	_numberConverged = 0;
+	_boolLastEnergy = FALSE;
+	_stepsPerformed = 0;
+
+	_hamilton->update_spin_configuration();
+	// equilibration (e.g. adaptation of cone width) in addition to the measured steps
+	while (equilibrating() == TRUE)
+	{
+		simulation_step();
+	}
+	for (int i = 1; i < _simulationSteps + 1; i++)
+	{
+		_stepsPerformed = i;
+		int boolCheck = (_convergenceWidth > 0 && (i % _convergenceWidth) == 0) ? TRUE : FALSE;
+
+		_boolConvergenceCriterion = boolCheck;
+		double convergenceCriterion = simulation_step();
+		_boolConvergenceCriterion = FALSE;
+
+		if ((i % outputWidth) == 0)
+		{
+			measurement->measure();
+			if (_targetRelativeError > 0 && measurement->target_error_reached(_targetRelativeError) == TRUE)
+			{
+				measurement->stop_early();
+				return;
 			}
 		}
+
+		if (boolCheck == TRUE && converged(convergenceCriterion) == TRUE)
+		{
+			measurement->stop_early();
+			return;
+		}
 	}
 }
 
+void SimulationMethod::set_spin_file_format(SpinFileFormat spinFileFormat, uint64_t latticeHash)
+{
+	/**
+	* @param[in] spinFileFormat Text files (one file per spin configuration) or binary file (all spin 
+	*                           configurations of one run in one file, see SpinConfigurationFile)
+	* @param[in] latticeHash Hash of lattice stored in binary files
+	*/
+
+	_spinFileFormat = spinFileFormat;
+	_latticeHash = latticeHash;
+}
+
+void SimulationMethod::set_output_writer(OutputWriter* outputWriter)
+{
+	/**
+	* @param[in] outputWriter Writer thread for spin configurations; NULL for output in simulation thread
+	*/
+
+	_outputWriter = outputWriter;
+}
+
+void SimulationMethod::set_target_relative_error(double targetRelativeError)
+{
+	/**
+	* @param[in] targetRelativeError Relative error of mean values (see Measurement::target_error_reached) at 
+	*                                which a run ends before _simulationSteps; 0 for fixed run length
+	*/
+
+	_targetRelativeError = targetRelativeError;
+}
+
+void SimulationMethod::set_convergence_stop(double torqueTolerance, double energyTolerance,
+	int consecutiveChecks, int checkWidth)
+{
+	/**
+	* The convergence criterion (maximum torque returned by simulation_step) is evaluated within the site loop of
+	* the simulation step at check steps only. The energy change requires one evaluation of the total energy 
+	* per check step. A check is passed if any enabled quantity is below its tolerance.
+	*
+	* @param[in] torqueTolerance Tolerance of convergence criterion; 0 to disable
+	* @param[in] energyTolerance Tolerance of change of total energy per active site between two checks [meV];
+	*                            0 to disable
+	* @param[in] consecutiveChecks Number of consecutive checks below tolerance after which the run ends
+	* @param[in] checkWidth Check every checkWidth simulation steps
+	*/
+
+	_torqueTolerance = torqueTolerance;
+	_energyTolerance = energyTolerance;
+	_convergenceChecks = std::max(consecutiveChecks, 1);
+	_convergenceWidth = 0;
+	if ((_torqueTolerance > 0 || _energyTolerance > 0) && checkWidth > 0)
+	{
+		_convergenceWidth = checkWidth;
+	}
+}
+
+int SimulationMethod::get_steps_performed(void) const
+{
+	/**
+	* @return Number of simulation steps of last run; less than _simulationSteps if run ended early
+	*/
+
+	return _stepsPerformed;
+}
+
+int SimulationMethod::converged(double convergenceCriterion)
+{
+	/**
+	* @param[in] convergenceCriterion Convergence criterion returned by simulation_step at check step
+	*
+	* @return TRUE if _convergenceChecks consecutive checks were below tolerance
+	*/
+
+	int boolBelow = FALSE;
+	if (_torqueTolerance > 0 && convergenceCriterion < _torqueTolerance)
+	{
+		boolBelow = TRUE;
+	}
+	if (_energyTolerance > 0)
+	{
+		double energy = _hamilton->total_energy();
+		if (_boolLastEnergy == TRUE && fabs(energy - _lastEnergy) < _energyTolerance * _numberActiveSites)
+		{
+			boolBelow = TRUE;
+		}
+		_lastEnergy = energy;
+		_boolLastEnergy = TRUE;
+	}
+
+	_numberConverged = (boolBelow == TRUE) ? _numberConverged + 1 : 0;
+	return (_numberConverged >= _convergenceChecks) ? TRUE : FALSE;
+}
+
 void SimulationMethod::relaxate(int simulationSteps)
 {
 	/**
@@ -145,12 +377,18 @@ void SimulationMethod::relaxate(int simulationSteps)
 	* @param[in] simulationSteps Number of simulation steps to be performed
 	*/
 
+	_hamilton->update_spin_configuration();
 	for (int i = 0; i < simulationSteps; ++i)
 	{
 		simulation_step();
 	}
 }
 
+int SimulationMethod::equilibrating(void) const
+{
+	return FALSE;
+}
+
 void SimulationMethod::set_temperature(double temperature)
 {
 	/**
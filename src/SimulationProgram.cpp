@@ -33,22 +33,34 @@
 #include "SpinOrientation.h"
 #include "Setup.h"
 #include "Mersenne.h"
+#include "PhiloxRanGen.h"
 
 #include <QMutex>
 
 #include "Hamiltonian.h"
 #include "Energy.h"
 #include "Measurement.h"
+#include "OutputWriter.h"
 #include "WindingNumber.h"
+#include "ObservableEngine.h"
 #include "Functions.h"
 #include "Metropolis.h"
 #include "LandauLifshitzGilbert.h"
 #include "ExcitationModeSolver.h"
 #include "Converger1.h"
+#include "EnergyMinimizer.h"
+#include "ClusterUpdate.h"
+#include "GeodesicNudgedElasticBand.h"
+#include "SpinConfigurationFile.h"
 
+#include <omp.h>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
+// GNEB: climbing image starts when maximum force is below this factor times the tolerance
+#define GNEB_CLIMBING_FACTOR 10
+
 SimulationProgram::SimulationProgram(QDir &workfolder, const std::shared_ptr<Configuration> &config, 
 	QMutex* mutex, int* terminateThread, QSharedPointer<Lattice> lattice,
 	QSharedPointer<SpinOrientation> spinOrientation)
@@ -94,7 +106,10 @@ void SimulationProgram::main(void)
 	*/
 
 	// Create pseudo random number generator
-	std::shared_ptr<RanGen> ranGen = std::make_shared<Mersenne>(_config->_seed);
+	std::shared_ptr<RanGen> ranGen = create_random_generator(_config->_seed);
+
+	// output files are written in a separate thread
+	_outputWriter = std::make_shared<OutputWriter>(_config->_outputBuffers);
 
 	// Create object that manages lattice, spin configuration and Hamiltonian with energy objects
 	auto setup = std::make_shared<Setup>(_config);
@@ -130,7 +145,7 @@ void SimulationProgram::main(void)
 
 	if (_config->_programType == readSpinConfiguration)
 	{
-		int numberLines = Functions::get_num_lines(_config->_storageFname);
+		int numberLines = spin_file_number_atoms(_config->_storageFname, setup->_lattice.data());
 		if (numberLines == setup->_lattice->get_number_atoms())
 		{
 			setup->create_spin_orientation(ranGen);
@@ -181,9 +196,7 @@ void SimulationProgram::main(void)
 			_config->_storageFname);
 		break;
 	case saveSpinConfiguration:
-		Functions::save(setup->_spinOrientation->get_activity_list(),
-			setup->_spinOrientation->get_spin_array(),
-			setup->_spinOrientation->get_number_atoms(), _config->_storageFname);
+		save_spin_configuration(setup->_spinOrientation.data(), setup->_lattice.data(), _config->_storageFname);
 		break;
 	case latticeSiteEnergies: 
 		// save energies resolved to lattice sites for a read in spin orienation. 
@@ -213,6 +226,20 @@ void SimulationProgram::main(void)
 		spin_seebeck(setup, ranGen, _config->_doOutput);
 		break;
 
+	case parallelTempering:
+		// Metropolis simulation with one replica per temperature and exchange of spin configurations
+		std::cout << "---------------------------------------------" << std::endl;
+		std::cout << "Parallel tempering calculation starts." << std::endl;
+		parallel_tempering(setup, ranGen, _config->_doOutput);
+		break;
+
+	case geodesicNudgedElasticBand:
+		// minimum energy path and energy barrier between two spin configurations
+		std::cout << "---------------------------------------------" << std::endl;
+		std::cout << "Geodesic nudged elastic band calculation starts." << std::endl;
+		geodesic_nudged_elastic_band(setup, ranGen);
+		break;
+
 	case tipMovement:
 		// Simulation with a magnetic tip to simulate influence of tip of scanning tunneling microscope
 		std::cout << "---------------------------------------------" << std::endl;
@@ -225,6 +252,9 @@ void SimulationProgram::main(void)
 		break;
 	}
 
+	// all output files are written before the end of the simulation program is announced
+	_outputWriter->flush();
+
 	// Send notification about end of simulation program
 	emit send_finished(); 
 }
@@ -298,7 +328,8 @@ void SimulationProgram::save_local_winding_number(const std::shared_ptr<Setup> &
 
 	// Calculate winding number/topological charge for the given spin configuration
 	auto windNum = std::make_shared<WindingNumber>(1, setup->_spinOrientation->get_spin_array(), cells, 
-		cellNum);
+		cellNum, std::make_shared<ObservableEngine>(setup->_spinOrientation->get_spin_array(), 
+		setup->_spinOrientation->get_number_atoms()));
 	windNum->evaluate_local_winding_number();
 
 	// header for the file in which the winding number will be stored
@@ -348,6 +379,20 @@ void SimulationProgram::temperature_magnetic_field_loop(const std::shared_ptr<Se
 	* @param[in] ranGen Pseudo random number generator.
 	*/
 
+	// points of the loop are independent of each other
+	if (_config->_sweepThreads > 0)
+	{
+		if (_config->_numEigenStates > 0)
+		{
+			std::cout << "Eigen frequencies require sequential temperature and magnetic field loop." << std::endl;
+		}
+		else
+		{
+			independent_sweep(setup, boolFolderOutput);
+			return;
+		}
+	}
+
 	// unique simulation identity number
 	std::string simID = "";
 
@@ -391,8 +436,40 @@ void SimulationProgram::temperature_magnetic_field_loop(const std::shared_ptr<Se
 		simulation = std::make_shared<Converger1>(setup->_spinOrientation.data(),
 			_config->_simulationSteps, 1, setup->_hamilton, ranGen, this);
 		break;
+	case energyMinimizer:
+		simulation = std::make_shared<EnergyMinimizer>(setup->_spinOrientation.data(),
+			_config->_simulationSteps, 1, setup->_hamilton, ranGen, _config->_minimizerMemory, this);
+		break;
+	case clusterUpdate:
+		simulation = std::make_shared<ClusterUpdate>(setup->_spinOrientation.data(),
+			_config->_simulationSteps, 1, setup->_hamilton, ranGen, _config->_clusterMetropolisSweeps, this);
+		break;
 	}
 
+	// file format of spin configurations between movie start and movie end
+	simulation->set_spin_file_format(_config->_spinFileFormat, SpinConfigurationFile::lattice_hash(
+		setup->_lattice->get_lattice_coordinate_array(), setup->_lattice->get_number_atoms()));
+	simulation->set_output_writer(_outputWriter.get());
+	simulation->set_target_relative_error(_config->_targetRelativeError);
+	// convergence stop only for deterministic methods; Monte Carlo runs are ended by the target error
+	if (_config->_simulationType == converger1 || _config->_simulationType == landauLifshitzGilbert
+		|| _config->_simulationType == energyMinimizer)
+	{
+		simulation->set_convergence_stop(_config->_convergenceTorque, _config->_convergenceEnergy,
+			_config->_convergenceChecks, _config->_convergenceWidth);
+	}
+
+	// the pattern of the spin wave matrix is the same in all steps of the loop
+	std::shared_ptr<ExcitationModeSolver> excitationModeSolver;
+	if (_config->_numEigenStates > 0)
+	{
+		excitationModeSolver = std::make_shared<ExcitationModeSolver>(setup->_spinOrientation.data(), 
+			setup->_hamilton);
+	}
+
+	// options of Metropolis algorithm
+	configure_metropolis(setup, simulation);
+
 	//  Temperatures for temperature loop
 	std::vector<double> temperature = MyMath::linspace(_config->_temperatureStart, _config->_temperatureEnd,
 		_config->_temperatureSteps);
@@ -433,8 +510,23 @@ void SimulationProgram::temperature_magnetic_field_loop(const std::shared_ptr<Se
 			fname.append(Functions::get_name(*tempPtr));
 
 			// run simulation
+			open_step_output(measurement, fname + "_observables");
 			simulation->run_simulation(_config->_uiUpdateWidth, measurement ,_config->_outputWidth, 
 				_config->_movieStart, _config->_movieEnd, _config->_movieWidth, fname);
+			measurement->close_step_output();
+			if (simulation->get_steps_performed() < _config->_simulationSteps)
+			{
+				std::cout << "run ended after " << simulation->get_steps_performed() << " steps" << std::endl;
+			}
+			if (_config->_simulationType == clusterUpdate)
+			{
+				auto clusterMethod = std::static_pointer_cast<ClusterUpdate>(simulation);
+				double clusterSize = clusterMethod->get_mean_cluster_size();
+				std::cout << "mean cluster size: " << clusterSize << " (" << 100 * clusterSize
+					/ setup->_spinOrientation->get_number_active_sites() << " % of active sites), "
+					<< "accepted cluster flips: " << 100 * clusterMethod->get_cluster_acceptance() << " %" 
+					<< std::endl;
+			}
 
 			// check for abortion of simulation
 			_mutex->lock();
@@ -452,13 +544,22 @@ void SimulationProgram::temperature_magnetic_field_loop(const std::shared_ptr<Se
 				switch (_config->_simulationType)
 				{					
 				case metropolis:
+				case clusterUpdate:
 					header.append("MCStep");
-					measurement->save_step_values(fname + "_observables", header, _config->_outputWidth);
+					_outputWriter->save_text(fname + "_observables",
+						measurement->step_values_text(header, _config->_outputWidth));
+					break;
+				case converger1:
+				case energyMinimizer:
+					header.append("Step");
+					_outputWriter->save_text(fname + "_observables",
+						measurement->step_values_text(header, _config->_outputWidth));
 					break;
 				case landauLifshitzGilbert:
 					header.append("t_[ps]");
 					double width = _config->_outputWidth * _config->_LLG_timeWidth;
-					measurement->save_step_values(fname + "_observables", header, width);
+					_outputWriter->save_text(fname + "_observables",
+						measurement->step_values_text(header, width));
 					break;
 				}
 			}
@@ -473,10 +574,9 @@ void SimulationProgram::temperature_magnetic_field_loop(const std::shared_ptr<Se
 			// output of spin configuration at end of loop step
 			if (_config->_doSpinConfigOutput)
 			{ 
-				// save spin configuration as text file
-				Functions::save(setup->_spinOrientation->get_activity_list(), 
-					setup->_spinOrientation->get_spin_array(),
-					setup->_spinOrientation->get_number_atoms(), fname + "SpinConfigurationAtEnd");
+				// save spin configuration as text or binary file
+				save_spin_configuration(setup->_spinOrientation.data(), setup->_lattice.data(),
+					fname + "SpinConfigurationAtEnd");
 
 				// save spin configuration as png image from GUI widget
 				emit send_repaint_request();
@@ -489,7 +589,7 @@ void SimulationProgram::temperature_magnetic_field_loop(const std::shared_ptr<Se
 			/////////////////////////////
 			if (_config->_numEigenStates > 0)
 			{
-				eigen_frequency(setup, fname);
+				eigen_frequency(setup, excitationModeSolver, fname);
 			}
 			/////////////////////////////
 		}
@@ -501,11 +601,257 @@ void SimulationProgram::temperature_magnetic_field_loop(const std::shared_ptr<Se
 		fname = outputFolder;
 		fname.append(simID);
 		fname.append("_MeanValues");
-		measurement->save_mean_steps(fname, "T[K] B[T] ");
+		_outputWriter->save_text(fname, measurement->mean_steps_text("T[K] B[T] "));
 	}
 
 	// Save information about the lattice used in the simulation to simulation folder
 	save_lattice_information(setup->_lattice.data(), simFolder.absolutePath().toStdString() + "/SYSTEM/", simID, boolFolderOutput);
+
+	// wait for output of all loop points
+	_outputWriter->flush();
+}
+
+void SimulationProgram::independent_sweep(const std::shared_ptr<Setup> &setup, int boolFolderOutput)
+{
+	/**
+	* Simulation of all points of the temperature and magnetic field loop independently of each other. Each
+	* point starts from the spin configuration of setup. The points are distributed dynamically over 
+	* _config->_sweepThreads threads; each thread works on its own copy of spin configuration and Hamiltonian 
+	* while the lattice is shared. The pseudo random numbers of each point are derived from _config->_seed and
+	* the index of the point, so the results do not depend on the number of threads. Mean values are saved in
+	* the same order as in the sequential temperature and magnetic field loop.
+	*
+	* @param[in] setup The information about lattice, spin configuration and Hamiltonian.
+	* @param[in] boolFolderOutput TRUE for output into simulation folder.
+	*/
+
+	// unique simulation identity number
+	std::string simID = "";
+
+	// determine unique identity number and created unique folder for simulation output
+	QDir simFolder = create_unique_simulation_folder(simID, boolFolderOutput);
+	// folder for simulation ouput
+	std::string outputFolder = simFolder.absolutePath().toStdString() + "/SIMULATION/";
+
+	// measurement object of setup collects the mean values of all points
+	setup->setup_measurement();
+	auto measurement = setup->_measurement;
+
+	// number of "measurements" done during one point of temperature and magnetic field loop
+	int numMeasurements = _config->_simulationSteps / _config->_outputWidth;
+
+	//  Temperatures for temperature loop
+	std::vector<double> temperature = MyMath::linspace(_config->_temperatureStart, _config->_temperatureEnd,
+		_config->_temperatureSteps);
+
+	// Magnetic fields for magnetic field loop
+	std::vector<double> magneticField = MyMath::linspace(_config->_magneticField.start,
+		_config->_magneticField.end, _config->_magneticField.steps);
+
+	int numberPoints = magneticField.size() * temperature.size();
+	int numberWorkers = std::max(std::min(_config->_sweepThreads, numberPoints), 1);
+
+	// sites with common cone width for adaptation of restricted cone
+	std::vector<std::vector<int>> coneGroups;
+	if (_config->_adaptiveConeAcceptance > 0 && _config->_adaptiveConePerClass == TRUE)
+	{
+		coneGroups = setup->create_color_classes();
+	}
+
+	// copies of spin configuration and Hamiltonian for each thread
+	Threedim* initialSpins = setup->_spinOrientation->get_spin_array();
+	int numberAtoms = setup->_spinOrientation->get_number_atoms();
+	std::vector<std::shared_ptr<Setup>> workers;
+	std::vector<std::shared_ptr<RanGen>> workerRanGens;
+	for (int w = 0; w < numberWorkers; ++w)
+	{
+		auto workerRanGen = create_random_generator(_config->_seed);
+		auto worker = std::make_shared<Setup>(_config);
+		worker->_lattice = setup->_lattice;
+		worker->create_spin_orientation(workerRanGen);
+		int* inactiveSites = setup->_spinOrientation->get_inactive_sites();
+		for (int i = 0; i < setup->_spinOrientation->get_number_inactive_sites(); ++i)
+		{
+			worker->_spinOrientation->set_inactive_site(inactiveSites[i]);
+		}
+		worker->setup_hamiltonian();
+		worker->setup_measurement();
+		worker->_measurement->set_number_measurements(numMeasurements);
+		workers.push_back(worker);
+		workerRanGens.push_back(workerRanGen);
+	}
+
+	// mean values of each point
+	std::vector<std::shared_ptr<Measurement>> pointMeanValues(numberPoints);
+	int boolTerminate = FALSE;
+	int finishedPoints = 0;
+
+	#pragma omp parallel for schedule(dynamic, 1) num_threads(numberWorkers)
+	for (int point = 0; point < numberPoints; ++point)
+	{
+		#pragma omp flush(boolTerminate)
+		if (boolTerminate == TRUE)
+		{
+			continue;
+		}
+
+		const std::shared_ptr<Setup> &worker = workers[omp_get_thread_num()];
+		std::shared_ptr<RanGen> ranGen = workerRanGens[omp_get_thread_num()];
+		double field = magneticField[point / temperature.size()];
+		double temp = temperature[point % temperature.size()];
+
+		ranGen->set_stream(_config->_seed, point);
+		Threedim* spinArray = worker->_spinOrientation->get_spin_array();
+		std::copy(initialSpins, initialSpins + numberAtoms, spinArray);
+		worker->set_magnetic_field(field);
+
+		std::shared_ptr<SimulationMethod> simulation;
+		switch (_config->_simulationType)
+		{
+		case metropolis:
+			simulation = std::make_shared<Metropolis>(worker->_spinOrientation.data(), _config->_simulationSteps,
+				temp, worker->_hamilton, ranGen, this);
+			if (_config->_spinSystem == Heisenberg)
+			{
+				std::static_pointer_cast<Metropolis>(simulation)->set_kernels(_config->_heatBathFraction,
+					_config->_overRelaxationSweeps);
+			}
+			if (_config->_adaptiveConeAcceptance > 0)
+			{
+				std::static_pointer_cast<Metropolis>(simulation)->set_adaptive_cone(
+					_config->_adaptiveConeAcceptance, _config->_adaptiveConeSteps, coneGroups);
+			}
+			break;
+		case landauLifshitzGilbert:
+			simulation = std::make_shared<LandauLifshitzGilbert>(worker->_spinOrientation.data(),
+				_config->_simulationSteps, temp, worker->_hamilton, ranGen, _config->_LLG_timeWidth,
+				_config->_LLG_dampingParameter, _config->_magneticMoment, this);
+			break;
+		case converger1:
+			simulation = std::make_shared<Converger1>(worker->_spinOrientation.data(),
+				_config->_simulationSteps, temp, worker->_hamilton, ranGen, this);
+			break;
+		case energyMinimizer:
+			simulation = std::make_shared<EnergyMinimizer>(worker->_spinOrientation.data(),
+				_config->_simulationSteps, temp, worker->_hamilton, ranGen, _config->_minimizerMemory, this);
+			break;
+		case clusterUpdate:
+			simulation = std::make_shared<ClusterUpdate>(worker->_spinOrientation.data(),
+				_config->_simulationSteps, temp, worker->_hamilton, ranGen, _config->_clusterMetropolisSweeps,
+				this);
+			break;
+		}
+
+		// basis file name for output of this point of the temperature and magnetic field loops
+		std::string fname = outputFolder;
+		fname.append(simID);
+		fname.append("_B_");
+		fname.append(Functions::get_name(field / (_config->_magneticMoment*muBohr)));
+		fname.append("_T_");
+		fname.append(Functions::get_name(temp));
+
+		// run simulation
+		simulation->set_target_relative_error(_config->_targetRelativeError);
+		// convergence stop only for deterministic methods; Monte Carlo runs are ended by the target error
+		if (_config->_simulationType == converger1 || _config->_simulationType == landauLifshitzGilbert
+			|| _config->_simulationType == energyMinimizer)
+		{
+			simulation->set_convergence_stop(_config->_convergenceTorque, _config->_convergenceEnergy,
+				_config->_convergenceChecks, _config->_convergenceWidth);
+		}
+		open_step_output(worker->_measurement, fname + "_observables");
+		simulation->run_simulation(worker->_measurement, _config->_outputWidth);
+		worker->_measurement->close_step_output();
+		int stepsPerformed = simulation->get_steps_performed();
+		double clusterSize = 0;
+		double clusterAcceptance = 0;
+		if (_config->_simulationType == clusterUpdate)
+		{
+			clusterSize = std::static_pointer_cast<ClusterUpdate>(simulation)->get_mean_cluster_size();
+			clusterAcceptance = std::static_pointer_cast<ClusterUpdate>(simulation)->get_cluster_acceptance();
+		}
+
+		// output of measurement information as a function of simulation steps
+		if (_config->_doSimulationStepsOutput)
+		{
+			switch (_config->_simulationType)
+			{
+			case metropolis:
+			case clusterUpdate:
+				_outputWriter->save_text(fname + "_observables",
+					worker->_measurement->step_values_text("MCStep", _config->_outputWidth));
+				break;
+			case converger1:
+			case energyMinimizer:
+				_outputWriter->save_text(fname + "_observables",
+					worker->_measurement->step_values_text("Step", _config->_outputWidth));
+				break;
+			case landauLifshitzGilbert:
+				double width = _config->_outputWidth * _config->_LLG_timeWidth;
+				_outputWriter->save_text(fname + "_observables",
+					worker->_measurement->step_values_text("t_[ps]", width));
+				break;
+			}
+		}
+
+		// average mean values of observables over simulation steps
+		std::stringstream stringStream;
+		stringStream << temp << " " << field / (_config->_magneticMoment*muBohr);
+		worker->_measurement->take_mean_values(stringStream.str(), temp);
+		pointMeanValues[point] = std::make_shared<Measurement>(std::vector<std::shared_ptr<Observable>>());
+		worker->_measurement->transfer_mean_values(*pointMeanValues[point]);
+		worker->_measurement->reset_observables_measurement_index();
+
+		// output of spin configuration at end of point
+		if (_config->_doSpinConfigOutput)
+		{
+			save_spin_configuration(worker->_spinOrientation.data(), setup->_lattice.data(),
+				fname + "SpinConfigurationAtEnd");
+		}
+
+		_mutex->lock();
+		++finishedPoints;
+		std::cout << "B = " << field << ", T = " << temp << " finished (" << finishedPoints << "/"
+			<< numberPoints << ") after " << stepsPerformed << " steps" << std::endl;
+		if (_config->_simulationType == clusterUpdate)
+		{
+			std::cout << "   mean cluster size: " << clusterSize << ", accepted cluster flips: "
+				<< 100 * clusterAcceptance << " %" << std::endl;
+		}
+		emit send_simulation_info("<font size=5>" + QString::number(finishedPoints) + " / " 
+			+ QString::number(numberPoints) + " points");
+		// check for abortion of simulation
+		if (*_terminateThread == 1)
+		{
+			boolTerminate = TRUE;
+		}
+		_mutex->unlock();
+	}
+
+	if (boolTerminate == TRUE)
+	{
+		return; // abort current simulation by return
+	}
+
+	if (boolFolderOutput)
+	{
+		// output of mean values for T and H in order of temperature and magnetic field loop
+		for (int point = 0; point < numberPoints; ++point)
+		{
+			pointMeanValues[point]->transfer_mean_values(*measurement);
+		}
+		std::string fname = outputFolder;
+		fname.append(simID);
+		fname.append("_MeanValues");
+		_outputWriter->save_text(fname, measurement->mean_steps_text("T[K] B[T] "));
+	}
+
+	// Save information about the lattice used in the simulation to simulation folder
+	save_lattice_information(setup->_lattice.data(), simFolder.absolutePath().toStdString() + "/SYSTEM/", simID,
+		boolFolderOutput);
+
+	// wait for output of all loop points
+	_outputWriter->flush();
 }
 
 void SimulationProgram::spin_seebeck(const std::shared_ptr<Setup> &setup, std::shared_ptr<RanGen> ranGen, 
@@ -518,6 +864,13 @@ void SimulationProgram::spin_seebeck(const std::shared_ptr<Setup> &setup, std::s
 	* @param[in] ranGen Pseudo random number generator.
 	*/
 
+	if (_config->_simulationType == clusterUpdate)
+	{
+		// bond probabilities of clusters are only symmetric for a uniform temperature
+		std::cout << "Cluster updates are not implemented for a temperature gradient." << std::endl;
+		return;
+	}
+
 	// unique simulation identity number
 	std::string simID = "";
 
@@ -556,7 +909,27 @@ void SimulationProgram::spin_seebeck(const std::shared_ptr<Setup> &setup, std::s
 			_config->_simulationSteps, 1, setup->_hamilton, ranGen, _config->_LLG_timeWidth,
 			_config->_LLG_dampingParameter, _config->_magneticMoment, this);
 		break;
+	case energyMinimizer:
+		simulation = std::make_shared<EnergyMinimizer>(setup->_spinOrientation.data(),
+			_config->_simulationSteps, 1, setup->_hamilton, ranGen, _config->_minimizerMemory, this);
+		break;
+	}
+
+	// file format of spin configurations between movie start and movie end
+	simulation->set_spin_file_format(_config->_spinFileFormat, SpinConfigurationFile::lattice_hash(
+		setup->_lattice->get_lattice_coordinate_array(), setup->_lattice->get_number_atoms()));
+	simulation->set_output_writer(_outputWriter.get());
+	simulation->set_target_relative_error(_config->_targetRelativeError);
+	// convergence stop only for deterministic methods; Monte Carlo runs are ended by the target error
+	if (_config->_simulationType == converger1 || _config->_simulationType == landauLifshitzGilbert
+		|| _config->_simulationType == energyMinimizer)
+	{
+		simulation->set_convergence_stop(_config->_convergenceTorque, _config->_convergenceEnergy,
+			_config->_convergenceChecks, _config->_convergenceWidth);
 	}
+
+	// options of Metropolis algorithm
+	configure_metropolis(setup, simulation);
 	
 	// Spin-Seebeck effect is the behavior of magnetic systems with a temperature gradient along the system
 	// minimum temperature of crystal
@@ -577,8 +950,10 @@ void SimulationProgram::spin_seebeck(const std::shared_ptr<Setup> &setup, std::s
 	fname.append(Functions::get_name(magneticField/(_config->_magneticMoment*muBohr)));
 
 	// run simulation
+	open_step_output(measurement, fname + "Measurements");
 	simulation->run_simulation(_config->_uiUpdateWidth, measurement, _config->_outputWidth,
 		_config->_movieStart, _config->_movieEnd, _config->_movieWidth, fname);
+	measurement->close_step_output();
 
 	// output of measurement information as a function of simulation steps
 	if (_config->_doSimulationStepsOutput)
@@ -588,12 +963,19 @@ void SimulationProgram::spin_seebeck(const std::shared_ptr<Setup> &setup, std::s
 		{
 		case metropolis:
 			header.append("MCStep");
-			measurement->save_step_values(fname + "Measurements", header, _config->_outputWidth);
+			_outputWriter->save_text(fname + "Measurements",
+				measurement->step_values_text(header, _config->_outputWidth));
+			break;
+		case converger1:
+		case energyMinimizer:
+			header.append("Step");
+			_outputWriter->save_text(fname + "Measurements",
+				measurement->step_values_text(header, _config->_outputWidth));
 			break;
 		case landauLifshitzGilbert:
 			header.append("t_[ps]");
 			double width = _config->_outputWidth * _config->_LLG_timeWidth;
-			measurement->save_step_values(fname + "Measurements", header, width);
+			_outputWriter->save_text(fname + "Measurements", measurement->step_values_text(header, width));
 			break;
 		}
 	}
@@ -602,6 +984,441 @@ void SimulationProgram::spin_seebeck(const std::shared_ptr<Setup> &setup, std::s
 	save_lattice_information(setup->_lattice.data(), simFolder.absolutePath().toStdString() + "/SYSTEM/", simID, boolFolderOutput);
 }
 
+void SimulationProgram::parallel_tempering(const std::shared_ptr<Setup> &setup, std::shared_ptr<RanGen> ranGen,
+	int boolFolderOutput)
+{
+	/**
+	* Metropolis simulation with one replica of the spin system per temperature of the temperature loop 
+	* (replica exchange). The replicas are simulated in parallel threads, each with its own spin 
+	* configuration, Hamiltonian, Metropolis object and pseudo random number generator. Every 
+	* _replicaExchangeWidth simulation steps the spin configurations of neighboring temperatures are 
+	* exchanged with probability min(1, exp((1/kB*T_i - 1/kB*T_j)*(E_i - E_j))). The replica of the first 
+	* temperature works on the spin configuration of setup, which is shown in the GUI.
+	*
+	* @param[in] setup The information about lattice, spin configuration and Hamiltonian.
+	* @param[in] ranGen Pseudo random number generator for the exchanges.
+	* @param[in] boolFolderOutput TRUE for output into simulation folder.
+	*/
+
+	if (_config->_simulationType != metropolis)
+	{
+		std::cout << "Parallel tempering is only implemented for the Metropolis simulation type." << std::endl;
+		return;
+	}
+
+	//  one replica for each temperature of the temperature loop
+	std::vector<double> temperature = MyMath::linspace(_config->_temperatureStart, _config->_temperatureEnd,
+		_config->_temperatureSteps);
+	for (int k = 0; k < temperature.size(); ++k)
+	{
+		if (temperature[k] < PRECISION)
+		{
+			std::cout << "Parallel tempering requires temperatures larger than zero." << std::endl;
+			return;
+		}
+	}
+	int numberReplicas = temperature.size();
+
+	// Magnetic fields for magnetic field loop
+	std::vector<double> magneticField = MyMath::linspace(_config->_magneticField.start,
+		_config->_magneticField.end, _config->_magneticField.steps);
+
+	// unique simulation identity number
+	std::string simID = "";
+
+	// determine unique identity number and created unique folder for simulation output
+	QDir simFolder = create_unique_simulation_folder(simID, boolFolderOutput);
+	// folder for simulation ouput
+	std::string outputFolder = simFolder.absolutePath().toStdString() + "/SIMULATION/";
+
+	std::string fname = "";
+	std::stringstream stringStream;
+
+	// number of "measurements" done during one step of the magnetic field loop
+	int numMeasurements = _config->_simulationSteps / _config->_outputWidth;
+
+	// sites with common cone width for adaptation of restricted cone
+	std::vector<std::vector<int>> coneGroups;
+	if (_config->_adaptiveConeAcceptance > 0 && _config->_adaptiveConePerClass == TRUE)
+	{
+		coneGroups = setup->create_color_classes();
+	}
+
+	// replicas share the lattice and start from the spin configuration of setup
+	std::vector<std::shared_ptr<Setup>> replicas;
+	std::vector<std::shared_ptr<Metropolis>> simulations;
+	for (int k = 0; k < numberReplicas; ++k)
+	{
+		std::shared_ptr<RanGen> replicaRanGen = create_random_generator(_config->_seed + k + 1);
+		std::shared_ptr<Setup> replica = setup;
+		if (k > 0)
+		{
+			replica = std::make_shared<Setup>(_config);
+			replica->_lattice = setup->_lattice;
+			replica->create_spin_orientation(replicaRanGen);
+			int* inactiveSites = setup->_spinOrientation->get_inactive_sites();
+			for (int i = 0; i < setup->_spinOrientation->get_number_inactive_sites(); ++i)
+			{
+				replica->_spinOrientation->set_inactive_site(inactiveSites[i]);
+			}
+			for (int i = 0; i < setup->_spinOrientation->get_number_atoms(); ++i)
+			{
+				replica->_spinOrientation->set_spin(setup->_spinOrientation->get_spin(i), i);
+			}
+			replica->setup_hamiltonian();
+		}
+		replica->setup_measurement();
+		replica->_measurement->set_number_measurements(numMeasurements);
+		replicas.push_back(replica);
+
+		simulations.push_back(std::make_shared<Metropolis>(replica->_spinOrientation.data(),
+			_config->_simulationSteps, temperature[k], replica->_hamilton, replicaRanGen, this));
+		if (_config->_spinSystem == Heisenberg)
+		{
+			simulations.back()->set_kernels(_config->_heatBathFraction, _config->_overRelaxationSweeps);
+		}
+		if (_config->_adaptiveConeAcceptance > 0)
+		{
+			simulations.back()->set_adaptive_cone(_config->_adaptiveConeAcceptance, _config->_adaptiveConeSteps,
+				coneGroups);
+		}
+	}
+
+	int exchangeWidth = std::max(_config->_replicaExchangeWidth, 1);
+	// exchange statistics for each pair of neighboring temperatures
+	std::vector<int> exchangeAttempts(numberReplicas, 0);
+	std::vector<int> exchangeAccepted(numberReplicas, 0);
+
+	for (std::vector<double>::iterator fieldPtr = magneticField.begin(); fieldPtr != magneticField.end();
+		++fieldPtr)
+	{
+		std::cout << std::endl << "external magnetic field: " << *fieldPtr << std::endl;
+
+		for (int k = 0; k < numberReplicas; ++k)
+		{
+			replicas[k]->set_magnetic_field(*fieldPtr);
+			replicas[k]->_hamilton->update_spin_configuration();
+		}
+		std::fill(exchangeAttempts.begin(), exchangeAttempts.end(), 0);
+		std::fill(exchangeAccepted.begin(), exchangeAccepted.end(), 0);
+
+		// send information about magnetic field and temperatures to GUI thread
+		emit send_simulation_info("<font size=5><i>B</i> = " + QString::number((*fieldPtr) /
+			(_config->_magneticMoment*muBohr)) + "T    <i>T</i> = " + QString::number(temperature.front())
+			+ "K ... " + QString::number(temperature.back()) + "K");
+
+		// basis file name for output during this step of the magnetic field loop
+		std::string fieldFname = outputFolder;
+		fieldFname.append(simID);
+		fieldFname.append("_B_");
+		fieldFname.append(Functions::get_name((*fieldPtr) / (_config->_magneticMoment*muBohr)));
+		for (int k = 0; k < numberReplicas; ++k)
+		{
+			open_step_output(replicas[k]->_measurement,
+				fieldFname + "_T_" + Functions::get_name(temperature[k]) + "_observables");
+		}
+
+		int exchangeParity = 0;
+		for (int step = 0; step < _config->_simulationSteps; step += exchangeWidth)
+		{
+			int lastStep = std::min(step + exchangeWidth, _config->_simulationSteps);
+
+			#pragma omp parallel for schedule(dynamic, 1)
+			for (int k = 0; k < numberReplicas; ++k)
+			{
+				// equilibration (e.g. adaptation of cone width) in addition to the measured steps
+				while (simulations[k]->equilibrating() == TRUE)
+				{
+					if (k == 0)
+					{
+						_mutex->lock();
+						simulations[k]->simulation_step();
+						_mutex->unlock();
+					}
+					else
+					{
+						simulations[k]->simulation_step();
+					}
+				}
+				for (int i = step + 1; i < lastStep + 1; ++i)
+				{
+					// replica 0 is shown in GUI
+					if (k == 0)
+					{
+						_mutex->lock();
+						simulations[k]->simulation_step();
+						_mutex->unlock();
+					}
+					else
+					{
+						simulations[k]->simulation_step();
+					}
+					if ((i % _config->_outputWidth) == 0)
+					{
+						replicas[k]->_measurement->measure();
+					}
+				}
+			}
+
+			// exchange of spin configurations between neighboring temperatures, alternately starting with 
+			// the first and the second temperature
+			_mutex->lock();
+			std::vector<double> energies(numberReplicas);
+			for (int k = 0; k < numberReplicas; ++k)
+			{
+				energies[k] = replicas[k]->_hamilton->total_energy();
+			}
+			for (int k = exchangeParity; k < numberReplicas - 1; k += 2)
+			{
+				double delta = (1. / (kB*temperature[k]) - 1. / (kB*temperature[k + 1]))
+					* (energies[k] - energies[k + 1]);
+				++exchangeAttempts[k];
+				if (delta >= 0 || ranGen->Random() < exp(delta))
+				{
+					++exchangeAccepted[k];
+					Threedim* spinArray = replicas[k]->_spinOrientation->get_spin_array();
+					std::swap_ranges(spinArray, spinArray + replicas[k]->_spinOrientation->get_number_atoms(),
+						replicas[k + 1]->_spinOrientation->get_spin_array());
+					replicas[k]->_hamilton->update_spin_configuration();
+					replicas[k + 1]->_hamilton->update_spin_configuration();
+				}
+			}
+			_mutex->unlock();
+			exchangeParity = 1 - exchangeParity;
+
+			if ((lastStep / _config->_uiUpdateWidth) != (step / _config->_uiUpdateWidth))
+			{
+				emit send_simulation_step("Step = " + QString::number(lastStep));
+				emit send_repaint_request();
+			}
+
+			// check for abortion of simulation
+			_mutex->lock();
+			if (*_terminateThread == 1)
+			{
+				_mutex->unlock();
+				return; // abort current simulation by return
+			}
+			_mutex->unlock();
+		}
+
+		for (int k = 0; k < numberReplicas; ++k)
+		{
+			replicas[k]->_measurement->close_step_output();
+			fname = fieldFname + "_T_" + Functions::get_name(temperature[k]);
+
+			// output of measurement information as a function of simulation steps
+			if (_config->_doSimulationStepsOutput)
+			{
+				_outputWriter->save_text(fname + "_observables",
+					replicas[k]->_measurement->step_values_text("MCStep", _config->_outputWidth));
+			}
+
+			// average mean values of observables over simulation steps; all temperatures are collected in
+			// measurement of first replica
+			stringStream.str("");
+			stringStream.clear();
+			stringStream << temperature[k] << " " << (*fieldPtr) / (_config->_magneticMoment*muBohr);
+			replicas[k]->_measurement->take_mean_values(stringStream.str(), temperature[k]);
+			if (k > 0)
+			{
+				replicas[k]->_measurement->transfer_mean_values(*(replicas[0]->_measurement));
+			}
+
+			// output of spin configuration at end of loop step
+			if (_config->_doSpinConfigOutput)
+			{
+				save_spin_configuration(replicas[k]->_spinOrientation.data(), setup->_lattice.data(),
+					fname + "SpinConfigurationAtEnd");
+			}
+			replicas[k]->_measurement->reset_observables_measurement_index();
+		}
+
+		// exchange statistics
+		std::cout << "replica exchange acceptance rates:";
+		for (int k = 0; k < numberReplicas - 1; ++k)
+		{
+			std::cout << " " << ((exchangeAttempts[k] > 0) ? (double)exchangeAccepted[k] / exchangeAttempts[k] : 0);
+		}
+		std::cout << std::endl;
+		if (boolFolderOutput)
+		{
+			std::fstream filestr;
+			filestr.open(fieldFname + "_ReplicaExchange", std::fstream::out);
+			filestr << "T_1[K] T_2[K] attempts accepted acceptance_rate" << std::endl;
+			for (int k = 0; k < numberReplicas - 1; ++k)
+			{
+				filestr << temperature[k] << " " << temperature[k + 1] << " " << exchangeAttempts[k] << " "
+					<< exchangeAccepted[k] << " " 
+					<< ((exchangeAttempts[k] > 0) ? (double)exchangeAccepted[k] / exchangeAttempts[k] : 0)
+					<< std::endl;
+			}
+			filestr.close();
+		}
+	}
+
+	if (boolFolderOutput)
+	{
+		// output of mean values for T and H
+		fname = outputFolder;
+		fname.append(simID);
+		fname.append("_MeanValues");
+		_outputWriter->save_text(fname, replicas[0]->_measurement->mean_steps_text("T[K] B[T] "));
+	}
+
+	// Save information about the lattice used in the simulation to simulation folder
+	save_lattice_information(setup->_lattice.data(), simFolder.absolutePath().toStdString() + "/SYSTEM/", simID,
+		boolFolderOutput);
+}
+
+void SimulationProgram::geodesic_nudged_elastic_band(const std::shared_ptr<Setup> &setup,
+	std::shared_ptr<RanGen> ranGen)
+{
+	/**
+	* Minimum energy path between the spin configurations _config->_gnebInitialFname and
+	* _config->_gnebFinalFname at the magnetic field _config->_magneticField.start (see
+	* GeodesicNudgedElasticBand). The images are evaluated in _config->_gnebThreads threads, each with its
+	* own Hamiltonian. At most _config->_simulationSteps iterations are performed. The iteration ends when the
+	* maximum force is below the torque tolerance of the convergence stop. The climbing image is switched on
+	* after half of the iterations or when the maximum force is below GNEB_CLIMBING_FACTOR times the tolerance.
+	* Without convergence stop (tolerance 0) all _config->_simulationSteps iterations are performed.
+	* The image of highest energy is shown in the GUI. Output: energies along the path, chain of images and
+	* saddle configuration (binary files, see SpinConfigurationFile).
+	*
+	* @param[in] setup The information about lattice, spin configuration and Hamiltonian.
+	* @param[in] ranGen Pseudo random number generator.
+	*/
+
+	int numberAtoms = setup->_lattice->get_number_atoms();
+	uint64_t latticeHash = SpinConfigurationFile::lattice_hash(setup->_lattice->get_lattice_coordinate_array(),
+		numberAtoms);
+
+	// end points of path; the initial configuration is read last and remains in setup
+	std::vector<Threedim> endPoints[2];
+	std::string endPointFnames[2] = { _config->_gnebInitialFname, _config->_gnebFinalFname };
+	for (int j = 1; j >= 0; --j)
+	{
+		if (spin_file_number_atoms(endPointFnames[j], setup->_lattice.data()) != numberAtoms)
+		{
+			std::cout << "The spin file " << endPointFnames[j] << " does not fit to the lattice." << std::endl;
+			return;
+		}
+		_mutex->lock();
+		setup->_spinOrientation->read_spin_configuration(endPointFnames[j]);
+		_mutex->unlock();
+		Threedim* spinArray = setup->_spinOrientation->get_spin_array();
+		endPoints[j].assign(spinArray, spinArray + numberAtoms);
+	}
+
+	// one Hamiltonian per thread; the Hamiltonian of setup is used by the GUI
+	double magneticField = _config->_magneticField.start;
+	int numberThreads = std::max(std::min(_config->_gnebThreads, _config->_gnebImages - 2), 1);
+	std::vector<std::shared_ptr<Setup>> workers;
+	std::vector<QSharedPointer<Hamiltonian>> hamiltonians;
+	for (int w = 0; w < numberThreads; ++w)
+	{
+		auto worker = std::make_shared<Setup>(_config);
+		worker->_lattice = setup->_lattice;
+		worker->create_spin_orientation(ranGen);
+		int* inactiveSites = setup->_spinOrientation->get_inactive_sites();
+		for (int i = 0; i < setup->_spinOrientation->get_number_inactive_sites(); ++i)
+		{
+			worker->_spinOrientation->set_inactive_site(inactiveSites[i]);
+		}
+		worker->setup_hamiltonian();
+		worker->set_magnetic_field(magneticField);
+		workers.push_back(worker);
+		hamiltonians.push_back(worker->_hamilton);
+	}
+
+	GeodesicNudgedElasticBand band(hamiltonians, numberAtoms, setup->_spinOrientation->get_active_sites(),
+		setup->_spinOrientation->get_number_active_sites(), endPoints[0].data(), endPoints[1].data(),
+		_config->_gnebImages, _config->_gnebSpringConstant, _config->_gnebTimeStep);
+
+	double tolerance = _config->_convergenceTorque;
+	int boolClimbingImage = FALSE;
+	double maxForce = HUGE_VAL; // no force before the first iteration
+	int step = 1;
+	for (; step <= _config->_simulationSteps; ++step)
+	{
+		if (_config->_gnebClimbingImage == TRUE && (2 * step > _config->_simulationSteps
+			|| maxForce < GNEB_CLIMBING_FACTOR * tolerance))
+		{
+			boolClimbingImage = TRUE;
+		}
+		maxForce = band.iterate(boolClimbingImage);
+		if (maxForce < tolerance && (boolClimbingImage == TRUE || _config->_gnebClimbingImage == FALSE))
+		{
+			break;
+		}
+
+		if ((step % _config->_uiUpdateWidth) == 0)
+		{
+			_mutex->lock();
+			const Threedim* saddle = band.get_image(band.get_saddle_image());
+			std::copy(saddle, saddle + numberAtoms, setup->_spinOrientation->get_spin_array());
+			if (*_terminateThread == 1)
+			{
+				_mutex->unlock();
+				return; // abort current simulation by return
+			}
+			_mutex->unlock();
+			emit send_simulation_step("Step = " + QString::number(step));
+			emit send_simulation_convergence_criterion("conv. = " + QString::number(maxForce));
+			emit send_simulation_info("<font size=5>barrier = " + QString::number(band.get_barrier()) + " meV");
+			emit send_repaint_request();
+		}
+	}
+
+	// saddle configuration is shown in GUI
+	int saddleImage = band.get_saddle_image();
+	_mutex->lock();
+	std::copy(band.get_image(saddleImage), band.get_image(saddleImage) + numberAtoms,
+		setup->_spinOrientation->get_spin_array());
+	setup->_hamilton->update_spin_configuration();
+	_mutex->unlock();
+	emit send_repaint_request();
+
+	std::cout << "GNEB: " << std::min(step, _config->_simulationSteps) << " iterations, maximum force "
+		<< maxForce << " meV, barrier " << band.get_barrier() << " meV at image " << saddleImage << std::endl;
+	emit send_simulation_info("<font size=5>barrier = " + QString::number(band.get_barrier()) + " meV");
+
+	// unique simulation identity number
+	std::string simID = "";
+	QDir simFolder = create_unique_simulation_folder(simID);
+	std::string fname = simFolder.absolutePath().toStdString() + "/SIMULATION/";
+	fname.append(simID);
+	fname.append("_B_");
+	fname.append(Functions::get_name(magneticField / (_config->_magneticMoment*muBohr)));
+
+	// energies along minimum energy path
+	std::stringstream stream;
+	stream << "# barrier[meV] " << band.get_barrier() << " saddle_image " << saddleImage << "\n";
+	stream << "image reaction_coordinate E[meV] E-E_initial[meV]\n";
+	for (int k = 0; k < band.get_number_images(); ++k)
+	{
+		stream << k << " " << band.get_reaction_coordinate(k) << " " << band.get_energy(k) << " "
+			<< band.get_energy(k) - band.get_energy(0) << "\n";
+	}
+	_outputWriter->save_text(fname + "_GNEBPath", stream.str());
+
+	// saddle configuration and all images as frames of one file
+	int precision = (_config->_spinFileFormat == spinFileFloat32) ? 4 : 8;
+	int* activityList = setup->_spinOrientation->get_activity_list();
+	_outputWriter->save_spin_configuration(fname + "_GNEBSaddle", activityList, band.get_image(saddleImage),
+		numberAtoms, latticeHash, precision);
+	auto chainFile = std::make_shared<SpinConfigurationFile>();
+	chainFile->create(fname + "_GNEBChain", numberAtoms, activityList, latticeHash, precision);
+	for (int k = 0; k < band.get_number_images(); ++k)
+	{
+		_outputWriter->append_frame(chainFile, band.get_image(k), numberAtoms, k);
+	}
+	delete[] activityList;
+
+	// Save information about the lattice used in the simulation to simulation folder
+	save_lattice_information(setup->_lattice.data(), simFolder.absolutePath().toStdString() + "/SYSTEM/", simID);
+}
+
 void SimulationProgram::tip_movement(const std::shared_ptr<Setup> &setup, std::shared_ptr<RanGen> ranGen)
 {
 	/**
@@ -653,8 +1470,33 @@ void SimulationProgram::tip_movement(const std::shared_ptr<Setup> &setup, std::s
 			_config->_simulationSteps, temperature, setup->_hamilton, ranGen, _config->_LLG_timeWidth,
 			_config->_LLG_dampingParameter, _config->_magneticMoment, this);
 		break;
+	case energyMinimizer:
+		simulation = std::make_shared<EnergyMinimizer>(setup->_spinOrientation.data(),
+			_config->_simulationSteps, temperature, setup->_hamilton, ranGen, _config->_minimizerMemory, this);
+		break;
+	case clusterUpdate:
+		simulation = std::make_shared<ClusterUpdate>(setup->_spinOrientation.data(),
+			_config->_simulationSteps, temperature, setup->_hamilton, ranGen, _config->_clusterMetropolisSweeps,
+			this);
+		break;
 	}
 
+	// file format of spin configurations between movie start and movie end
+	simulation->set_spin_file_format(_config->_spinFileFormat, SpinConfigurationFile::lattice_hash(
+		setup->_lattice->get_lattice_coordinate_array(), setup->_lattice->get_number_atoms()));
+	simulation->set_output_writer(_outputWriter.get());
+	simulation->set_target_relative_error(_config->_targetRelativeError);
+	// convergence stop only for deterministic methods; Monte Carlo runs are ended by the target error
+	if (_config->_simulationType == converger1 || _config->_simulationType == landauLifshitzGilbert
+		|| _config->_simulationType == energyMinimizer)
+	{
+		simulation->set_convergence_stop(_config->_convergenceTorque, _config->_convergenceEnergy,
+			_config->_convergenceChecks, _config->_convergenceWidth);
+	}
+
+	// options of Metropolis algorithm
+	configure_metropolis(setup, simulation);
+
 	setup->set_tip_strength(_config->_magneticTip.energyParameter);
 	setup->set_tip_direction(_config->_magneticTip.magnetizationDirection);
 
@@ -692,9 +1534,7 @@ void SimulationProgram::tip_movement(const std::shared_ptr<Setup> &setup, std::s
 			stringStream.clear();
 			stringStream << i;
 			fname.append(stringStream.str());
-			Functions::save(setup->_spinOrientation->get_activity_list(), 
-				setup->_spinOrientation->get_spin_array(),
-				setup->_spinOrientation->get_number_atoms(), fname);
+			save_spin_configuration(setup->_spinOrientation.data(), setup->_lattice.data(), fname);
 
 			// save spin configuration as png image from GUI widget
 			emit send_repaint_request();
@@ -709,7 +1549,7 @@ void SimulationProgram::tip_movement(const std::shared_ptr<Setup> &setup, std::s
 	fname = outputFolder;
 	fname.append(simID);
 	fname.append("_MeanValues_TipMovement");
-	measurement->save_mean_steps(fname, "TipMovementStep");
+	_outputWriter->save_text(fname, measurement->mean_steps_text("TipMovementStep"));
 
 	save_lattice_information(setup->_lattice.data(), simFolder.absolutePath().toStdString() + "/SYSTEM/", simID);
 }
@@ -774,8 +1614,33 @@ void SimulationProgram::experiment01(const std::shared_ptr<Setup>& setup, std::s
 			_config->_simulationSteps, 1, setup->_hamilton, ranGen, _config->_LLG_timeWidth,
 			_config->_LLG_dampingParameter, _config->_magneticMoment, this);
 		break;
+	case energyMinimizer:
+		simulation = std::make_shared<EnergyMinimizer>(setup->_spinOrientation.data(),
+			_config->_simulationSteps, 1, setup->_hamilton, ranGen, _config->_minimizerMemory, this);
+		break;
+	case clusterUpdate:
+		// Note that temperature is arbitrarily set to 1 since temperature gradient is set for simulation
+		simulation = std::make_shared<ClusterUpdate>(setup->_spinOrientation.data(),
+			_config->_simulationSteps, 1, setup->_hamilton, ranGen, _config->_clusterMetropolisSweeps, this);
+		break;
+	}
+
+	// file format of spin configurations between movie start and movie end
+	simulation->set_spin_file_format(_config->_spinFileFormat, SpinConfigurationFile::lattice_hash(
+		setup->_lattice->get_lattice_coordinate_array(), setup->_lattice->get_number_atoms()));
+	simulation->set_output_writer(_outputWriter.get());
+	simulation->set_target_relative_error(_config->_targetRelativeError);
+	// convergence stop only for deterministic methods; Monte Carlo runs are ended by the target error
+	if (_config->_simulationType == converger1 || _config->_simulationType == landauLifshitzGilbert
+		|| _config->_simulationType == energyMinimizer)
+	{
+		simulation->set_convergence_stop(_config->_convergenceTorque, _config->_convergenceEnergy,
+			_config->_convergenceChecks, _config->_convergenceWidth);
 	}
 
+	// options of Metropolis algorithm
+	configure_metropolis(setup, simulation);
+
 	// temperature of spin system
 	double temperature = _config->_temperatureStart;
 	simulation->set_temperature(temperature);
@@ -848,18 +1713,19 @@ void SimulationProgram::experiment01(const std::shared_ptr<Setup>& setup, std::s
 	save_lattice_information(setup->_lattice.data(), simFolder.absolutePath().toStdString() + "/SYSTEM/", simID, boolFolderOutput);
 }
 
-void SimulationProgram::eigen_frequency(const std::shared_ptr<Setup>& setup, std::string fname)
+void SimulationProgram::eigen_frequency(const std::shared_ptr<Setup>& setup, 
+	const std::shared_ptr<ExcitationModeSolver> &excitationModeSolver, std::string fname)
 {
 	/**
 	* Calculation of eigenmodes for current spin and lattice system configuration. The sparse matrix,
 	* the eigenvalues and eigenvectors are stored in text files.
 	*
 	* @param[in] setup Information about the spin system, lattice system and Hamiltonian
+	* @param[in] excitationModeSolver Solver for the spin system of setup. Used for all steps of a loop, so
+	*            that the symbolic factorization and the previous eigenvectors are reused.
 	* @param[in] fname Base name for output files.
 	*/
 
-	std::shared_ptr<ExcitationModeSolver> excitationModeSolver = std::make_shared<ExcitationModeSolver>
-		(setup->_spinOrientation.data(), setup->_hamilton);
 	excitationModeSolver->setup_matrix();
 
 	excitationModeSolver->save_sparse_matrix(fname + "sparseMatrix");
@@ -874,6 +1740,152 @@ void SimulationProgram::eigen_frequency(const std::shared_ptr<Setup>& setup, std
 }
 
 
+void SimulationProgram::configure_metropolis(const std::shared_ptr<Setup> &setup,
+	const std::shared_ptr<SimulationMethod> &simulation)
+{
+	/**
+	* Parallel sweep over classes of non-interacting sites, heat-bath and over-relaxation updates (Heisenberg
+	* spins only) and adaptation of the restricted cone width as specified in _config. The classes of
+	* non-interacting sites are created once for parallel sweep and cone width per class. Does nothing for
+	* other simulation types.
+	*
+	* @param[in] setup The information about lattice, spin configuration and Hamiltonian.
+	* @param[in] simulation Simulation object of type _config->_simulationType
+	*/
+
+	if (_config->_simulationType != metropolis)
+	{
+		return;
+	}
+	auto metropolisMethod = std::static_pointer_cast<Metropolis>(simulation);
+
+	std::vector<std::vector<int>> colorClasses;
+	if (_config->_parallelSweepThreads > 0
+		|| (_config->_adaptiveConeAcceptance > 0 && _config->_adaptiveConePerClass == TRUE))
+	{
+		colorClasses = setup->create_color_classes();
+	}
+
+	// update classes of non-interacting sites in parallel
+	if (_config->_parallelSweepThreads > 0 && !colorClasses.empty())
+	{
+		metropolisMethod->set_parallel_sweep(colorClasses, _config->_parallelSweepThreads);
+	}
+
+	// heat-bath and over-relaxation updates (Heisenberg spins only)
+	if (_config->_spinSystem == Heisenberg)
+	{
+		metropolisMethod->set_kernels(_config->_heatBathFraction, _config->_overRelaxationSweeps);
+	}
+
+	// width of restricted cone adapted during equilibration
+	if (_config->_adaptiveConeAcceptance > 0)
+	{
+		metropolisMethod->set_adaptive_cone(_config->_adaptiveConeAcceptance, _config->_adaptiveConeSteps,
+			(_config->_adaptiveConePerClass == TRUE) ? colorClasses : std::vector<std::vector<int>>());
+	}
+}
+
+void SimulationProgram::open_step_output(const std::shared_ptr<Measurement> &measurement, std::string fname)
+{
+	/**
+	* In accumulator mode the measurement values as a function of the simulation step are written during the 
+	* run instead of being saved afterwards. Does nothing otherwise.
+	*
+	* @param[in] measurement Measurement of the run
+	* @param[in] fname File name
+	*/
+
+	if (!_config->_doSimulationStepsOutput || measurement->get_accumulate() == FALSE)
+	{
+		return;
+	}
+	switch (_config->_simulationType)
+	{
+	case metropolis:
+	case clusterUpdate:
+		measurement->open_step_output(fname, "MCStep", _config->_outputWidth);
+		break;
+	case converger1:
+	case energyMinimizer:
+		measurement->open_step_output(fname, "Step", _config->_outputWidth);
+		break;
+	case landauLifshitzGilbert:
+		measurement->open_step_output(fname, "t_[ps]", _config->_outputWidth * _config->_LLG_timeWidth);
+		break;
+	}
+}
+
+std::shared_ptr<RanGen> SimulationProgram::create_random_generator(int seed) const
+{
+	/**
+	* @param[in] seed Seed of generator
+	*
+	* @return Mersenne twister or counter-based Philox generator (stream 0)
+	*/
+
+	if (_config->_randomGenerator == philoxGenerator)
+	{
+		return std::make_shared<PhiloxRanGen>(seed);
+	}
+	return std::make_shared<Mersenne>(seed);
+}
+
+int SimulationProgram::spin_file_number_atoms(std::string fname, Lattice* lattice)
+{
+	/**
+	* A warning is printed if a binary file was saved for a different lattice.
+	*
+	* @param[in] fname Text or binary spin configuration file
+	* @param[in] lattice Lattice the spin configuration is read for
+	*
+	* @return Number of lattice sites in file
+	*/
+
+	if (SpinConfigurationFile::is_spin_configuration_file(fname) == TRUE)
+	{
+		SpinConfigurationFile spinFile;
+		spinFile.open(fname);
+		if (spinFile.get_lattice_hash() != 0 && spinFile.get_lattice_hash() != SpinConfigurationFile::lattice_hash(
+			lattice->get_lattice_coordinate_array(), lattice->get_number_atoms()))
+		{
+			std::cout << "Spin configuration was saved for a different lattice." << std::endl;
+		}
+		return spinFile.get_number_atoms();
+	}
+	return Functions::get_num_lines(fname);
+}
+
+void SimulationProgram::save_spin_configuration(SpinOrientation* spinOrientation, Lattice* lattice,
+	std::string fname)
+{
+	/**
+	* Saves spin configuration as text file or as binary file (see SpinConfigurationFile) according to
+	* _config->_spinFileFormat. The file is written by the output writer thread.
+	*
+	* @param[in] spinOrientation Spin configuration
+	* @param[in] lattice Lattice of spin configuration
+	* @param[in] fname File name
+	*/
+
+	int* activityList = spinOrientation->get_activity_list();
+	switch (_config->_spinFileFormat)
+	{
+	case spinFileText:
+		_outputWriter->save_spin_configuration(fname, activityList, spinOrientation->get_spin_array(),
+			spinOrientation->get_number_atoms());
+		break;
+	case spinFileFloat32:
+	case spinFileFloat64:
+		_outputWriter->save_spin_configuration(fname, activityList, spinOrientation->get_spin_array(),
+			spinOrientation->get_number_atoms(), SpinConfigurationFile::lattice_hash(
+			lattice->get_lattice_coordinate_array(), lattice->get_number_atoms()),
+			(_config->_spinFileFormat == spinFileFloat32) ? 4 : 8);
+		break;
+	}
+	delete[] activityList;
+}
+
 QDir SimulationProgram::create_unique_simulation_folder(std::string &simID, int boolFolderOutput)
 {
 	/**
@@ -920,6 +1932,7 @@ QDir SimulationProgram::create_unique_simulation_folder(std::string &simID, int
 	sim_info.open(QIODevice::WriteOnly | QIODevice::Text);
 	sim_info.write(_config->all_parameters().c_str());
 	sim_info.close();
+	_config->copy_configuration_file(system_dir.absoluteFilePath("Configuration").toStdString());
 
 	// create subfolder SIMULATION for ouput during simulation
 	QDir simulation_dir = sim_folder;
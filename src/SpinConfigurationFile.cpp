@@ -0,0 +1,442 @@
+/*
+* SpinConfigurationFile.cpp
+*
+* Copyright 2017 Julian Hagemeister
+*
+* This file is part of MonteCrystal.
+*
+* MonteCrystal is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* MonteCrystal is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with MonteCrystal.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include "SpinConfigurationFile.h"
+
+// forward and further includes
+#include "Functions.h"
+
+#include <QFile>
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+// version of file format written by this class
+#define SPIN_FILE_VERSION 1
+
+SpinConfigurationFile::SpinConfigurationFile():
+	_map(NULL), _mapSize(0)
+{
+	std::memset(&_header, 0, sizeof(SpinFileHeader));
+}
+
+SpinConfigurationFile::~SpinConfigurationFile()
+{
+	close();
+}
+
+int SpinConfigurationFile::create(std::string fname, int numberAtoms, const int* activityList,
+	uint64_t latticeHash, int precision)
+{
+	/**
+	* Creates a new file without frames. Frames are added with append_frame().
+	*
+	* @param[in] fname Name of file
+	* @param[in] numberAtoms Number of lattice sites
+	* @param[in] activityList Activity of each lattice site (1 active, 0 inactive); NULL for all active
+	* @param[in] latticeHash Hash of lattice (see lattice_hash()); 0 if unknown
+	* @param[in] precision Bytes per spin component: 4 or 8
+	*
+	* @return TRUE if file was created, FALSE otherwise
+	*/
+
+	close();
+
+	std::memset(&_header, 0, sizeof(SpinFileHeader));
+	std::memcpy(_header.magic, "MCSPIN", 6);
+	_header.version = SPIN_FILE_VERSION;
+	_header.precision = (precision == 4) ? 4 : 8;
+	_header.numberAtoms = numberAtoms;
+	_header.latticeHash = latticeHash;
+	// frames start and have a size of multiples of 8 bytes for aligned access to mapped data
+	_header.dataOffset = sizeof(SpinFileHeader) + ((numberAtoms + 7) / 8) * 8;
+	_header.frameSize = ((sizeof(int64_t) + 3 * _header.precision * numberAtoms + 7) / 8) * 8;
+
+	_output.open(fname, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!_output.is_open())
+	{
+		std::cout << "Spin configuration file " << fname << " could not be created." << std::endl;
+		return FALSE;
+	}
+	_output.write((const char*)&_header, sizeof(SpinFileHeader));
+
+	std::vector<char> activity(_header.dataOffset - sizeof(SpinFileHeader), 0);
+	for (int i = 0; i < numberAtoms; ++i)
+	{
+		activity[i] = (activityList == NULL) ? 1 : (char)(activityList[i] != 0);
+	}
+	_output.write(activity.data(), activity.size());
+	_frameBuffer.assign(_header.frameSize, 0);
+	return TRUE;
+}
+
+int SpinConfigurationFile::append(std::string fname)
+{
+	/**
+	* Opens an existing file to append further frames. An incomplete last frame is overwritten.
+	*
+	* @param[in] fname Name of file
+	*
+	* @return TRUE if file was opened, FALSE otherwise
+	*/
+
+	close();
+
+	std::ifstream input(fname, std::ios::in | std::ios::binary);
+	if (read_header(input, _header) == FALSE)
+	{
+		std::cout << fname << " is no binary spin configuration file." << std::endl;
+		return FALSE;
+	}
+	input.seekg(0, std::ios::end);
+	uint64_t fileSize = input.tellg();
+	input.close();
+	uint64_t numberFrames = (fileSize - _header.dataOffset) / _header.frameSize;
+
+	_output.open(fname, std::ios::in | std::ios::out | std::ios::binary);
+	_output.seekp(_header.dataOffset + numberFrames * _header.frameSize);
+	_frameBuffer.assign(_header.frameSize, 0);
+	return TRUE;
+}
+
+int SpinConfigurationFile::append_frame(const Threedim* spinArray, int64_t label)
+{
+	/**
+	* @param[in] spinArray Spin configuration with as many spins as specified in header
+	* @param[in] label Label of frame, e.g. simulation step
+	*
+	* @return TRUE if frame was written, FALSE otherwise
+	*/
+
+	if (!_output.is_open())
+	{
+		return FALSE;
+	}
+
+	std::memcpy(_frameBuffer.data(), &label, sizeof(int64_t));
+	int numberAtoms = _header.numberAtoms;
+	if (_header.precision == 4)
+	{
+		float* data = (float*)(_frameBuffer.data() + sizeof(int64_t));
+		for (int i = 0; i < numberAtoms; ++i)
+		{
+			data[3 * i] = (float)spinArray[i].x;
+			data[3 * i + 1] = (float)spinArray[i].y;
+			data[3 * i + 2] = (float)spinArray[i].z;
+		}
+	}
+	else
+	{
+		std::memcpy(_frameBuffer.data() + sizeof(int64_t), spinArray, 3 * sizeof(double) * numberAtoms);
+	}
+	_output.write(_frameBuffer.data(), _frameBuffer.size());
+	_output.flush();
+	return _output.good() ? TRUE : FALSE;
+}
+
+void SpinConfigurationFile::close(void)
+{
+	if (_output.is_open())
+	{
+		_output.close();
+	}
+	if (_mappedFile)
+	{
+		if (_map != NULL)
+		{
+			_mappedFile->unmap((uchar*)_map);
+		}
+		_mappedFile->close();
+		_mappedFile.reset();
+	}
+	_map = NULL;
+	_mapSize = 0;
+}
+
+int SpinConfigurationFile::open(std::string fname)
+{
+	/**
+	* Maps an existing file into memory for reading.
+	*
+	* @param[in] fname Name of file
+	*
+	* @return TRUE if file was opened, FALSE otherwise
+	*/
+
+	close();
+
+	std::ifstream input(fname, std::ios::in | std::ios::binary);
+	if (read_header(input, _header) == FALSE)
+	{
+		std::cout << fname << " is no binary spin configuration file." << std::endl;
+		return FALSE;
+	}
+	input.close();
+
+	_mappedFile.reset(new QFile(QString::fromStdString(fname)));
+	if (!_mappedFile->open(QIODevice::ReadOnly))
+	{
+		_mappedFile.reset();
+		return FALSE;
+	}
+	_mapSize = _mappedFile->size();
+	_map = _mappedFile->map(0, _mapSize);
+	if (_map == NULL)
+	{
+		std::cout << fname << " could not be mapped into memory." << std::endl;
+		close();
+		return FALSE;
+	}
+	return TRUE;
+}
+
+int SpinConfigurationFile::get_number_atoms(void) const
+{
+	return _header.numberAtoms;
+}
+
+int SpinConfigurationFile::get_number_frames(void) const
+{
+	if (_map == NULL || _mapSize < (int64_t)_header.dataOffset)
+	{
+		return 0;
+	}
+	return (_mapSize - _header.dataOffset) / _header.frameSize;
+}
+
+int SpinConfigurationFile::get_precision(void) const
+{
+	return _header.precision;
+}
+
+uint64_t SpinConfigurationFile::get_lattice_hash(void) const
+{
+	return _header.latticeHash;
+}
+
+int64_t SpinConfigurationFile::get_frame_label(int frame) const
+{
+	int64_t label;
+	std::memcpy(&label, _map + _header.dataOffset + frame * _header.frameSize, sizeof(int64_t));
+	return label;
+}
+
+const void* SpinConfigurationFile::get_frame_data(int frame) const
+{
+	/**
+	* @param[in] frame Index of frame; 0 <= frame < get_number_frames()
+	*
+	* @return Spin components x,y,z of all lattice sites. float if get_precision() is 4, double otherwise.
+	*/
+
+	return _map + _header.dataOffset + frame * _header.frameSize + sizeof(int64_t);
+}
+
+void SpinConfigurationFile::read_frame(int frame, Threedim* spinArray) const
+{
+	/**
+	* @param[in] frame Index of frame; 0 <= frame < get_number_frames()
+	* @param[out] spinArray Spin configuration with get_number_atoms() spins
+	*/
+
+	int numberAtoms = _header.numberAtoms;
+	if (_header.precision == 4)
+	{
+		const float* data = (const float*)get_frame_data(frame);
+		for (int i = 0; i < numberAtoms; ++i)
+		{
+			spinArray[i] = Threedim{ data[3 * i], data[3 * i + 1], data[3 * i + 2] };
+		}
+	}
+	else
+	{
+		std::memcpy(spinArray, get_frame_data(frame), 3 * sizeof(double) * numberAtoms);
+	}
+}
+
+void SpinConfigurationFile::read_activity_list(int* activityList) const
+{
+	/**
+	* @param[out] activityList Activity of each lattice site (1 active, 0 inactive)
+	*/
+
+	const unsigned char* activity = _map + sizeof(SpinFileHeader);
+	for (int i = 0; i < _header.numberAtoms; ++i)
+	{
+		activityList[i] = activity[i];
+	}
+}
+
+int SpinConfigurationFile::save(std::string fname, const int* activityList, const Threedim* spinArray,
+	int numberAtoms, uint64_t latticeHash, int precision)
+{
+	/**
+	* @param[in] fname Name of file
+	* @param[in] activityList Activity of each lattice site (1 active, 0 inactive); NULL for all active
+	* @param[in] spinArray Spin configuration
+	* @param[in] numberAtoms Number of lattice sites
+	* @param[in] latticeHash Hash of lattice (see lattice_hash()); 0 if unknown
+	* @param[in] precision Bytes per spin component: 4 or 8
+	*
+	* @return TRUE if file was written, FALSE otherwise
+	*/
+
+	SpinConfigurationFile file;
+	if (file.create(fname, numberAtoms, activityList, latticeHash, precision) == FALSE)
+	{
+		return FALSE;
+	}
+	return file.append_frame(spinArray, 0);
+}
+
+int SpinConfigurationFile::is_spin_configuration_file(std::string fname)
+{
+	std::ifstream input(fname, std::ios::in | std::ios::binary);
+	SpinFileHeader header;
+	return read_header(input, header);
+}
+
+uint64_t SpinConfigurationFile::lattice_hash(const Threedim* latticeCoordArray, int numberAtoms)
+{
+	/**
+	* FNV-1a hash of lattice coordinates. Coordinates are rounded to 1e-6 so that the hash does not depend on
+	* rounding errors of the lattice creation.
+	*
+	* @param[in] latticeCoordArray Lattice coordinates
+	* @param[in] numberAtoms Number of lattice sites
+	*/
+
+	uint64_t hash = 14695981039346656037ULL;
+	for (int i = 0; i < numberAtoms; ++i)
+	{
+		int64_t coordinates[3] = { llround(latticeCoordArray[i].x * 1e6), llround(latticeCoordArray[i].y * 1e6),
+			llround(latticeCoordArray[i].z * 1e6) };
+		const unsigned char* bytes = (const unsigned char*)coordinates;
+		for (int k = 0; k < sizeof(coordinates); ++k)
+		{
+			hash = (hash ^ bytes[k]) * 1099511628211ULL;
+		}
+	}
+	return hash;
+}
+
+int SpinConfigurationFile::text_to_binary(std::string textFname, std::string binaryFname, int precision)
+{
+	/**
+	* @param[in] textFname Spin configuration as written by Functions::save: activity sx sy sz per line
+	* @param[in] binaryFname Name of binary file
+	* @param[in] precision Bytes per spin component: 4 or 8
+	*
+	* @return TRUE if file was converted, FALSE otherwise
+	*/
+
+	std::ifstream input(textFname);
+	if (!input.is_open())
+	{
+		std::cout << "The spin file does not exist!" << std::endl;
+		return FALSE;
+	}
+
+	std::vector<int> activityList;
+	std::vector<Threedim> spins;
+	// first column only provides activity if it consists of 0 and 1 only
+	int activeInformation = TRUE;
+	std::string line;
+	while (std::getline(input, line))
+	{
+		std::istringstream lineStream(line);
+		std::string first;
+		Threedim spin;
+		if (!(lineStream >> first >> spin.x >> spin.y >> spin.z))
+		{
+			continue;
+		}
+		if (first.compare("0") != 0 && first.compare("1") != 0)
+		{
+			activeInformation = FALSE;
+		}
+		activityList.push_back(first.compare("0") != 0);
+		spins.push_back(spin);
+	}
+	if (activeInformation == FALSE)
+	{
+		std::fill(activityList.begin(), activityList.end(), 1);
+	}
+
+	return save(binaryFname, activityList.data(), spins.data(), spins.size(), 0, precision);
+}
+
+int SpinConfigurationFile::binary_to_text(std::string binaryFname, std::string textFname, int frame)
+{
+	/**
+	* @param[in] binaryFname Name of binary file
+	* @param[in] textFname Name of text file
+	* @param[in] frame Index of frame to convert; -1 for last frame
+	*
+	* @return TRUE if file was converted, FALSE otherwise
+	*/
+
+	SpinConfigurationFile file;
+	if (file.open(binaryFname) == FALSE)
+	{
+		return FALSE;
+	}
+	if (frame < 0)
+	{
+		frame = file.get_number_frames() - 1;
+	}
+	if (frame < 0 || frame >= file.get_number_frames())
+	{
+		std::cout << binaryFname << " does not contain frame " << frame << "." << std::endl;
+		return FALSE;
+	}
+
+	std::vector<int> activityList(file.get_number_atoms());
+	std::vector<Threedim> spins(file.get_number_atoms());
+	file.read_activity_list(activityList.data());
+	file.read_frame(frame, spins.data());
+	Functions::save(activityList.data(), spins.data(), spins.size(), textFname);
+	return TRUE;
+}
+
+int SpinConfigurationFile::read_header(std::istream &stream, SpinFileHeader &header)
+{
+	/**
+	* @param[in] stream Stream at beginning of file
+	* @param[out] header Header of file
+	*
+	* @return TRUE if stream contains a supported binary spin configuration file, FALSE otherwise
+	*/
+
+	if (!stream.read((char*)&header, sizeof(SpinFileHeader)))
+	{
+		return FALSE;
+	}
+	if (std::memcmp(header.magic, "MCSPIN\0\0", 8) != 0 || header.version > SPIN_FILE_VERSION
+		|| (header.precision != 4 && header.precision != 8) || header.frameSize == 0)
+	{
+		return FALSE;
+	}
+	return TRUE;
+}
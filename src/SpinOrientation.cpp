@@ -31,6 +31,7 @@
 #include "Lattice.h"
 #include "RanGen.h"
 #include "Functions.h"
+#include "SpinConfigurationFile.h"
 
 SpinOrientation::SpinOrientation(int numberAtoms, std::shared_ptr<RanGen> ranGen)
 {
@@ -81,11 +82,28 @@ void SpinOrientation::read_spin_configuration(std::string fname)
 	*
 	* Caution: The file to read should have as many lines as atoms.
 	*
+	* Binary files (see SpinConfigurationFile) are recognized automatically. The last frame is read.
+	*
 	* @param[in] fname The name of the file containing the spin configuration to be read in
 	*/
 
-	// assume that there are as many lines as number of atoms
-	_numberAtoms = Functions::get_num_lines(fname);
+	// binary spin configuration file
+	SpinConfigurationFile binaryFile;
+	int boolBinary = SpinConfigurationFile::is_spin_configuration_file(fname);
+	if (boolBinary == TRUE)
+	{
+		if (binaryFile.open(fname) == FALSE || binaryFile.get_number_frames() == 0)
+		{
+			std::cout << "The spin file " << fname << " does not contain a spin configuration." << std::endl;
+			return;
+		}
+		_numberAtoms = binaryFile.get_number_atoms();
+	}
+	else
+	{
+		// assume that there are as many lines as number of atoms
+		_numberAtoms = Functions::get_num_lines(fname);
+	}
 
 	// make room for the new spins
 	delete[] _spinArray;
@@ -98,7 +116,7 @@ void SpinOrientation::read_spin_configuration(std::string fname)
 	int* activeSitesTmp = new int[_numberAtoms];
 	
 	// open file
-	std::ifstream infile(fname);
+	std::ifstream infile;
 	std::string line;
 
 	// temporary helper value for read in
@@ -107,12 +125,26 @@ void SpinOrientation::read_spin_configuration(std::string fname)
 	// keep track of current row index
 	int count = 0;
 
-	if (!infile)
+	if (boolBinary == TRUE)
+	{
+		binaryFile.read_frame(binaryFile.get_number_frames() - 1, _spinArray);
+		binaryFile.read_activity_list(activeSitesTmp);
+		for (int i = 0; i < _numberAtoms; ++i)
+		{
+			_spinArray[i] = MyMath::normalize(_spinArray[i]);
+		}
+	}
+	else
+	{
+		infile.open(fname);
+	}
+	if (boolBinary == FALSE && !infile)
 	{
 		std::cout << "The spin file does not exist!" << std::endl;
+		delete[] activeSitesTmp;
 		return;
 	}
-	while (std::getline(infile, line))
+	while (boolBinary == FALSE && std::getline(infile, line))
 	{
 		std::istringstream isstream(line);
 
@@ -321,6 +353,16 @@ void SpinOrientation::set_spin(Threedim spin, int position)
 	_spinArray[position] = spin;
 }
 
+Threedim SpinOrientation::trial_spin(int position)
+{
+	/**
+	* @param[in] position Index of spin site.
+	*
+	* @return Random trial direction for spin drawn with the random number generator of this object.
+	*/
+	return trial_spin(position, *_ranGen);
+}
+
 Threedim* SpinOrientation::get_spin_array(void) const
 {
 	return _spinArray;
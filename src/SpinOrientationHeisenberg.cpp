@@ -55,7 +55,7 @@ void SpinOrientationHeisenberg::random_orientation(void)
 
 	for (int i = 0; i < _numberAtoms; i++)
 	{
-		_spinArray[i] = generate_random_spin();
+		_spinArray[i] = generate_random_spin(*_ranGen);
 	}
 	set_all_sites_active();
 }
@@ -130,7 +130,7 @@ void SpinOrientationHeisenberg::single_orientation(int position)
 	_spin = _spinArray[position];
 
 	// set new random spin direction
-	_spinArray[position] = generate_random_spin();
+	_spinArray[position] = trial_spin(position, *_ranGen);
 
 }
 
@@ -144,6 +144,21 @@ void SpinOrientationHeisenberg::restore_single_orientation(void)
 	_spinArray[_position] = _spin;
 }
 
+Threedim SpinOrientationHeisenberg::trial_spin(int position, RanGen &ranGen)
+{
+	/**
+	* This method returns a new spin with random direction for lattice site given by position. The spin
+	* configuration is not changed.
+	*
+	* @param[in] position Index of spin site.
+	* @param[in] ranGen Random number generator.
+	*
+	* @return Normalised spin vector with random direction
+	*/
+
+	return generate_random_spin(ranGen);
+}
+
 Threedim SpinOrientationHeisenberg::magnetisation(void) const
 {
 	/**
@@ -160,12 +175,14 @@ Threedim SpinOrientationHeisenberg::magnetisation(void) const
 	return m;
 }
 
-Threedim SpinOrientationHeisenberg::generate_random_spin(void)
+Threedim SpinOrientationHeisenberg::generate_random_spin(RanGen &ranGen)
 {
 	/**
 	* This function generates a spin with a random direction. The
 	* spin vector has length one.
 	*
+	* @param[in] ranGen Random number generator.
+	*
 	* @return Normalised spin vector with random direction
 	*/
 
@@ -173,9 +190,9 @@ Threedim SpinOrientationHeisenberg::generate_random_spin(void)
 	Threedim tmpSpin = { 0,0,0 };
 	while (found == 0)
 	{
-		tmpSpin.x = (2.0 * _ranGen->Random() - 1);
-		tmpSpin.y = (2.0 * _ranGen->Random() - 1);
-		tmpSpin.z = (2.0 * _ranGen->Random() - 1);
+		tmpSpin.x = (2.0 * ranGen.Random() - 1);
+		tmpSpin.y = (2.0 * ranGen.Random() - 1);
+		tmpSpin.z = (2.0 * ranGen.Random() - 1);
 
 		double norm = MyMath::norm(tmpSpin);
 		if (norm < 1)
@@ -26,11 +26,19 @@
 #include "RanGen.h"
 #include "MyMath.h"
 
+#include <algorithm>
+
 SpinOrientationHeisenbergRestrictedCone::SpinOrientationHeisenbergRestrictedCone(int numberAtoms,
 	std::shared_ptr<RanGen> ranGen, double sigma) :
 	SpinOrientationHeisenberg(numberAtoms, ranGen)
 {
-	_sigma = sigma;
+	/**
+	* @param[in] numberAtoms Number of lattice sites
+	* @param[in] ranGen Pseudo random number generator
+	* @param[in] sigma Standard deviation of the Gaussian change of each spin component
+	*/
+
+	_sigma.assign(numberAtoms, sigma);
 }
 
 SpinOrientationHeisenbergRestrictedCone::~SpinOrientationHeisenbergRestrictedCone()
@@ -47,22 +55,45 @@ void SpinOrientationHeisenbergRestrictedCone::single_orientation(int position)
 	_spin = _spinArray[position];
 	_position = position;
 
-	make_random_change_within_cone(position);
+	_spinArray[position] = trial_spin(position, *_ranGen);
 }
 
-void SpinOrientationHeisenbergRestrictedCone::make_random_change_within_cone(int position)
+Threedim SpinOrientationHeisenbergRestrictedCone::trial_spin(int position, RanGen &ranGen)
 {
 	/*
+	* Random change of the spin within a cone around its current direction. The Gaussian change of each spin
+	* component has the standard deviation _sigma of the lattice site. The spin configuration is not changed.
 	* Look at Boris Wolter PhD thesis for further information.
 	*/
 
+	Threedim spin = _spinArray[position];
+
 	double value1 = 0;
 	double value2 = 0;
-	_ranGen->polar(value1, value2);
-	_spinArray[position].x += value1;
-	_spinArray[position].y += value2;
-	_ranGen->polar(value1, value2);
-	_spinArray[position].z += value1;
+	double sigma = _sigma[position];
+	ranGen.polar(value1, value2);
+	spin.x += sigma * value1;
+	spin.y += sigma * value2;
+	ranGen.polar(value1, value2);
+	spin.z += sigma * value1;
+
+	return MyMath::normalize(spin);
+}
 
-	_spinArray[position] = MyMath::normalize(_spinArray[position]);
+void SpinOrientationHeisenbergRestrictedCone::set_sigma(double sigma)
+{
+	std::fill(_sigma.begin(), _sigma.end(), sigma);
+}
+
+void SpinOrientationHeisenbergRestrictedCone::set_sigma(double sigma, const std::vector<int> &sites)
+{
+	for (int i = 0; i < sites.size(); ++i)
+	{
+		_sigma[sites[i]] = sigma;
+	}
+}
+
+double SpinOrientationHeisenbergRestrictedCone::get_sigma(int position) const
+{
+	return _sigma[position];
 }
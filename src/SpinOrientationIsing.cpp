@@ -115,6 +115,21 @@ void SpinOrientationIsing::restore_single_orientation(void)
 	_spinArray[_position].x = -_spinArray[_position].x;
 }
 
+Threedim SpinOrientationIsing::trial_spin(int position, RanGen &ranGen)
+{
+	/**
+	* This function returns the flipped spin at a given position without changing the spin configuration.
+	*
+	* @param[in] position A lattice site.
+	* @param[in] ranGen Random number generator (not needed for spin flip).
+	*
+	* @return The flipped spin.
+	*/
+	Threedim spin = _spinArray[position];
+	spin.x = -spin.x;
+	return spin;
+}
+
 Threedim SpinOrientationIsing::magnetisation(void) const
 {
 	/**
@@ -66,6 +66,23 @@ Threedim Tip::effective_field(const int &position) const
 	return MyMath::mult(_tipDirection, _distanceArray[position]);
 }
 
+double Tip::delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const
+{
+	return -MyMath::dot_product(MyMath::difference(newSpin, oldSpin), effective_field(position));
+}
+
+int Tip::linear_in_spin(void) const
+{
+	return TRUE;
+}
+
+int Tip::hessian_blocks(const int &position, ThreedimMatrix &onSite, std::vector<int> &partners,
+	std::vector<ThreedimMatrix> &blocks) const
+{
+	// linear in the spin: second derivatives vanish
+	return TRUE;
+}
+
 void Tip::set_position(Threedim position)
 {
 	_tipPosition = position;
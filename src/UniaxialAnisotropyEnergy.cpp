@@ -54,4 +54,23 @@ Threedim UniaxialAnisotropyEnergy::effective_field(const int &position) const
 	double factor = 2*_energyParameter*MyMath::dot_product(_direction,_spinArray[position]);
 	Threedim field = MyMath::mult(_direction,factor);
 	return field;
-}
\ No newline at end of file
+}
+
+double UniaxialAnisotropyEnergy::delta_energy(const int &position, const Threedim &oldSpin,
+	const Threedim &newSpin) const
+{
+	double cosOld = MyMath::dot_product(oldSpin, _direction);
+	double cosNew = MyMath::dot_product(newSpin, _direction);
+	return _energyParameter * (cosOld * cosOld - cosNew * cosNew);
+}
+
+int UniaxialAnisotropyEnergy::hessian_blocks(const int &position, ThreedimMatrix &onSite, 
+	std::vector<int> &partners, std::vector<ThreedimMatrix> &blocks) const
+{
+	/**
+	* E = K (1 - (S*e)^2) yields d2E/dS dS = -2 K e e^T.
+	*/
+
+	onSite = MyMath::add(onSite, MyMath::outer_product(_direction, _direction, -2 * _energyParameter));
+	return TRUE;
+}
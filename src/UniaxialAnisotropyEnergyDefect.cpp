@@ -69,4 +69,34 @@ Threedim UniaxialAnisotropyEnergyDefect::effective_field(const int &position) co
 		field = MyMath::mult(_anisotropyDefects.at(position).direction, factor);
 	}
 	return field;
-}
\ No newline at end of file
+}
+
+double UniaxialAnisotropyEnergyDefect::delta_energy(const int &position, const Threedim &oldSpin,
+	const Threedim &newSpin) const
+{
+	double energy = 0;
+	if (_anisotropyDefects.count(position) > 0)
+	{
+		const UniaxialAnisotropyStruct &defect = _anisotropyDefects.at(position);
+		double cosOld = MyMath::dot_product(oldSpin, defect.direction);
+		double cosNew = MyMath::dot_product(newSpin, defect.direction);
+		energy = defect.energyParameter * (cosOld * cosOld - cosNew * cosNew);
+	}
+	return energy;
+}
+
+int UniaxialAnisotropyEnergyDefect::hessian_blocks(const int &position, ThreedimMatrix &onSite,
+	std::vector<int> &partners, std::vector<ThreedimMatrix> &blocks) const
+{
+	/**
+	* E = K (1 - (S*e)^2) at defect sites yields d2E/dS dS = -2 K e e^T.
+	*/
+
+	if (_anisotropyDefects.count(position) > 0)
+	{
+		const UniaxialAnisotropyStruct &defect = _anisotropyDefects.at(position);
+		onSite = MyMath::add(onSite, MyMath::outer_product(defect.direction, defect.direction, 
+			-2 * defect.energyParameter));
+	}
+	return TRUE;
+}
@@ -24,9 +24,11 @@
 
 // further includes
 #include "MyMath.h"
+#include "ObservableEngine.h"
 
-WindingNumber::WindingNumber(int numberMeasurements, Threedim* spinArray, TopologicalChargeCell* cells, int cellNum):
-	Observable(numberMeasurements), _spinArray(spinArray), _cells(cells), _cellNum(cellNum)
+WindingNumber::WindingNumber(int numberMeasurements, Threedim* spinArray, TopologicalChargeCell* cells, int cellNum,
+	std::shared_ptr<ObservableEngine> engine):
+	Observable(numberMeasurements), _spinArray(spinArray), _engine(engine), _cells(cells), _cellNum(cellNum)
 {	
 	/**
 	* @param[in] numberMeasurements Number of measurement values before memory is full
@@ -34,8 +36,11 @@ WindingNumber::WindingNumber(int numberMeasurements, Threedim* spinArray, Topolo
 	* @param[in] cells Size is 3*cellNum and 3 successive entries contain spin indexes of one cell for 
 	*                  calculation of topological charge contribution to skyrmion number
 	* @param[in] cellNum Number of cells to calculate topological charge contribution for
+	* @param[in] engine Evaluates the skyrmion number before take_value is called
 	*/
 
+	_engine->request_winding_number(cells, cellNum);
+
 	_localWindingNumber = new double[cellNum];
 	_windingNumber = new double[numberMeasurements];
 	_areaUnitSphere = 4 * Pi;
@@ -55,12 +60,18 @@ std::string WindingNumber::get_steps_header(void) const
 
 std::string WindingNumber::get_mean_header(void) const
 {
+	if (_boolErrorAnalysis == TRUE)
+	{
+		return "WindingNumber WindingNumber_SUS dWindingNumber tau_WindingNumber dWindingNumber_SUS ";
+	}
 	return "WindingNumber WindingNumber_SUS ";
 }
 
 void WindingNumber::take_value(void)
 {
-	winding_number(_windingNumber[_measurementIndex]);
+	double &value = _windingNumber[storage_index(_measurementIndex)];
+	value = _engine->get_winding_number();
+	_statistics.add(value);
 	++_measurementIndex;
 }
 
@@ -69,7 +80,7 @@ std::string WindingNumber::get_step_value(const int &index) const
 	std::stringstream stream;
 	if (index < _numberMeasurements)
 	{
-		stream << _windingNumber[index] << " ";
+		stream << _windingNumber[storage_index(index)] << " ";
 	}
 	else
 	{
@@ -82,10 +93,17 @@ std::string WindingNumber::get_step_value(const int &index) const
 std::string WindingNumber::get_mean_value(const double &temperature) const
 {
 	std::stringstream stream;
-	if (_measurementIndex == _numberMeasurements)
+	if (measurements_complete() == TRUE)
 	{
-		stream << MyMath::mean_value(_windingNumber, _numberMeasurements) << " ";
-		stream << MyMath::variance(_windingNumber, _numberMeasurements) << " ";
+		stream << _statistics.get_mean() << " ";
+		stream << _statistics.get_variance() << " ";
+		if (_boolErrorAnalysis == TRUE)
+		{
+			std::vector<double> variances;
+			_statistics.jackknife_variances(variances, TRUE);
+			stream << _statistics.get_error() << " " << _statistics.get_autocorrelation_time() << " "
+				<< RunningStatistics::jackknife_error(variances) << " ";
+		}
 	}
 	else
 	{
@@ -97,7 +115,8 @@ std::string WindingNumber::get_mean_value(const double &temperature) const
 void WindingNumber::clear_storage(void)
 {
 	delete[] _windingNumber;
-	_windingNumber = new double[_numberMeasurements];
+	_windingNumber = new double[get_storage_size()];
+	_statistics.clear();
 }
 
 void WindingNumber::winding_number(double &value)
@@ -50,6 +50,23 @@ Threedim ZeemanEnergy::effective_field(const int &position) const
 	return MyMath::mult(_direction,_energyParameter);
 }
 
+double ZeemanEnergy::delta_energy(const int &position, const Threedim &oldSpin, const Threedim &newSpin) const
+{
+	return -MyMath::dot_product(MyMath::difference(newSpin, oldSpin), effective_field(position));
+}
+
+int ZeemanEnergy::linear_in_spin(void) const
+{
+	return TRUE;
+}
+
+int ZeemanEnergy::hessian_blocks(const int &position, ThreedimMatrix &onSite, std::vector<int> &partners,
+	std::vector<ThreedimMatrix> &blocks) const
+{
+	// linear in the spin: second derivatives vanish
+	return TRUE;
+}
+
 void ZeemanEnergy::set_direction(Threedim direction) {
 	_direction = MyMath::normalize(direction);
 }
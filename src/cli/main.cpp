@@ -0,0 +1,184 @@
+/*
+* main.cpp
+*
+* Copyright 2017 Julian Hagemeister
+*
+* This file is part of MonteCrystal.
+*
+* MonteCrystal is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* MonteCrystal is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with MonteCrystal.  If not, see <http://www.gnu.org/licenses/>.
+*
+*/
+
+#include "SimulationProgram.h"
+#include "Configuration.h"
+#include "ExcitationModeSolver.h"
+#include "Lattice.h"
+#include "Mersenne.h"
+#include "Setup.h"
+#include "SpinConfigurationFile.h"
+#include "SpinOrientation.h"
+
+#include <QDir>
+#include <QMutex>
+#include <QString>
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+///Contains the entry of the MonteCrystal program without GUI.
+/**
+* Usage: montecrystal-cli <configuration file> [working folder] [-v] [-benchmark-neighbors]
+*                          [-benchmark-eigenmodes]
+*        montecrystal-cli -convert-spins <input file> <output file> [float32|float64]
+*
+* With -benchmark-neighbors only the lattice of the configuration file is created and the cell list
+* neighbor search is compared to the direct neighbor search (run time and results).
+*
+* With -benchmark-eigenmodes only lattice, spin configuration (read from the storage file for program_type
+* read_spin_configuration, random otherwise) and Hamiltonian are created and the assembly of the eigenmode
+* matrix is compared to the previous direct assembly (run time and results).
+*
+* With -convert-spins a spin configuration text file is converted into a binary spin configuration file
+* (float64 by default) or the last frame of a binary spin configuration file is converted into a text file.
+*
+* The simulation runs in the calling thread. Signals of SimulationProgram that are meant for the GUI are
+* either left unconnected or, in case of the simulation progress, written to the console.
+*/
+int main(int argc, char **argv)
+{
+	if (argc >= 4 && std::string(argv[1]).compare("-convert-spins") == 0)
+	{
+		if (SpinConfigurationFile::is_spin_configuration_file(argv[2]) == TRUE)
+		{
+			return (SpinConfigurationFile::binary_to_text(argv[2], argv[3]) == TRUE) ? 0 : 1;
+		}
+		int precision = (argc >= 5 && std::string(argv[4]).compare("float32") == 0) ? 4 : 8;
+		return (SpinConfigurationFile::text_to_binary(argv[2], argv[3], precision) == TRUE) ? 0 : 1;
+	}
+
+	std::string configurationFname;
+	QString workfolderName = QDir::currentPath();
+	int boolVerbose = FALSE;
+	int boolBenchmarkNeighbors = FALSE;
+	int boolBenchmarkEigenmodes = FALSE;
+
+	int positionalArguments = 0;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string argument = argv[i];
+		if (argument.compare("-v") == 0)
+		{
+			boolVerbose = TRUE;
+		}
+		else if (argument.compare("-benchmark-neighbors") == 0)
+		{
+			boolBenchmarkNeighbors = TRUE;
+		}
+		else if (argument.compare("-benchmark-eigenmodes") == 0)
+		{
+			boolBenchmarkEigenmodes = TRUE;
+		}
+		else if (positionalArguments == 0)
+		{
+			configurationFname = argument;
+			++positionalArguments;
+		}
+		else if (positionalArguments == 1)
+		{
+			workfolderName = QString::fromStdString(argument);
+			++positionalArguments;
+		}
+	}
+
+	if (configurationFname.empty())
+	{
+		std::cout << "Usage: " << argv[0] << " <configuration file> [working folder] [-v] [-benchmark-neighbors]"
+			<< " [-benchmark-eigenmodes]" << std::endl;
+		std::cout << "       " << argv[0] << " -convert-spins <input file> <output file> [float32|float64]"
+			<< std::endl;
+		return 1;
+	}
+
+	const auto config = std::make_shared<Configuration>();
+	if (config->read_configuration_file(configurationFname) == FALSE)
+	{
+		return 1;
+	}
+	config->determine_outputfolder_needed();
+
+	if (boolBenchmarkNeighbors == TRUE || boolBenchmarkEigenmodes == TRUE)
+	{
+		Setup setup(config);
+		if (config->_programType == latticeMaskRead)
+		{
+			setup.create_crystal_lattice_from_mask();
+		}
+		else
+		{
+			setup.create_crystal_lattice();
+		}
+		if (boolBenchmarkNeighbors == TRUE)
+		{
+			return (setup._lattice->compare_neighbor_search() == TRUE) ? 0 : 1;
+		}
+
+		setup.create_spin_orientation(std::make_shared<Mersenne>(config->_seed));
+		if (config->_programType == readSpinConfiguration)
+		{
+			setup._spinOrientation->read_spin_configuration(config->_storageFname);
+		}
+		setup.setup_hamiltonian();
+		setup.set_magnetic_field(config->_magneticField.start);
+		ExcitationModeSolver excitationModeSolver(setup._spinOrientation.data(), setup._hamilton);
+		return (excitationModeSolver.compare_matrix_assembly() == TRUE) ? 0 : 1;
+	}
+
+	// working folder with README and "Data" folder containing the simulation folders
+	QDir workfolder{ workfolderName };
+	if (!workfolder.exists() && !workfolder.mkpath("."))
+	{
+		std::cout << "Working folder " << workfolderName.toStdString() << " could not be created." << std::endl;
+		return 1;
+	}
+	workfolder.mkdir("Data");
+
+	QMutex mutex;
+	int terminateThread = 0;
+
+	SimulationProgram simulationProgram(workfolder, config, &mutex, &terminateThread,
+		QSharedPointer<Lattice>(), QSharedPointer<SpinOrientation>());
+
+	// simulation progress is written to the console instead of the GUI
+	QObject::connect(&simulationProgram, &SimulationProgram::send_simulation_info, [](QString qString)
+	{
+		std::cout << qString.toStdString() << std::endl;
+	});
+	if (boolVerbose == TRUE)
+	{
+		QObject::connect(&simulationProgram, &SimulationProgram::send_simulation_step, [](QString qString)
+		{
+			std::cout << "step " << qString.toStdString() << std::endl;
+		});
+		QObject::connect(&simulationProgram, &SimulationProgram::send_simulation_convergence_criterion,
+			[](QString qString)
+		{
+			std::cout << "convergence criterion " << qString.toStdString() << std::endl;
+		});
+	}
+
+	simulationProgram.main();
+
+	return 0;
+}